@@ -0,0 +1,183 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <cstdlib>
+#include <limits>
+#include <new>
+#if defined(_MSC_VER) || defined(__GLIBC__)
+#include <malloc.h>
+#endif
+#ifdef __linux__
+#include <sys/mman.h>
+#endif
+
+
+namespace ds
+{
+
+///////////////////
+
+// Allocator that allocates memory with a given alignment directly from the C runtime.
+// Fulfills the standard allocator requirements, so it can be used with standard
+// containers and std::allocator_traits.
+// The alignment defaults to the alignment of the element type but can be increased,
+// e.g. to place elements on separate cache lines.
+template <typename T, std::size_t Align = alignof(T)> class AlignedAllocator
+{
+   static_assert(Align >= alignof(T), "Alignment must satisfy the element type.");
+   static_assert((Align & (Align - 1)) == 0, "Alignment must be a power of two.");
+
+ public:
+   using value_type = T;
+   using size_type = std::size_t;
+   using difference_type = std::ptrdiff_t;
+   using propagate_on_container_move_assignment = std::true_type;
+   using is_always_equal = std::true_type;
+
+   template <typename U> struct rebind
+   {
+      using other = AlignedAllocator<U, std::max(Align, alignof(U))>;
+   };
+
+   static constexpr std::size_t Alignment = Align;
+
+   // Result of allocate_at_least. Mirrors std::allocation_result from C++23.
+   struct AllocationResult
+   {
+      T* ptr = nullptr;
+      std::size_t count = 0;
+   };
+
+ public:
+   AlignedAllocator() noexcept = default;
+   template <typename U, std::size_t UAlign>
+   AlignedAllocator(const AlignedAllocator<U, UAlign>&) noexcept
+   {
+   }
+
+   [[nodiscard]] T* allocate(std::size_t n);
+   // Allocates memory for at least n elements and returns how many elements fit into
+   // the allocated block. Blocks are usually larger than requested because of the
+   // size classes that allocators use for their bookkeeping.
+   [[nodiscard]] AllocationResult allocate_at_least(std::size_t n);
+   void deallocate(T* mem, std::size_t n) noexcept;
+
+   template <typename U, std::size_t UAlign>
+   friend bool operator==(const AlignedAllocator&, const AlignedAllocator<U, UAlign>&)
+   {
+      return true;
+   }
+
+   template <typename U, std::size_t UAlign>
+   friend bool operator!=(const AlignedAllocator&, const AlignedAllocator<U, UAlign>&)
+   {
+      return false;
+   }
+};
+
+
+template <typename T, std::size_t Align>
+T* AlignedAllocator<T, Align>::allocate(std::size_t n)
+{
+   if (n > std::numeric_limits<std::size_t>::max() / sizeof(T))
+      throw std::bad_alloc();
+
+   // std::aligned_alloc requires the size to be a non-zero multiple of the alignment.
+   const std::size_t numBytes =
+      std::max((n * sizeof(T) + Align - 1) & ~(Align - 1), Align);
+
+#ifdef _MSC_VER
+   // Visual Studio does not support std::aligned_alloc.
+   T* mem = reinterpret_cast<T*>(_aligned_malloc(numBytes, Align));
+#else
+   T* mem = reinterpret_cast<T*>(std::aligned_alloc(Align, numBytes));
+#endif
+   if (!mem)
+      throw std::bad_alloc();
+   return mem;
+}
+
+
+template <typename T, std::size_t Align>
+typename AlignedAllocator<T, Align>::AllocationResult
+AlignedAllocator<T, Align>::allocate_at_least(std::size_t n)
+{
+   T* mem = allocate(n);
+
+#if defined(_MSC_VER)
+   const std::size_t usableBytes = _aligned_msize(mem, Align, 0);
+#elif defined(__GLIBC__)
+   const std::size_t usableBytes = malloc_usable_size(mem);
+#else
+   // No way to query the size of the block. Use what was requested.
+   const std::size_t usableBytes = n * sizeof(T);
+#endif
+
+   return {mem, std::max(usableBytes / sizeof(T), n)};
+}
+
+
+template <typename T, std::size_t Align>
+void AlignedAllocator<T, Align>::deallocate(T* mem, std::size_t /*n*/) noexcept
+{
+#ifdef _MSC_VER
+   _aligned_free(mem);
+#else
+   std::free(mem);
+#endif
+}
+
+
+///////////////////
+
+// Size of huge pages on x86-64 and typical ARM64 systems.
+inline constexpr std::size_t HugePageSize = 2 * 1024 * 1024;
+
+// Allocator for large buffers that should be backed by huge pages to reduce TLB misses.
+// Blocks are aligned to and padded to the huge page size. On Linux the kernel is advised
+// to back the blocks with transparent huge pages. On other platforms the blocks are only
+// aligned, because huge pages require special privileges there.
+template <typename T> class HugePageAllocator : public AlignedAllocator<T, HugePageSize>
+{
+   using Base = AlignedAllocator<T, HugePageSize>;
+
+ public:
+   using typename Base::AllocationResult;
+
+   template <typename U> struct rebind
+   {
+      using other = HugePageAllocator<U>;
+   };
+
+ public:
+   HugePageAllocator() noexcept = default;
+   template <typename U> HugePageAllocator(const HugePageAllocator<U>&) noexcept {}
+
+   [[nodiscard]] T* allocate(std::size_t n);
+   [[nodiscard]] AllocationResult allocate_at_least(std::size_t n);
+};
+
+
+template <typename T> T* HugePageAllocator<T>::allocate(std::size_t n)
+{
+   T* mem = Base::allocate(n);
+#ifdef __linux__
+   // Only a hint. Failing to get huge pages is not an error.
+   const std::size_t numBytes = (n * sizeof(T) + HugePageSize - 1) & ~(HugePageSize - 1);
+   madvise(mem, numBytes, MADV_HUGEPAGE);
+#endif
+   return mem;
+}
+
+
+template <typename T>
+typename HugePageAllocator<T>::AllocationResult
+HugePageAllocator<T>::allocate_at_least(std::size_t n)
+{
+   // The padding of the block can be used.
+   const std::size_t numBytes =
+      std::max((n * sizeof(T) + HugePageSize - 1) & ~(HugePageSize - 1), HugePageSize);
+   return {allocate(n), std::max(numBytes / sizeof(T), n)};
+}
+
+} // namespace ds
@@ -0,0 +1,784 @@
+#pragma once
+#include "SboVector.h"
+#include <algorithm>
+#include <cassert>
+#include <initializer_list>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+
+
+namespace ds
+{
+
+///////////////////
+
+// Variant of SboVector that minimizes its footprint.
+// SboVector stores its internal buffer, a data pointer, the size and the capacity
+// side by side. CompactSboVector stores the heap pointer and heap capacity inside the
+// memory of the internal buffer, which is unused while the data lives on the heap. A
+// tag bit in the size field tells the two modes apart. This saves two words per
+// object when the buffer is at least two words large. Mostly useful for large numbers
+// of small vectors, e.g. as values of hash maps.
+// The price is a branch on the mode for each access to the data.
+//
+// Elements are moved with the same strategies as for SboVector, including raw memory
+// moves for trivially relocatable types. Iterators are the same as for SboVector.
+template <typename T, std::size_t N, typename Alloc = AlignedAllocator<T>,
+          typename Growth = DoublingGrowth>
+class CompactSboVector
+{
+   // Requirements for T (std::vector has the same requirements for its T).
+   static_assert(std::is_copy_constructible_v<T>,
+                 "Element type must be copy-constructible.");
+   static_assert(std::is_copy_assignable_v<T>, "Element type must be copy-assignable.");
+   static_assert(!std::is_array_v<T> && !std::is_function_v<T> &&
+                    !std::is_reference_v<T> && !std::is_same_v<T, void>,
+                 "Element type must be erasable, i.e. calls to p->~T() must be valid.");
+   // Requirements for N.
+   static_assert(N > 0, "Zero-sized buffer is not supported. Use std::vector.");
+   // Requirements for allocator.
+   static_assert(std::is_same_v<typename std::allocator_traits<Alloc>::value_type, T>,
+                 "Allocator must allocate elements of the vector's element type.");
+
+   using AllocTraits = std::allocator_traits<Alloc>;
+
+ public:
+   using value_type = T;
+   using allocator_type = Alloc;
+   using reference = T&;
+   using const_reference = const T&;
+   using pointer = T*;
+   using const_pointer = const T*;
+   using size_type = std::size_t;
+   using difference_type = std::ptrdiff_t;
+   using iterator = SboVectorIterator<T, N>;
+   using const_iterator = SboVectorConstIterator<T, N>;
+   using reverse_iterator = std::reverse_iterator<iterator>;
+   using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+   static constexpr std::size_t BufferCapacity = N;
+
+ public:
+   CompactSboVector() noexcept(noexcept(Alloc()));
+   explicit CompactSboVector(const Alloc& alloc) noexcept;
+   explicit CompactSboVector(std::size_t count, const T& value,
+                             const Alloc& alloc = Alloc());
+   template <typename FwdIter, typename = std::enable_if_t<IsIterator_v<FwdIter>, void>>
+   CompactSboVector(FwdIter first, FwdIter last, const Alloc& alloc = Alloc());
+   CompactSboVector(std::initializer_list<T> ilist, const Alloc& alloc = Alloc());
+   CompactSboVector(const CompactSboVector& other);
+   CompactSboVector(CompactSboVector&& other);
+   ~CompactSboVector();
+
+   CompactSboVector& operator=(const CompactSboVector& other);
+   CompactSboVector& operator=(CompactSboVector&& other);
+   CompactSboVector& operator=(std::initializer_list<T> ilist);
+
+   void assign(size_type count, const T& value);
+   template <typename FwdIter> void assign(FwdIter first, FwdIter last);
+   void assign(std::initializer_list<T> ilist);
+   allocator_type get_allocator() const noexcept { return m_alloc; }
+
+   T& at(std::size_t pos);
+   const T& at(std::size_t pos) const;
+   T& operator[](std::size_t pos) { return data()[pos]; }
+   const T& operator[](std::size_t pos) const { return data()[pos]; }
+   T& front() { return data()[0]; }
+   const T& front() const { return data()[0]; }
+   T& back() { return data()[size() - 1]; }
+   const T& back() const { return data()[size() - 1]; }
+   T* data() noexcept { return onHeap() ? m_heap.data : buffer(); }
+   const T* data() const noexcept { return onHeap() ? m_heap.data : buffer(); }
+
+   iterator begin() noexcept { return iterator(data()); }
+   iterator end() noexcept { return iterator(data() + size()); }
+   const_iterator begin() const noexcept { return cbegin(); }
+   const_iterator end() const noexcept { return cend(); }
+   const_iterator cbegin() const noexcept { return const_iterator(mutableData()); }
+   const_iterator cend() const noexcept { return const_iterator(mutableData() + size()); }
+   reverse_iterator rbegin() noexcept { return reverse_iterator(end()); }
+   reverse_iterator rend() noexcept { return reverse_iterator(begin()); }
+   const_reverse_iterator rbegin() const noexcept { return crbegin(); }
+   const_reverse_iterator rend() const noexcept { return crend(); }
+   const_reverse_iterator crbegin() const noexcept { return const_reverse_iterator(cend()); }
+   const_reverse_iterator crend() const noexcept { return const_reverse_iterator(cbegin()); }
+
+   bool empty() const noexcept { return size() == 0; }
+   std::size_t size() const noexcept { return m_sizeAndMode >> 1; }
+   constexpr std::size_t max_size() const noexcept;
+   std::size_t capacity() const noexcept { return onHeap() ? m_heap.capacity : N; }
+   void reserve(std::size_t cap);
+   void shrink_to_fit();
+
+   void clear() noexcept;
+   iterator erase(const_iterator pos);
+   iterator erase(const_iterator first, const_iterator last);
+   iterator insert(const_iterator pos, const T& value);
+   iterator insert(const_iterator pos, T&& value);
+   iterator insert(const_iterator pos, size_type count, const T& value);
+   template <typename FwdIter>
+   iterator insert(const_iterator pos, FwdIter first, FwdIter last);
+   iterator insert(const_iterator pos, std::initializer_list<T> ilist);
+   void push_back(const T& value) { emplace_back(value); }
+   void push_back(T&& value) { emplace_back(std::move(value)); }
+   void pop_back();
+   template <typename... Args> iterator emplace(const_iterator pos, Args&&... args);
+   template <typename... Args> reference emplace_back(Args&&... args);
+   void resize(size_type count);
+   void resize(size_type count, const value_type& value);
+   void swap(CompactSboVector& other);
+
+   bool inBuffer() const noexcept { return !onHeap(); }
+   bool onHeap() const noexcept { return (m_sizeAndMode & HeapFlag) != 0; }
+
+ private:
+   // Heap data stored in the memory of the internal buffer while the elements live
+   // on the heap.
+   struct HeapData
+   {
+      T* data;
+      std::size_t capacity;
+   };
+
+   // The lowest bit of the size field marks whether the data is on the heap.
+   static constexpr std::size_t HeapFlag = 1;
+
+   T* buffer() noexcept { return reinterpret_cast<T*>(m_buffer); }
+   const T* buffer() const noexcept { return reinterpret_cast<const T*>(m_buffer); }
+   // Iterators only store non-const element pointers.
+   T* mutableData() const noexcept { return const_cast<T*>(data()); }
+
+   void setSize(std::size_t size) noexcept;
+   void setHeap(T* mem, std::size_t cap) noexcept;
+   void setBuffer() noexcept;
+
+   // Opens a gap of n uninitialized elements at the given position and returns it.
+   // Reallocates if the capacity is too small.
+   T* makeGap(std::size_t pos, std::size_t n);
+   // Moves the elements into a new heap allocation with the given capacity.
+   void reallocate(std::size_t newCap);
+   // Moves the elements from the heap into the internal buffer.
+   void moveIntoBuffer();
+   void moveFrom(CompactSboVector&& other);
+   void clean() noexcept;
+
+   T* allocateMem(std::size_t& cap);
+   void deallocateMem(T* mem, std::size_t cap) noexcept;
+
+ private:
+   union
+   {
+      // Internal buffer.
+      std::aligned_storage_t<sizeof(T), alignof(T)> m_buffer[N];
+      // Heap allocation.
+      HeapData m_heap;
+   };
+   // Number of occupied elements (shifted by one bit) and heap flag.
+   std::size_t m_sizeAndMode = 0;
+   // Allocator for heap memory.
+   SBOVEC_NO_UNIQUE_ADDRESS Alloc m_alloc{};
+};
+
+
+///////////////////
+
+namespace internals
+{
+
+// Relocates elements and ends the lifetime of the source elements.
+// Does not make accomodations for overlapping ranges.
+template <typename T> void relocateAndDestroy_n(T* first, std::size_t n, T* dest)
+{
+   relocate_n(first, n, dest);
+   if constexpr (!CanRelocateBitwise_v<T*> && std::is_move_constructible_v<T>)
+      std::destroy_n(first, n);
+}
+
+} // namespace internals
+
+
+///////////////////
+
+template <typename T, std::size_t N, typename Alloc, typename Growth>
+CompactSboVector<T, N, Alloc, Growth>::CompactSboVector() noexcept(noexcept(Alloc()))
+{
+}
+
+
+template <typename T, std::size_t N, typename Alloc, typename Growth>
+CompactSboVector<T, N, Alloc, Growth>::CompactSboVector(const Alloc& alloc) noexcept
+: m_alloc{alloc}
+{
+}
+
+
+template <typename T, std::size_t N, typename Alloc, typename Growth>
+CompactSboVector<T, N, Alloc, Growth>::CompactSboVector(std::size_t count,
+                                                        const T& value,
+                                                        const Alloc& alloc)
+: m_alloc{alloc}
+{
+   assign(count, value);
+}
+
+
+template <typename T, std::size_t N, typename Alloc, typename Growth>
+template <typename FwdIter, typename>
+CompactSboVector<T, N, Alloc, Growth>::CompactSboVector(FwdIter first, FwdIter last,
+                                                        const Alloc& alloc)
+: m_alloc{alloc}
+{
+   assign(first, last);
+}
+
+
+template <typename T, std::size_t N, typename Alloc, typename Growth>
+CompactSboVector<T, N, Alloc, Growth>::CompactSboVector(std::initializer_list<T> ilist,
+                                                        const Alloc& alloc)
+: m_alloc{alloc}
+{
+   assign(ilist.begin(), ilist.end());
+}
+
+
+template <typename T, std::size_t N, typename Alloc, typename Growth>
+CompactSboVector<T, N, Alloc, Growth>::CompactSboVector(const CompactSboVector& other)
+: m_alloc{AllocTraits::select_on_container_copy_construction(other.m_alloc)}
+{
+   assign(other.begin(), other.end());
+}
+
+
+template <typename T, std::size_t N, typename Alloc, typename Growth>
+CompactSboVector<T, N, Alloc, Growth>::CompactSboVector(CompactSboVector&& other)
+: m_alloc{other.m_alloc}
+{
+   moveFrom(std::move(other));
+}
+
+
+template <typename T, std::size_t N, typename Alloc, typename Growth>
+CompactSboVector<T, N, Alloc, Growth>::~CompactSboVector()
+{
+   clean();
+}
+
+
+template <typename T, std::size_t N, typename Alloc, typename Growth>
+CompactSboVector<T, N, Alloc, Growth>&
+CompactSboVector<T, N, Alloc, Growth>::operator=(const CompactSboVector& other)
+{
+   if (this == &other)
+      return *this;
+
+   if constexpr (AllocTraits::propagate_on_container_copy_assignment::value)
+   {
+      if (m_alloc != other.m_alloc)
+         clean();
+      m_alloc = other.m_alloc;
+   }
+
+   assign(other.begin(), other.end());
+   return *this;
+}
+
+
+template <typename T, std::size_t N, typename Alloc, typename Growth>
+CompactSboVector<T, N, Alloc, Growth>&
+CompactSboVector<T, N, Alloc, Growth>::operator=(CompactSboVector&& other)
+{
+   if (this == &other)
+      return *this;
+
+   clean();
+   if constexpr (AllocTraits::propagate_on_container_move_assignment::value)
+      m_alloc = other.m_alloc;
+   moveFrom(std::move(other));
+   return *this;
+}
+
+
+template <typename T, std::size_t N, typename Alloc, typename Growth>
+CompactSboVector<T, N, Alloc, Growth>&
+CompactSboVector<T, N, Alloc, Growth>::operator=(std::initializer_list<T> ilist)
+{
+   assign(ilist.begin(), ilist.end());
+   return *this;
+}
+
+
+template <typename T, std::size_t N, typename Alloc, typename Growth>
+void CompactSboVector<T, N, Alloc, Growth>::assign(size_type count, const T& value)
+{
+   clear();
+   reserve(count);
+   std::uninitialized_fill_n(data(), count, value);
+   setSize(count);
+}
+
+
+template <typename T, std::size_t N, typename Alloc, typename Growth>
+template <typename FwdIter>
+void CompactSboVector<T, N, Alloc, Growth>::assign(FwdIter first, FwdIter last)
+{
+   const std::size_t count = std::distance(first, last);
+   clear();
+   reserve(count);
+   internals::uninitialized_copy_n(first, count, data());
+   setSize(count);
+}
+
+
+template <typename T, std::size_t N, typename Alloc, typename Growth>
+void CompactSboVector<T, N, Alloc, Growth>::assign(std::initializer_list<T> ilist)
+{
+   assign(ilist.begin(), ilist.end());
+}
+
+
+template <typename T, std::size_t N, typename Alloc, typename Growth>
+T& CompactSboVector<T, N, Alloc, Growth>::at(std::size_t pos)
+{
+   if (pos >= size())
+      throw std::out_of_range("CompactSboVector - Accessing invalid element.");
+   return data()[pos];
+}
+
+
+template <typename T, std::size_t N, typename Alloc, typename Growth>
+const T& CompactSboVector<T, N, Alloc, Growth>::at(std::size_t pos) const
+{
+   if (pos >= size())
+      throw std::out_of_range("CompactSboVector - Accessing invalid element.");
+   return data()[pos];
+}
+
+
+template <typename T, std::size_t N, typename Alloc, typename Growth>
+constexpr std::size_t CompactSboVector<T, N, Alloc, Growth>::max_size() const noexcept
+{
+   // One bit of the size field is used for the heap flag.
+   return std::numeric_limits<difference_type>::max() >> 1;
+}
+
+
+template <typename T, std::size_t N, typename Alloc, typename Growth>
+void CompactSboVector<T, N, Alloc, Growth>::reserve(std::size_t cap)
+{
+   if (cap > max_size())
+      throw std::length_error("CompactSboVector - Exceeding max size.");
+   if (cap > capacity())
+      reallocate(cap);
+}
+
+
+template <typename T, std::size_t N, typename Alloc, typename Growth>
+void CompactSboVector<T, N, Alloc, Growth>::shrink_to_fit()
+{
+   if (inBuffer())
+      return;
+
+   if (size() <= N)
+      moveIntoBuffer();
+   else if (size() < capacity())
+      reallocate(size());
+}
+
+
+template <typename T, std::size_t N, typename Alloc, typename Growth>
+void CompactSboVector<T, N, Alloc, Growth>::clear() noexcept
+{
+   std::destroy_n(data(), size());
+   setSize(0);
+}
+
+
+template <typename T, std::size_t N, typename Alloc, typename Growth>
+typename CompactSboVector<T, N, Alloc, Growth>::iterator
+CompactSboVector<T, N, Alloc, Growth>::erase(const_iterator pos)
+{
+   return erase(pos, pos + 1);
+}
+
+
+template <typename T, std::size_t N, typename Alloc, typename Growth>
+typename CompactSboVector<T, N, Alloc, Growth>::iterator
+CompactSboVector<T, N, Alloc, Growth>::erase(const_iterator first, const_iterator last)
+{
+   if (first >= cend())
+      return end();
+   if (last > cend())
+      last = cend();
+
+   const std::size_t offset = first - cbegin();
+   const std::size_t count = last - first;
+   if (count > 0)
+   {
+      T* elems = data();
+      T* tailEnd = elems + size();
+      if constexpr (internals::CanRelocateBitwise_v<T*>)
+      {
+         std::destroy_n(elems + offset, count);
+         internals::relocateLeftOverlapped(elems + offset + count, tailEnd,
+                                           elems + offset);
+      }
+      else
+      {
+         std::move(elems + offset + count, tailEnd, elems + offset);
+         std::destroy(tailEnd - count, tailEnd);
+      }
+      setSize(size() - count);
+   }
+
+   return begin() + offset;
+}
+
+
+template <typename T, std::size_t N, typename Alloc, typename Growth>
+typename CompactSboVector<T, N, Alloc, Growth>::iterator
+CompactSboVector<T, N, Alloc, Growth>::insert(const_iterator pos, const T& value)
+{
+   return emplace(pos, value);
+}
+
+
+template <typename T, std::size_t N, typename Alloc, typename Growth>
+typename CompactSboVector<T, N, Alloc, Growth>::iterator
+CompactSboVector<T, N, Alloc, Growth>::insert(const_iterator pos, T&& value)
+{
+   return emplace(pos, std::move(value));
+}
+
+
+template <typename T, std::size_t N, typename Alloc, typename Growth>
+typename CompactSboVector<T, N, Alloc, Growth>::iterator
+CompactSboVector<T, N, Alloc, Growth>::insert(const_iterator pos, size_type count,
+                                              const T& value)
+{
+   const std::size_t offset = pos - cbegin();
+   if (count > 0)
+   {
+      // The value might be an element of this vector. Copy it before the elements
+      // get relocated.
+      const T copy = value;
+      std::uninitialized_fill_n(makeGap(offset, count), count, copy);
+   }
+   return begin() + offset;
+}
+
+
+template <typename T, std::size_t N, typename Alloc, typename Growth>
+template <typename FwdIter>
+typename CompactSboVector<T, N, Alloc, Growth>::iterator
+CompactSboVector<T, N, Alloc, Growth>::insert(const_iterator pos, FwdIter first,
+                                              FwdIter last)
+{
+   const std::size_t offset = pos - cbegin();
+   const std::size_t count = std::distance(first, last);
+   if (count > 0)
+      internals::uninitialized_copy_n(first, count, makeGap(offset, count));
+   return begin() + offset;
+}
+
+
+template <typename T, std::size_t N, typename Alloc, typename Growth>
+typename CompactSboVector<T, N, Alloc, Growth>::iterator
+CompactSboVector<T, N, Alloc, Growth>::insert(const_iterator pos,
+                                              std::initializer_list<T> ilist)
+{
+   return insert(pos, ilist.begin(), ilist.end());
+}
+
+
+template <typename T, std::size_t N, typename Alloc, typename Growth>
+void CompactSboVector<T, N, Alloc, Growth>::pop_back()
+{
+   // Calling pop_back on an empty vector is UB according to the standard.
+   std::destroy_at(data() + size() - 1);
+   setSize(size() - 1);
+}
+
+
+template <typename T, std::size_t N, typename Alloc, typename Growth>
+template <typename... Args>
+typename CompactSboVector<T, N, Alloc, Growth>::iterator
+CompactSboVector<T, N, Alloc, Growth>::emplace(const_iterator pos, Args&&... args)
+{
+   const std::size_t offset = pos - cbegin();
+   // Construct the element up front because the arguments might reference elements
+   // of this vector.
+   T elem(std::forward<Args>(args)...);
+   internals::construct_at(makeGap(offset, 1), std::move(elem));
+   return begin() + offset;
+}
+
+
+template <typename T, std::size_t N, typename Alloc, typename Growth>
+template <typename... Args>
+typename CompactSboVector<T, N, Alloc, Growth>::reference
+CompactSboVector<T, N, Alloc, Growth>::emplace_back(Args&&... args)
+{
+   const std::size_t offset = size();
+   if (offset < capacity())
+   {
+      internals::construct_at(data() + offset, std::forward<Args>(args)...);
+      setSize(offset + 1);
+   }
+   else
+   {
+      emplace(cend(), std::forward<Args>(args)...);
+   }
+   return data()[offset];
+}
+
+
+template <typename T, std::size_t N, typename Alloc, typename Growth>
+void CompactSboVector<T, N, Alloc, Growth>::resize(size_type count)
+{
+   if (count > size())
+   {
+      const std::size_t numAdded = count - size();
+      std::uninitialized_value_construct_n(makeGap(size(), numAdded), numAdded);
+   }
+   else
+   {
+      std::destroy_n(data() + count, size() - count);
+      setSize(count);
+   }
+}
+
+
+template <typename T, std::size_t N, typename Alloc, typename Growth>
+void CompactSboVector<T, N, Alloc, Growth>::resize(size_type count,
+                                                   const value_type& value)
+{
+   if (count > size())
+      insert(cend(), count - size(), value);
+   else
+      resize(count);
+}
+
+
+template <typename T, std::size_t N, typename Alloc, typename Growth>
+void CompactSboVector<T, N, Alloc, Growth>::swap(CompactSboVector& other)
+{
+   if (this == &other)
+      return;
+
+   if constexpr (AllocTraits::propagate_on_container_swap::value)
+   {
+      using std::swap; // Enable ADL.
+      swap(m_alloc, other.m_alloc);
+   }
+   else
+   {
+      assert(m_alloc == other.m_alloc);
+   }
+
+   if (onHeap() && other.onHeap())
+   {
+      std::swap(m_heap, other.m_heap);
+      std::swap(m_sizeAndMode, other.m_sizeAndMode);
+   }
+   else
+   {
+      CompactSboVector tmp{std::move(other)};
+      other = std::move(*this);
+      *this = std::move(tmp);
+   }
+}
+
+
+template <typename T, std::size_t N, typename Alloc, typename Growth>
+void CompactSboVector<T, N, Alloc, Growth>::setSize(std::size_t size) noexcept
+{
+   m_sizeAndMode = (size << 1) | (m_sizeAndMode & HeapFlag);
+}
+
+
+template <typename T, std::size_t N, typename Alloc, typename Growth>
+void CompactSboVector<T, N, Alloc, Growth>::setHeap(T* mem, std::size_t cap) noexcept
+{
+   m_heap.data = mem;
+   m_heap.capacity = cap;
+   m_sizeAndMode |= HeapFlag;
+}
+
+
+template <typename T, std::size_t N, typename Alloc, typename Growth>
+void CompactSboVector<T, N, Alloc, Growth>::setBuffer() noexcept
+{
+   m_sizeAndMode &= ~HeapFlag;
+}
+
+
+template <typename T, std::size_t N, typename Alloc, typename Growth>
+T* CompactSboVector<T, N, Alloc, Growth>::makeGap(std::size_t pos, std::size_t n)
+{
+   const std::size_t oldSize = size();
+   const std::size_t newSize = oldSize + n;
+   assert(pos <= oldSize);
+
+   if (newSize <= capacity())
+   {
+      T* elems = data();
+      const std::size_t numTail = oldSize - pos;
+      if constexpr (internals::CanRelocateBitwise_v<T*>)
+      {
+         internals::relocateRightOverlapped(elems + pos, elems + oldSize, elems + pos + n);
+      }
+      else if (numTail > n)
+      {
+         // Move the last n elements into uninitialized memory, shift the rest over
+         // existing elements and clear the gap.
+         std::uninitialized_move(elems + oldSize - n, elems + oldSize, elems + oldSize);
+         std::move_backward(elems + pos, elems + oldSize - n, elems + oldSize);
+         std::destroy_n(elems + pos, n);
+      }
+      else
+      {
+         std::uninitialized_move(elems + pos, elems + oldSize, elems + pos + n);
+         std::destroy_n(elems + pos, numTail);
+      }
+      setSize(newSize);
+      return elems + pos;
+   }
+
+   // Reallocate and place the front and tail around the gap.
+   if (newSize > max_size())
+      throw std::length_error("CompactSboVector - Exceeding max size.");
+   std::size_t newCap = Growth::grow(capacity(), newSize, max_size());
+   T* newData = allocateMem(newCap);
+   T* oldData = data();
+   internals::relocateAndDestroy_n(oldData, pos, newData);
+   internals::relocateAndDestroy_n(oldData + pos, oldSize - pos, newData + pos + n);
+
+   if (onHeap())
+      deallocateMem(m_heap.data, m_heap.capacity);
+   setHeap(newData, newCap);
+   setSize(newSize);
+   return newData + pos;
+}
+
+
+template <typename T, std::size_t N, typename Alloc, typename Growth>
+void CompactSboVector<T, N, Alloc, Growth>::reallocate(std::size_t newCap)
+{
+   assert(newCap >= size() && newCap > N);
+
+   T* newData = allocateMem(newCap);
+   internals::relocateAndDestroy_n(data(), size(), newData);
+   if (onHeap())
+      deallocateMem(m_heap.data, m_heap.capacity);
+   setHeap(newData, newCap);
+}
+
+
+template <typename T, std::size_t N, typename Alloc, typename Growth>
+void CompactSboVector<T, N, Alloc, Growth>::moveIntoBuffer()
+{
+   assert(onHeap() && size() <= N);
+
+   // The heap data gets overwritten by the elements.
+   const HeapData heap = m_heap;
+   internals::relocateAndDestroy_n(heap.data, size(), buffer());
+   deallocateMem(heap.data, heap.capacity);
+   setBuffer();
+}
+
+
+template <typename T, std::size_t N, typename Alloc, typename Growth>
+void CompactSboVector<T, N, Alloc, Growth>::moveFrom(CompactSboVector&& other)
+{
+   // Expects this vector to be empty and in buffer mode.
+   assert(empty() && inBuffer());
+
+   if (other.onHeap() && m_alloc == other.m_alloc)
+   {
+      // Steal the heap allocation.
+      m_heap = other.m_heap;
+      m_sizeAndMode = other.m_sizeAndMode;
+      other.m_sizeAndMode = 0;
+      return;
+   }
+
+   const std::size_t srcSize = other.size();
+   reserve(srcSize);
+   internals::relocateAndDestroy_n(other.data(), srcSize, data());
+   setSize(srcSize);
+   other.setSize(0);
+}
+
+
+template <typename T, std::size_t N, typename Alloc, typename Growth>
+void CompactSboVector<T, N, Alloc, Growth>::clean() noexcept
+{
+   clear();
+   if (onHeap())
+   {
+      deallocateMem(m_heap.data, m_heap.capacity);
+      setBuffer();
+   }
+}
+
+
+template <typename T, std::size_t N, typename Alloc, typename Growth>
+T* CompactSboVector<T, N, Alloc, Growth>::allocateMem(std::size_t& cap)
+{
+   if constexpr (Growth::UseAllocationSize && internals::HasAllocateAtLeast_v<Alloc>)
+   {
+      const auto res = m_alloc.allocate_at_least(cap);
+      cap = res.count;
+      return res.ptr;
+   }
+   else
+   {
+      return AllocTraits::allocate(m_alloc, cap);
+   }
+}
+
+
+template <typename T, std::size_t N, typename Alloc, typename Growth>
+void CompactSboVector<T, N, Alloc, Growth>::deallocateMem(T* mem,
+                                                          std::size_t cap) noexcept
+{
+   AllocTraits::deallocate(m_alloc, mem, cap);
+}
+
+
+///////////////////
+
+template <typename T, std::size_t N, typename Alloc, typename Growth>
+bool operator==(const CompactSboVector<T, N, Alloc, Growth>& a,
+                const CompactSboVector<T, N, Alloc, Growth>& b)
+{
+   return a.size() == b.size() && std::equal(a.begin(), a.end(), b.begin());
+}
+
+
+template <typename T, std::size_t N, typename Alloc, typename Growth>
+bool operator!=(const CompactSboVector<T, N, Alloc, Growth>& a,
+                const CompactSboVector<T, N, Alloc, Growth>& b)
+{
+   return !(a == b);
+}
+
+
+template <typename T, std::size_t N, typename Alloc, typename Growth>
+bool operator<(const CompactSboVector<T, N, Alloc, Growth>& a,
+               const CompactSboVector<T, N, Alloc, Growth>& b)
+{
+   return std::lexicographical_compare(a.begin(), a.end(), b.begin(), b.end());
+}
+
+
+template <typename T, std::size_t N, typename Alloc, typename Growth>
+void swap(CompactSboVector<T, N, Alloc, Growth>& a, CompactSboVector<T, N, Alloc, Growth>& b)
+{
+   a.swap(b);
+}
+
+} // namespace ds
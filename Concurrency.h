@@ -0,0 +1,42 @@
+#pragma once
+#include <cstddef>
+#include <thread>
+
+
+namespace ds
+{
+namespace internals
+{
+///////////////////
+
+// Alignment that keeps data written by different threads on separate cache lines.
+// Fixed instead of std::hardware_destructive_interference_size, whose value depends on
+// compiler flags like -mtune and would change the layout of the containers between
+// translation units. 64 bytes is the cache line size of common x86 and ARM cores.
+inline constexpr std::size_t CacheLineSize = 64;
+
+
+///////////////////
+
+// Wait strategy for lock-free retry loops.
+// Retries immediately for a few rounds, because the other thread usually finishes
+// quickly, and then yields the time slice to not starve the thread that is waited
+// for.
+class Backoff
+{
+ public:
+   void pause() noexcept
+   {
+      if (m_numSpins < MaxSpins)
+         ++m_numSpins;
+      else
+         std::this_thread::yield();
+   }
+
+ private:
+   static constexpr int MaxSpins = 64;
+   int m_numSpins = 0;
+};
+
+} // namespace internals
+} // namespace ds
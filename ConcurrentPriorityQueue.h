@@ -0,0 +1,339 @@
+#pragma once
+#include "Concurrency.h"
+#include "PriorityQueue.h"
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <random>
+#include <thread>
+#include <utility>
+
+
+namespace ds
+{
+namespace internals
+{
+///////////////////
+
+// Cheap random index below the given bound. Each thread uses its own generator, so
+// threads that pick queues do not contend on shared state.
+inline std::size_t threadRandomIndex(std::size_t bound)
+{
+   thread_local std::minstd_rand gen{
+      static_cast<std::minstd_rand::result_type>(
+         std::hash<std::thread::id>{}(std::this_thread::get_id()))};
+   return gen() % bound;
+}
+
+} // namespace internals
+
+
+///////////////////
+
+// Order in which ConcurrentPriorityQueue pops elements.
+enum class PopOrdering
+{
+   // Pops an element close to the top. Scales with the number of threads.
+   Relaxed,
+   // Pops the top element. Pops lock the whole queue.
+   Strict
+};
+
+
+///////////////////
+
+// Priority queue for any number of threads that push and pop elements.
+// Splits the elements over multiple PriorityQueues, each with its own lock, so that
+// threads rarely wait for each other. Pushing locks a random queue that is not locked
+// by another thread and inserts the element there.
+// With relaxed ordering the queue is a MultiQueue (Rihani, Sanders, Dementiev). Popping
+// picks two random queues and pops from the one with the better top element. The
+// popped element is not necessarily the top element of the whole structure but close
+// to it, and the expected rank error only depends on the number of queues. Use this
+// for schedulers where roughly ordered processing is good enough.
+// With strict ordering popping locks all queues and pops the best of their top
+// elements. Pushes still spread over the queues, but pops are serialized and take
+// time proportional to the number of queues.
+// Like the other concurrent containers the state functions only give a snapshot
+// while other threads modify the queue.
+template <typename T, typename Criterium = std::less<T>,
+          PopOrdering Ordering = PopOrdering::Relaxed, std::size_t Arity = 2>
+class ConcurrentPriorityQueue
+{
+ public:
+   using value_type = T;
+   using size_type = std::size_t;
+
+ public:
+   // Creates the given number of queues per thread. The MultiQueue paper suggests
+   // two queues per thread for relaxed ordering. Strict ordering works best with few
+   // queues.
+   explicit ConcurrentPriorityQueue(std::size_t numThreads,
+                                    std::size_t queuesPerThread = 2,
+                                    const Criterium& crit = {});
+   ~ConcurrentPriorityQueue() = default;
+   ConcurrentPriorityQueue(const ConcurrentPriorityQueue&) = delete;
+   ConcurrentPriorityQueue& operator=(const ConcurrentPriorityQueue&) = delete;
+   ConcurrentPriorityQueue(ConcurrentPriorityQueue&&) = delete;
+   ConcurrentPriorityQueue& operator=(ConcurrentPriorityQueue&&) = delete;
+
+   size_type size() const noexcept;
+   bool empty() const noexcept { return size() == 0; }
+   size_type num_queues() const noexcept { return m_numQueues; }
+
+   void push(const T& val) { emplace(val); }
+   void push(T&& val) { emplace(std::move(val)); }
+   template <typename... Args> void emplace(Args&&... args);
+
+   // Waits until there is an element.
+   T pop();
+   // Returns false if the queue is empty.
+   bool try_pop(T& val);
+
+ private:
+   using Queue = PriorityQueue<T, Criterium, Arity>;
+
+   struct alignas(internals::CacheLineSize) Shard
+   {
+      std::mutex mutex;
+      Queue queue;
+      // Number of elements that can be read without holding the lock.
+      std::atomic<size_type> size = 0;
+   };
+
+   // Locks all queues while it is alive. Locks in index order, so that concurrent
+   // pops do not deadlock.
+   class LockAll
+   {
+    public:
+      explicit LockAll(ConcurrentPriorityQueue& cpq);
+      ~LockAll();
+      LockAll(const LockAll&) = delete;
+      LockAll& operator=(const LockAll&) = delete;
+
+    private:
+      ConcurrentPriorityQueue& m_cpq;
+   };
+
+   Shard& randomShard() { return m_shards[internals::threadRandomIndex(m_numQueues)]; }
+   // Returns the shard with the better top element of two locked shards. Returns
+   // nullptr if both are empty.
+   Shard* better(Shard* a, Shard* b) const;
+   // Pops from a locked shard.
+   static T popFrom(Shard& shard);
+
+   std::optional<T> tryPop();
+   std::optional<T> tryPopRelaxed();
+   std::optional<T> tryPopStrict();
+   // Pops from the first non-empty queue starting at a random queue.
+   std::optional<T> tryPopAny();
+
+ private:
+   std::size_t m_numQueues = 0;
+   std::unique_ptr<Shard[]> m_shards;
+   Criterium m_crit;
+};
+
+
+template <typename T, typename Criterium, PopOrdering Ordering, std::size_t Arity>
+ConcurrentPriorityQueue<T, Criterium, Ordering, Arity>::ConcurrentPriorityQueue(
+   std::size_t numThreads, std::size_t queuesPerThread, const Criterium& crit)
+: m_numQueues{std::max<std::size_t>(numThreads * queuesPerThread, 1)},
+  m_shards{std::make_unique<Shard[]>(m_numQueues)}, m_crit{crit}
+{
+   for (std::size_t i = 0; i < m_numQueues; ++i)
+      m_shards[i].queue = Queue{crit};
+}
+
+
+template <typename T, typename Criterium, PopOrdering Ordering, std::size_t Arity>
+typename ConcurrentPriorityQueue<T, Criterium, Ordering, Arity>::size_type
+ConcurrentPriorityQueue<T, Criterium, Ordering, Arity>::size() const noexcept
+{
+   size_type total = 0;
+   for (std::size_t i = 0; i < m_numQueues; ++i)
+      total += m_shards[i].size.load(std::memory_order_relaxed);
+   return total;
+}
+
+
+template <typename T, typename Criterium, PopOrdering Ordering, std::size_t Arity>
+template <typename... Args>
+void ConcurrentPriorityQueue<T, Criterium, Ordering, Arity>::emplace(Args&&... args)
+{
+   // Any queue will do, so skip queues that other threads hold instead of waiting for
+   // them.
+   internals::Backoff backoff;
+   while (true)
+   {
+      Shard& shard = randomShard();
+      std::unique_lock lock{shard.mutex, std::try_to_lock};
+      if (lock)
+      {
+         shard.queue.emplace(std::forward<Args>(args)...);
+         shard.size.store(shard.queue.size(), std::memory_order_relaxed);
+         return;
+      }
+      backoff.pause();
+   }
+}
+
+
+template <typename T, typename Criterium, PopOrdering Ordering, std::size_t Arity>
+T ConcurrentPriorityQueue<T, Criterium, Ordering, Arity>::pop()
+{
+   internals::Backoff backoff;
+   while (true)
+   {
+      std::optional<T> popped = tryPop();
+      if (popped)
+         return std::move(*popped);
+      backoff.pause();
+   }
+}
+
+
+template <typename T, typename Criterium, PopOrdering Ordering, std::size_t Arity>
+bool ConcurrentPriorityQueue<T, Criterium, Ordering, Arity>::try_pop(T& val)
+{
+   std::optional<T> popped = tryPop();
+   if (!popped)
+      return false;
+   val = std::move(*popped);
+   return true;
+}
+
+
+template <typename T, typename Criterium, PopOrdering Ordering, std::size_t Arity>
+ConcurrentPriorityQueue<T, Criterium, Ordering, Arity>::LockAll::LockAll(
+   ConcurrentPriorityQueue& cpq)
+: m_cpq{cpq}
+{
+   for (std::size_t i = 0; i < m_cpq.m_numQueues; ++i)
+      m_cpq.m_shards[i].mutex.lock();
+}
+
+
+template <typename T, typename Criterium, PopOrdering Ordering, std::size_t Arity>
+ConcurrentPriorityQueue<T, Criterium, Ordering, Arity>::LockAll::~LockAll()
+{
+   for (std::size_t i = m_cpq.m_numQueues; i > 0; --i)
+      m_cpq.m_shards[i - 1].mutex.unlock();
+}
+
+
+template <typename T, typename Criterium, PopOrdering Ordering, std::size_t Arity>
+typename ConcurrentPriorityQueue<T, Criterium, Ordering, Arity>::Shard*
+ConcurrentPriorityQueue<T, Criterium, Ordering, Arity>::better(Shard* a, Shard* b) const
+{
+   if (a->queue.empty())
+      return b->queue.empty() ? nullptr : b;
+   if (b->queue.empty())
+      return a;
+   return m_crit(b->queue.top(), a->queue.top()) ? b : a;
+}
+
+
+template <typename T, typename Criterium, PopOrdering Ordering, std::size_t Arity>
+T ConcurrentPriorityQueue<T, Criterium, Ordering, Arity>::popFrom(Shard& shard)
+{
+   T val = shard.queue.pop();
+   shard.size.store(shard.queue.size(), std::memory_order_relaxed);
+   return val;
+}
+
+
+template <typename T, typename Criterium, PopOrdering Ordering, std::size_t Arity>
+std::optional<T> ConcurrentPriorityQueue<T, Criterium, Ordering, Arity>::tryPop()
+{
+   if constexpr (Ordering == PopOrdering::Strict)
+      return tryPopStrict();
+   else
+      return tryPopRelaxed();
+}
+
+
+template <typename T, typename Criterium, PopOrdering Ordering, std::size_t Arity>
+std::optional<T> ConcurrentPriorityQueue<T, Criterium, Ordering, Arity>::tryPopRelaxed()
+{
+   internals::Backoff backoff;
+   while (true)
+   {
+      Shard& a = randomShard();
+      Shard& b = randomShard();
+
+      // Avoid locking queues that are empty. When few elements are left, picking
+      // random queues rarely finds them, so search all queues instead.
+      if (a.size.load(std::memory_order_relaxed) == 0 &&
+          b.size.load(std::memory_order_relaxed) == 0)
+      {
+         return tryPopAny();
+      }
+
+      // Pick other queues instead of waiting for locked ones. Trying the locks
+      // instead of waiting also avoids deadlocks between threads that lock the same
+      // two queues in opposite order.
+      std::unique_lock lockA{a.mutex, std::try_to_lock};
+      if (!lockA)
+      {
+         backoff.pause();
+         continue;
+      }
+      std::unique_lock<std::mutex> lockB;
+      if (&b != &a)
+      {
+         lockB = std::unique_lock{b.mutex, std::try_to_lock};
+         if (!lockB)
+         {
+            backoff.pause();
+            continue;
+         }
+      }
+
+      // Other threads might have emptied the queues since peeking at their sizes.
+      if (Shard* best = better(&a, &b))
+         return popFrom(*best);
+   }
+}
+
+
+template <typename T, typename Criterium, PopOrdering Ordering, std::size_t Arity>
+std::optional<T> ConcurrentPriorityQueue<T, Criterium, Ordering, Arity>::tryPopStrict()
+{
+   LockAll lock{*this};
+
+   Shard* best = &m_shards[0];
+   for (std::size_t i = 1; i < m_numQueues; ++i)
+   {
+      if (Shard* shard = better(best, &m_shards[i]))
+         best = shard;
+   }
+
+   if (best->queue.empty())
+      return std::nullopt;
+   return popFrom(*best);
+}
+
+
+template <typename T, typename Criterium, PopOrdering Ordering, std::size_t Arity>
+std::optional<T> ConcurrentPriorityQueue<T, Criterium, Ordering, Arity>::tryPopAny()
+{
+   const std::size_t start = internals::threadRandomIndex(m_numQueues);
+   for (std::size_t i = 0; i < m_numQueues; ++i)
+   {
+      Shard& shard = m_shards[(start + i) % m_numQueues];
+      if (shard.size.load(std::memory_order_relaxed) == 0)
+         continue;
+
+      std::lock_guard lock{shard.mutex};
+      if (!shard.queue.empty())
+         return popFrom(shard);
+   }
+   return std::nullopt;
+}
+
+} // namespace ds
@@ -0,0 +1,847 @@
+#pragma once
+#include "AlignedAllocator.h"
+#include "RingBuffer.h"
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <memory_resource>
+#include <span>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+
+namespace ds
+{
+///////////////////
+
+// Ring buffer with a capacity that is chosen at runtime.
+// Has the same interface, overflow policies and iterators as RingBuffer. The storage
+// is allocated once when the ring buffer is created and only reallocated when the
+// capacity is changed explicitly. The allocator decides about the alignment of the
+// storage, e.g. AlignedAllocator<T, 64> for cache line alignment or
+// HugePageAllocator<T> for large buffers.
+// Like for RingBuffer, elements are constructed in the uninitialized storage when
+// they are pushed. Unlike RingBuffer the start position is kept wrapped, so that
+// mapping positions to slots only needs a comparison instead of a division by the
+// runtime capacity.
+template <typename T, OverflowPolicy Policy = OverflowPolicy::Overwrite,
+          typename Alloc = AlignedAllocator<T>>
+class DynamicRingBuffer
+{
+   static_assert(std::is_same_v<typename std::allocator_traits<Alloc>::value_type, T>,
+                 "Allocator must allocate elements of the ring buffer's element type.");
+
+   template <typename RB> friend class RingBufferConstIterator;
+   template <typename RB> friend class RingBufferIterator;
+
+   using AllocTraits = std::allocator_traits<Alloc>;
+
+ public:
+   using value_type = T;
+   using allocator_type = Alloc;
+   using size_type = std::size_t;
+   using difference_type = int64_t;
+   using reference = T&;
+   using const_reference = const T&;
+   using pointer = T*;
+   using const_pointer = const T*;
+   using iterator = RingBufferIterator<DynamicRingBuffer<T, Policy, Alloc>>;
+   using const_iterator = RingBufferConstIterator<DynamicRingBuffer<T, Policy, Alloc>>;
+   using reverse_iterator = std::reverse_iterator<iterator>;
+   using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+   using spans = RingBufferSpans<T>;
+   using const_spans = RingBufferSpans<const T>;
+
+ public:
+   DynamicRingBuffer() = default;
+   explicit DynamicRingBuffer(size_type capacity, const Alloc& alloc = Alloc());
+   template <typename Iter>
+   DynamicRingBuffer(size_type capacity, Iter first, Iter last,
+                     const Alloc& alloc = Alloc());
+   DynamicRingBuffer(size_type capacity, std::initializer_list<T> ilist,
+                     const Alloc& alloc = Alloc());
+   ~DynamicRingBuffer();
+   DynamicRingBuffer(const DynamicRingBuffer& other);
+   // Copies the other buffer into storage allocated by the given allocator.
+   DynamicRingBuffer(const DynamicRingBuffer& other, const Alloc& alloc);
+   DynamicRingBuffer& operator=(const DynamicRingBuffer& other);
+   DynamicRingBuffer(DynamicRingBuffer&& other) noexcept;
+   // Only takes over the storage of the other buffer if the allocators propagate or
+   // compare equal. Otherwise moves the elements into new storage.
+   DynamicRingBuffer& operator=(DynamicRingBuffer&& other) noexcept(
+      AllocTraits::propagate_on_container_move_assignment::value ||
+      AllocTraits::is_always_equal::value);
+
+   size_type size() const noexcept;
+   size_type capacity() const noexcept;
+   bool empty() const noexcept;
+   bool full() const noexcept;
+   T& at(size_type idx);
+   const T& at(size_type idx) const;
+   T& operator[](size_type idx);
+   const T& operator[](size_type idx) const;
+   // Returns false if the element was rejected.
+   bool push(const T& val);
+   bool push(T&& val);
+   // Pushes an element constructed in place from the given arguments. Returns the new
+   // element. Throws if the element is rejected.
+   template <typename... Args> T& emplace(Args&&... args);
+   // Removes the newest element.
+   T pop();
+   // Removes the oldest element.
+   T pop_front();
+   void clear();
+   void swap(DynamicRingBuffer& other) noexcept;
+   allocator_type get_allocator() const { return m_alloc; }
+
+   // Changes the capacity and reallocates the storage. Keeps the newest elements that
+   // fit into the new capacity. Elements removed by shrinking are not counted as
+   // overwritten or dropped.
+   void set_capacity(size_type capacity);
+
+   // Bulk operations that copy elements in at most two contiguous chunks.
+   // Pushes the given number of elements as if each was pushed individually. Returns
+   // the number of elements that were not rejected.
+   template <typename Iter> size_type push_n(Iter first, size_type count);
+   // Pops up to the given number of elements as if each was popped individually, i.e.
+   // the newest element is written first. Returns the number of popped elements.
+   template <typename OutIter> size_type pop_n(OutIter out, size_type count);
+   // Appends the elements like push_n.
+   size_type write(std::span<const T> src);
+   // Removes the oldest elements and writes them into the given span in their
+   // order in the buffer. Returns the number of read elements.
+   size_type read(std::span<T> dest);
+
+   // Direct access to the storage, e.g. to pass it to writev.
+   // Regions of the populated elements from oldest to newest.
+   spans readable_spans() noexcept;
+   const_spans readable_spans() const noexcept;
+   // Regions of the unpopulated slots in the order that they get populated.
+   // The slots hold no constructed elements. Only available for trivially copyable
+   // element types that can be written into raw memory.
+   spans writable_spans() noexcept;
+   // Appends the given number of elements that were written to the writable spans.
+   void commit(size_type count);
+   // Removes the given number of oldest elements, e.g. after processing them through
+   // the readable spans.
+   void consume(size_type count);
+
+   // Number of elements that were overwritten since construction or the last reset.
+   uint64_t num_overwritten() const noexcept { return m_numOverwritten; }
+   // Number of pushed elements that were rejected since construction or the last
+   // reset.
+   uint64_t num_dropped() const noexcept { return m_numDropped; }
+   void reset_counters() noexcept;
+
+   iterator begin() noexcept;
+   iterator end() noexcept;
+   const_iterator begin() const noexcept;
+   const_iterator end() const noexcept;
+   const_iterator cbegin() const noexcept;
+   const_iterator cend() const noexcept;
+   reverse_iterator rbegin() noexcept;
+   reverse_iterator rend() noexcept;
+   const_reverse_iterator rbegin() const noexcept;
+   const_reverse_iterator rend() const noexcept;
+   const_reverse_iterator crbegin() const noexcept;
+   const_reverse_iterator crend() const noexcept;
+
+ private:
+   // Maps an index relative to the start to the index of its slot in the storage.
+   // Valid for indices up to twice the capacity.
+   size_type slot(size_type idx) const noexcept;
+   template <typename U> bool pushValue(U&& val);
+   // Destroys the given number of elements starting at the given index.
+   void destroy(size_type idx, size_type count) noexcept;
+   // Regions of the storage that hold the given number of slots from the given one.
+   template <typename Elem>
+   RingBufferSpans<Elem> regions(Elem* storage, size_type fromSlot,
+                                 size_type count) const;
+
+   // Allocates uninitialized storage.
+   T* allocateStorage(size_type capacity);
+   void deallocateStorage(T* storage, size_type capacity) noexcept;
+   // Exchanges everything but the allocators. Only valid if the storage of each buffer
+   // can be released by the allocator of the other buffer.
+   void swapData(DynamicRingBuffer& other) noexcept;
+
+ private:
+   T* m_buffer = nullptr;
+   size_type m_capacity = 0;
+   // Slot of the first (oldest) element.
+   size_type m_start = 0;
+   size_type m_size = 0;
+   uint64_t m_numOverwritten = 0;
+   uint64_t m_numDropped = 0;
+   Alloc m_alloc{};
+};
+
+
+template <typename T, OverflowPolicy Policy, typename Alloc>
+DynamicRingBuffer<T, Policy, Alloc>::DynamicRingBuffer(size_type capacity,
+                                                       const Alloc& alloc)
+: m_alloc{alloc}
+{
+   m_buffer = allocateStorage(capacity);
+   m_capacity = capacity;
+}
+
+
+template <typename T, OverflowPolicy Policy, typename Alloc>
+template <typename Iter>
+DynamicRingBuffer<T, Policy, Alloc>::DynamicRingBuffer(size_type capacity, Iter first,
+                                                       Iter last, const Alloc& alloc)
+: DynamicRingBuffer(capacity, alloc)
+{
+   push_n(first, static_cast<size_type>(std::distance(first, last)));
+}
+
+
+template <typename T, OverflowPolicy Policy, typename Alloc>
+DynamicRingBuffer<T, Policy, Alloc>::DynamicRingBuffer(size_type capacity,
+                                                       std::initializer_list<T> ilist,
+                                                       const Alloc& alloc)
+: DynamicRingBuffer(capacity, ilist.begin(), ilist.end(), alloc)
+{
+}
+
+
+template <typename T, OverflowPolicy Policy, typename Alloc>
+DynamicRingBuffer<T, Policy, Alloc>::~DynamicRingBuffer()
+{
+   destroy(0, m_size);
+   deallocateStorage(m_buffer, m_capacity);
+}
+
+
+template <typename T, OverflowPolicy Policy, typename Alloc>
+DynamicRingBuffer<T, Policy, Alloc>::DynamicRingBuffer(const DynamicRingBuffer& other)
+: DynamicRingBuffer(other,
+                    AllocTraits::select_on_container_copy_construction(other.m_alloc))
+{
+}
+
+
+template <typename T, OverflowPolicy Policy, typename Alloc>
+DynamicRingBuffer<T, Policy, Alloc>::DynamicRingBuffer(const DynamicRingBuffer& other,
+                                                       const Alloc& alloc)
+: m_alloc{alloc}
+{
+   m_buffer = allocateStorage(other.m_capacity);
+   m_capacity = other.m_capacity;
+   // Keep the same layout to copy the elements in at most two chunks.
+   const const_spans src = other.readable_spans();
+   T* firstCopied = m_buffer + other.m_start;
+   try
+   {
+      T* lastCopied = std::uninitialized_copy(src.first.begin(), src.first.end(),
+                                              firstCopied);
+      try
+      {
+         std::uninitialized_copy(src.second.begin(), src.second.end(), m_buffer);
+      }
+      catch (...)
+      {
+         std::destroy(firstCopied, lastCopied);
+         throw;
+      }
+   }
+   catch (...)
+   {
+      deallocateStorage(m_buffer, m_capacity);
+      throw;
+   }
+   m_start = other.m_start;
+   m_size = other.m_size;
+   m_numOverwritten = other.m_numOverwritten;
+   m_numDropped = other.m_numDropped;
+}
+
+
+template <typename T, OverflowPolicy Policy, typename Alloc>
+DynamicRingBuffer<T, Policy, Alloc>&
+DynamicRingBuffer<T, Policy, Alloc>::operator=(const DynamicRingBuffer& other)
+{
+   if (this == &other)
+      return *this;
+
+   // Copy into storage of the allocator that this buffer uses after the assignment, so
+   // that the storage is always released by the allocator that allocated it.
+   if constexpr (AllocTraits::propagate_on_container_copy_assignment::value)
+   {
+      DynamicRingBuffer copy{other, other.m_alloc};
+      swapData(copy);
+      using std::swap; // Enable ADL.
+      swap(m_alloc, copy.m_alloc);
+   }
+   else
+   {
+      DynamicRingBuffer copy{other, m_alloc};
+      swapData(copy);
+   }
+   return *this;
+}
+
+
+template <typename T, OverflowPolicy Policy, typename Alloc>
+DynamicRingBuffer<T, Policy, Alloc>::DynamicRingBuffer(DynamicRingBuffer&& other) noexcept
+: m_buffer{std::exchange(other.m_buffer, nullptr)},
+  m_capacity{std::exchange(other.m_capacity, 0)},
+  m_start{std::exchange(other.m_start, 0)}, m_size{std::exchange(other.m_size, 0)},
+  m_numOverwritten{std::exchange(other.m_numOverwritten, 0)},
+  m_numDropped{std::exchange(other.m_numDropped, 0)}, m_alloc{std::move(other.m_alloc)}
+{
+}
+
+
+template <typename T, OverflowPolicy Policy, typename Alloc>
+DynamicRingBuffer<T, Policy, Alloc>&
+DynamicRingBuffer<T, Policy, Alloc>::operator=(DynamicRingBuffer&& other) noexcept(
+   AllocTraits::propagate_on_container_move_assignment::value ||
+   AllocTraits::is_always_equal::value)
+{
+   if (this == &other)
+      return *this;
+
+   if constexpr (AllocTraits::propagate_on_container_move_assignment::value)
+   {
+      DynamicRingBuffer moved{std::move(other)};
+      swapData(moved);
+      using std::swap; // Enable ADL.
+      swap(m_alloc, moved.m_alloc);
+   }
+   else
+   {
+      if (AllocTraits::is_always_equal::value || m_alloc == other.m_alloc)
+      {
+         // The storage can be released by this buffer's allocator, so take it over.
+         // The previous storage gets released together with the temporary buffer.
+         DynamicRingBuffer moved(0, m_alloc);
+         moved.swapData(other);
+         swapData(moved);
+      }
+      else
+      {
+         // The storage has to stay with the other allocator. Move the elements into
+         // storage of this buffer's allocator instead.
+         DynamicRingBuffer moved(other.m_capacity, m_alloc);
+         const spans src = other.readable_spans();
+         moved.push_n(std::make_move_iterator(src.first.begin()), src.first.size());
+         moved.push_n(std::make_move_iterator(src.second.begin()), src.second.size());
+         moved.m_numOverwritten = other.m_numOverwritten;
+         moved.m_numDropped = other.m_numDropped;
+         other.clear();
+         other.reset_counters();
+         swapData(moved);
+      }
+   }
+   return *this;
+}
+
+
+template <typename T, OverflowPolicy Policy, typename Alloc>
+typename DynamicRingBuffer<T, Policy, Alloc>::size_type
+DynamicRingBuffer<T, Policy, Alloc>::size() const noexcept
+{
+   return m_size;
+}
+
+
+template <typename T, OverflowPolicy Policy, typename Alloc>
+typename DynamicRingBuffer<T, Policy, Alloc>::size_type
+DynamicRingBuffer<T, Policy, Alloc>::capacity() const noexcept
+{
+   return m_capacity;
+}
+
+
+template <typename T, OverflowPolicy Policy, typename Alloc>
+bool DynamicRingBuffer<T, Policy, Alloc>::empty() const noexcept
+{
+   return m_size == 0;
+}
+
+
+template <typename T, OverflowPolicy Policy, typename Alloc>
+bool DynamicRingBuffer<T, Policy, Alloc>::full() const noexcept
+{
+   return m_size == m_capacity;
+}
+
+
+template <typename T, OverflowPolicy Policy, typename Alloc>
+T& DynamicRingBuffer<T, Policy, Alloc>::at(size_type idx)
+{
+   if (idx >= size())
+      throw std::out_of_range("Invalid index into ring buffer.");
+   return m_buffer[slot(idx)];
+}
+
+
+template <typename T, OverflowPolicy Policy, typename Alloc>
+const T& DynamicRingBuffer<T, Policy, Alloc>::at(size_type idx) const
+{
+   if (idx >= size())
+      throw std::out_of_range("Invalid index into ring buffer.");
+   return m_buffer[slot(idx)];
+}
+
+
+template <typename T, OverflowPolicy Policy, typename Alloc>
+T& DynamicRingBuffer<T, Policy, Alloc>::operator[](size_type idx)
+{
+   return m_buffer[slot(idx)];
+}
+
+
+template <typename T, OverflowPolicy Policy, typename Alloc>
+const T& DynamicRingBuffer<T, Policy, Alloc>::operator[](size_type idx) const
+{
+   return m_buffer[slot(idx)];
+}
+
+
+template <typename T, OverflowPolicy Policy, typename Alloc>
+bool DynamicRingBuffer<T, Policy, Alloc>::push(const T& val)
+{
+   return pushValue(val);
+}
+
+
+template <typename T, OverflowPolicy Policy, typename Alloc>
+bool DynamicRingBuffer<T, Policy, Alloc>::push(T&& val)
+{
+   return pushValue(std::move(val));
+}
+
+
+template <typename T, OverflowPolicy Policy, typename Alloc>
+template <typename... Args>
+T& DynamicRingBuffer<T, Policy, Alloc>::emplace(Args&&... args)
+{
+   const internals::RingPushPlan plan =
+      internals::planRingPush<Policy>(1, m_size, m_capacity);
+   if (plan.numDropped > 0)
+   {
+      ++m_numDropped;
+      throw std::runtime_error((m_capacity == 0)
+                                  ? "Emplacing into ring buffer without storage."
+                                  : "Emplacing into full ring buffer.");
+   }
+   if (plan.numOverwritten > 0)
+   {
+      // The arguments might refer to the oldest element, so construct the new
+      // element before dropping the oldest one.
+      T elem(std::forward<Args>(args)...);
+      std::destroy_at(m_buffer + m_start);
+      m_start = slot(1);
+      --m_size;
+      ++m_numOverwritten;
+      T* added = std::construct_at(m_buffer + slot(m_size), std::move(elem));
+      ++m_size;
+      return *added;
+   }
+
+   T* added = std::construct_at(m_buffer + slot(m_size), std::forward<Args>(args)...);
+   ++m_size;
+   return *added;
+}
+
+
+template <typename T, OverflowPolicy Policy, typename Alloc>
+T DynamicRingBuffer<T, Policy, Alloc>::pop()
+{
+   if (empty())
+      throw std::runtime_error("Popping from empty ring buffer.");
+
+   T* last = m_buffer + slot(m_size - 1);
+   T popped = std::move(*last);
+   std::destroy_at(last);
+   --m_size;
+   return popped;
+}
+
+
+template <typename T, OverflowPolicy Policy, typename Alloc>
+T DynamicRingBuffer<T, Policy, Alloc>::pop_front()
+{
+   if (empty())
+      throw std::runtime_error("Popping from empty ring buffer.");
+
+   T* first = m_buffer + m_start;
+   T popped = std::move(*first);
+   std::destroy_at(first);
+   m_start = slot(1);
+   --m_size;
+   return popped;
+}
+
+
+template <typename T, OverflowPolicy Policy, typename Alloc>
+void DynamicRingBuffer<T, Policy, Alloc>::clear()
+{
+   destroy(0, m_size);
+   m_start = 0;
+   m_size = 0;
+}
+
+
+template <typename T, OverflowPolicy Policy, typename Alloc>
+void DynamicRingBuffer<T, Policy, Alloc>::swap(DynamicRingBuffer& other) noexcept
+{
+   // The storage can only be exchanged if it can be released by either allocator.
+   if constexpr (AllocTraits::propagate_on_container_swap::value)
+   {
+      using std::swap; // Enable ADL.
+      swap(m_alloc, other.m_alloc);
+   }
+   else
+   {
+      assert(m_alloc == other.m_alloc);
+   }
+
+   swapData(other);
+}
+
+
+template <typename T, OverflowPolicy Policy, typename Alloc>
+void DynamicRingBuffer<T, Policy, Alloc>::set_capacity(size_type capacity)
+{
+   if (capacity == m_capacity)
+      return;
+
+   T* newBuffer = allocateStorage(capacity);
+
+   // Move the newest elements to the beginning of the new storage.
+   const size_type numKept = std::min(m_size, capacity);
+   const spans src = regions(m_buffer, slot(m_size - numKept), numKept);
+   T* out = newBuffer;
+   try
+   {
+      out = std::uninitialized_move(src.first.begin(), src.first.end(), out);
+      std::uninitialized_move(src.second.begin(), src.second.end(), out);
+   }
+   catch (...)
+   {
+      std::destroy(newBuffer, out);
+      deallocateStorage(newBuffer, capacity);
+      throw;
+   }
+
+   destroy(0, m_size);
+   deallocateStorage(m_buffer, m_capacity);
+   m_buffer = newBuffer;
+   m_capacity = capacity;
+   m_start = 0;
+   m_size = numKept;
+}
+
+
+template <typename T, OverflowPolicy Policy, typename Alloc>
+template <typename Iter>
+typename DynamicRingBuffer<T, Policy, Alloc>::size_type
+DynamicRingBuffer<T, Policy, Alloc>::push_n(Iter first, size_type count)
+{
+   const internals::RingPushPlan plan =
+      internals::planRingPush<Policy>(count, m_size, m_capacity);
+   m_numDropped += plan.numDropped;
+   consume(plan.numOverwritten);
+   m_numOverwritten += plan.numOverwritten + plan.numSkipped;
+   if (plan.numSkipped > 0)
+   {
+      // The buffer is empty, so the start moves along with the end.
+      std::advance(first, plan.numSkipped);
+      m_start = (m_start + plan.numSkipped) % m_capacity;
+   }
+
+   internals::uninitializedCopyToRegions(first,
+                                         regions(m_buffer, slot(m_size), plan.numCopied));
+   m_size += plan.numCopied;
+   return plan.numPushed();
+}
+
+
+template <typename T, OverflowPolicy Policy, typename Alloc>
+template <typename OutIter>
+typename DynamicRingBuffer<T, Policy, Alloc>::size_type
+DynamicRingBuffer<T, Policy, Alloc>::pop_n(OutIter out, size_type count)
+{
+   const size_type numPopped = std::min(count, size());
+   const spans src = regions(m_buffer, slot(m_size - numPopped), numPopped);
+   internals::moveFromRegionsReversed(src, out);
+   destroy(m_size - numPopped, numPopped);
+   m_size -= numPopped;
+   return numPopped;
+}
+
+
+template <typename T, OverflowPolicy Policy, typename Alloc>
+typename DynamicRingBuffer<T, Policy, Alloc>::size_type
+DynamicRingBuffer<T, Policy, Alloc>::write(std::span<const T> src)
+{
+   return push_n(src.begin(), src.size());
+}
+
+
+template <typename T, OverflowPolicy Policy, typename Alloc>
+typename DynamicRingBuffer<T, Policy, Alloc>::size_type
+DynamicRingBuffer<T, Policy, Alloc>::read(std::span<T> dest)
+{
+   const size_type numRead = std::min(dest.size(), size());
+   internals::moveFromRegions(regions(m_buffer, m_start, numRead), dest.begin());
+   consume(numRead);
+   return numRead;
+}
+
+
+template <typename T, OverflowPolicy Policy, typename Alloc>
+typename DynamicRingBuffer<T, Policy, Alloc>::spans
+DynamicRingBuffer<T, Policy, Alloc>::readable_spans() noexcept
+{
+   return regions(m_buffer, m_start, m_size);
+}
+
+
+template <typename T, OverflowPolicy Policy, typename Alloc>
+typename DynamicRingBuffer<T, Policy, Alloc>::const_spans
+DynamicRingBuffer<T, Policy, Alloc>::readable_spans() const noexcept
+{
+   return regions(static_cast<const T*>(m_buffer), m_start, m_size);
+}
+
+
+template <typename T, OverflowPolicy Policy, typename Alloc>
+typename DynamicRingBuffer<T, Policy, Alloc>::spans
+DynamicRingBuffer<T, Policy, Alloc>::writable_spans() noexcept
+{
+   static_assert(std::is_trivially_copyable_v<T>,
+                 "Writing into raw slots requires trivially copyable elements.");
+   return regions(m_buffer, slot(m_size), m_capacity - m_size);
+}
+
+
+template <typename T, OverflowPolicy Policy, typename Alloc>
+void DynamicRingBuffer<T, Policy, Alloc>::commit(size_type count)
+{
+   static_assert(std::is_trivially_copyable_v<T>,
+                 "Writing into raw slots requires trivially copyable elements.");
+   if (count > m_capacity - m_size)
+      throw std::out_of_range("Committing more elements than free slots in ring buffer.");
+   m_size += count;
+}
+
+
+template <typename T, OverflowPolicy Policy, typename Alloc>
+void DynamicRingBuffer<T, Policy, Alloc>::consume(size_type count)
+{
+   if (count > m_size)
+      throw std::out_of_range("Consuming more elements than stored in ring buffer.");
+   destroy(0, count);
+   m_start = slot(count);
+   m_size -= count;
+}
+
+
+template <typename T, OverflowPolicy Policy, typename Alloc>
+void DynamicRingBuffer<T, Policy, Alloc>::reset_counters() noexcept
+{
+   m_numOverwritten = 0;
+   m_numDropped = 0;
+}
+
+
+template <typename T, OverflowPolicy Policy, typename Alloc>
+typename DynamicRingBuffer<T, Policy, Alloc>::iterator
+DynamicRingBuffer<T, Policy, Alloc>::begin() noexcept
+{
+   return iterator(this, 0);
+}
+
+
+template <typename T, OverflowPolicy Policy, typename Alloc>
+typename DynamicRingBuffer<T, Policy, Alloc>::iterator
+DynamicRingBuffer<T, Policy, Alloc>::end() noexcept
+{
+   return iterator(this, size());
+}
+
+
+template <typename T, OverflowPolicy Policy, typename Alloc>
+typename DynamicRingBuffer<T, Policy, Alloc>::const_iterator
+DynamicRingBuffer<T, Policy, Alloc>::begin() const noexcept
+{
+   return cbegin();
+}
+
+
+template <typename T, OverflowPolicy Policy, typename Alloc>
+typename DynamicRingBuffer<T, Policy, Alloc>::const_iterator
+DynamicRingBuffer<T, Policy, Alloc>::end() const noexcept
+{
+   return cend();
+}
+
+
+template <typename T, OverflowPolicy Policy, typename Alloc>
+typename DynamicRingBuffer<T, Policy, Alloc>::const_iterator
+DynamicRingBuffer<T, Policy, Alloc>::cbegin() const noexcept
+{
+   return const_iterator(this, 0);
+}
+
+
+template <typename T, OverflowPolicy Policy, typename Alloc>
+typename DynamicRingBuffer<T, Policy, Alloc>::const_iterator
+DynamicRingBuffer<T, Policy, Alloc>::cend() const noexcept
+{
+   return const_iterator(this, size());
+}
+
+
+template <typename T, OverflowPolicy Policy, typename Alloc>
+typename DynamicRingBuffer<T, Policy, Alloc>::reverse_iterator
+DynamicRingBuffer<T, Policy, Alloc>::rbegin() noexcept
+{
+   return reverse_iterator(end());
+}
+
+
+template <typename T, OverflowPolicy Policy, typename Alloc>
+typename DynamicRingBuffer<T, Policy, Alloc>::reverse_iterator
+DynamicRingBuffer<T, Policy, Alloc>::rend() noexcept
+{
+   return reverse_iterator(begin());
+}
+
+
+template <typename T, OverflowPolicy Policy, typename Alloc>
+typename DynamicRingBuffer<T, Policy, Alloc>::const_reverse_iterator
+DynamicRingBuffer<T, Policy, Alloc>::rbegin() const noexcept
+{
+   return crbegin();
+}
+
+
+template <typename T, OverflowPolicy Policy, typename Alloc>
+typename DynamicRingBuffer<T, Policy, Alloc>::const_reverse_iterator
+DynamicRingBuffer<T, Policy, Alloc>::rend() const noexcept
+{
+   return crend();
+}
+
+
+template <typename T, OverflowPolicy Policy, typename Alloc>
+typename DynamicRingBuffer<T, Policy, Alloc>::const_reverse_iterator
+DynamicRingBuffer<T, Policy, Alloc>::crbegin() const noexcept
+{
+   return const_reverse_iterator(cend());
+}
+
+
+template <typename T, OverflowPolicy Policy, typename Alloc>
+typename DynamicRingBuffer<T, Policy, Alloc>::const_reverse_iterator
+DynamicRingBuffer<T, Policy, Alloc>::crend() const noexcept
+{
+   return const_reverse_iterator(cbegin());
+}
+
+
+template <typename T, OverflowPolicy Policy, typename Alloc>
+typename DynamicRingBuffer<T, Policy, Alloc>::size_type
+DynamicRingBuffer<T, Policy, Alloc>::slot(size_type idx) const noexcept
+{
+   const size_type unwrapped = m_start + idx;
+   return (unwrapped >= m_capacity) ? unwrapped - m_capacity : unwrapped;
+}
+
+
+template <typename T, OverflowPolicy Policy, typename Alloc>
+template <typename U>
+bool DynamicRingBuffer<T, Policy, Alloc>::pushValue(U&& val)
+{
+   const internals::RingPushPlan plan =
+      internals::planRingPush<Policy>(1, m_size, m_capacity);
+   if (plan.numDropped > 0)
+   {
+      ++m_numDropped;
+      return false;
+   }
+
+   if constexpr (std::is_assignable_v<T&, U&&>)
+   {
+      if (plan.numOverwritten > 0)
+      {
+         // Reuse the oldest element.
+         m_buffer[m_start] = std::forward<U>(val);
+         m_start = slot(1);
+         ++m_numOverwritten;
+         return true;
+      }
+   }
+   emplace(std::forward<U>(val));
+   return true;
+}
+
+
+template <typename T, OverflowPolicy Policy, typename Alloc>
+void DynamicRingBuffer<T, Policy, Alloc>::destroy(size_type idx, size_type count) noexcept
+{
+   internals::destroyRegions(regions(m_buffer, slot(idx), count));
+}
+
+
+template <typename T, OverflowPolicy Policy, typename Alloc>
+template <typename Elem>
+RingBufferSpans<Elem>
+DynamicRingBuffer<T, Policy, Alloc>::regions(Elem* storage, size_type fromSlot,
+                                             size_type count) const
+{
+   return internals::ringRegions(storage, m_capacity, fromSlot, count);
+}
+
+
+template <typename T, OverflowPolicy Policy, typename Alloc>
+T* DynamicRingBuffer<T, Policy, Alloc>::allocateStorage(size_type capacity)
+{
+   if (capacity == 0)
+      return nullptr;
+   return AllocTraits::allocate(m_alloc, capacity);
+}
+
+
+template <typename T, OverflowPolicy Policy, typename Alloc>
+void DynamicRingBuffer<T, Policy, Alloc>::deallocateStorage(T* storage,
+                                                            size_type capacity) noexcept
+{
+   if (storage)
+      AllocTraits::deallocate(m_alloc, storage, capacity);
+}
+
+
+template <typename T, OverflowPolicy Policy, typename Alloc>
+void DynamicRingBuffer<T, Policy, Alloc>::swapData(DynamicRingBuffer& other) noexcept
+{
+   std::swap(m_buffer, other.m_buffer);
+   std::swap(m_capacity, other.m_capacity);
+   std::swap(m_start, other.m_start);
+   std::swap(m_size, other.m_size);
+   std::swap(m_numOverwritten, other.m_numOverwritten);
+   std::swap(m_numDropped, other.m_numDropped);
+}
+
+
+///////////////////
+
+namespace pmr
+{
+// DynamicRingBuffer that allocates its storage from a std::pmr::memory_resource.
+template <typename T, OverflowPolicy Policy = OverflowPolicy::Overwrite>
+using DynamicRingBuffer =
+   ds::DynamicRingBuffer<T, Policy, std::pmr::polymorphic_allocator<T>>;
+} // namespace pmr
+
+} // namespace ds
@@ -4,7 +4,10 @@
 //
 #pragma once
 #include <cassert>
+#include <cstddef>
+#include <functional>
 #include <stdexcept>
+#include <utility>
 
 namespace ds
 {
@@ -13,14 +16,20 @@ namespace ds
 
 // HeapView data structure.
 // Does not store elements itself but uses given storage.
-// Conceptuall builds a binary tree that fulfills a given heap property for each of its
+// Conceptuall builds a tree that fulfills a given heap property for each of its
 // nodes. The heap property is a given condition that each parent node fulfills when
-// compared to its two child nodes.
+// compared to its child nodes.
+// The arity is the number of children of each node. Binary trees are the classic
+// layout. Higher arities, e.g. 4 or 8, make the tree two or three times shallower and
+// keep the siblings that get compared with each other next to each other in memory,
+// which saves cache misses for large heaps at the cost of more comparisons per level.
 // Predefined HeapView types (see type aliases below):
 //  Max-heap: Each parent node is larger than its child nodes.
 //  Min-heap: Each parent node is smaller than its child nodes.
-template <typename T, typename Condition> class HeapView
+template <typename T, typename Condition, std::size_t Arity = 2> class HeapView
 {
+   static_assert(Arity >= 2, "Heap nodes need at least two children.");
+
  public:
    using value_type = T;
    using size_type = size_t;
@@ -42,6 +51,9 @@ template <typename T, typename Condition> class HeapView
    // storage. Calling pop() repeatedly until the heap is empty will sort the
    // underlying storage in reverse order.
    T pop();
+   // Same as pop() but does not return a copy of the element. The element can be
+   // accessed in the storage slot right behind the heap.
+   void removeTop();
 
    ////////////////
 
@@ -55,16 +67,32 @@ template <typename T, typename Condition> class HeapView
    using ArrayIdx = size_t;
 
    // Heap navigation.
-   static HeapIdx parent(HeapIdx i) noexcept { return i >> 1; }
-   static HeapIdx left(HeapIdx i) noexcept { return i << 1; }
-   static HeapIdx right(HeapIdx i) noexcept { return left(i) + 1; }
+   // The parent of the root is 0.
+   static HeapIdx parent(HeapIdx i) noexcept { return (i + Arity - 2) / Arity; }
+   static HeapIdx firstChild(HeapIdx i) noexcept { return Arity * (i - 1) + 2; }
+   static HeapIdx lastChild(HeapIdx i) noexcept { return firstChild(i) + Arity - 1; }
 
    // Checks if two elements fulfill the heap condition.
    bool compare(HeapIdx a, HeapIdx b) const { return m_heapProp(elem(a), elem(b)); }
+   // Returns the most extreme child of the family starting at the given first child.
+   HeapIdx extremeChild(HeapIdx first) const;
 
    // Swaps two elements in the underlying storage.
    void exchange(HeapIdx a, HeapIdx b) { std::swap(elem(a), elem(b)); }
 
+   // Ensures that the tree at node i satisfies the heap-property, assuming that the
+   // subtrees of its children are heaps.
+   // Moves the element at node i down the tree until it fits.
+   void heapify(HeapIdx i);
+   // Same as heapify() but first moves the most extreme children up along the whole
+   // path to a leaf and then moves the element at node i up from there. Takes about
+   // half the comparisons when the element belongs near the bottom of the tree.
+   void heapifyBottomUp(HeapIdx i);
+   // Ensures that the tree from the root to node i satisfies the heap-property,
+   // assuming that it did before the element at node i was changed or added.
+   // Moves the element at node i up the tree until it fits.
+   void heapifyUp(HeapIdx i);
+
    // Updates the heap data without changing the heap's layout.
    void set(T* vals);
    void set(T* vals, size_t numVals);
@@ -83,16 +111,21 @@ template <typename T, typename Condition> class HeapView
    // Builds a heap out of the given element array.
    void buildHeap();
 
-   // Ensures that the binary tree at node i satisfies the heap-property, assuming
-   // that the left and right binary subtrees are heaps.
-   void heapify(HeapIdx i);
+   // Places the given value into the heap starting at the empty node 'hole'.
+   // The nodes are not swapped. Instead elements are moved into the hole until the
+   // value fits, which saves writes.
+   void siftDown(HeapIdx hole, T val);
+   void siftDownBottomUp(HeapIdx hole, T val);
+   // Moves the hole up towards the node 'top' until the given value fits.
+   void siftUp(HeapIdx hole, HeapIdx top, T val);
 
  private:
-   // Treats the passed data as an array representing a binary tree.
-   // The left and right subtrees of the node at array element i are located in
-   // the array at positions 2*i and 2*i+1 (assuming one-based indices for easier
-   // calculation). A node's parent is located at the array position floor(i/2)
-   // (for one-based indices).
+   // Treats the passed data as an array representing a tree.
+   // The subtrees of the node at array element i are located in the array at
+   // positions d*(i-1)+2 to d*(i-1)+d+1 for arity d (assuming one-based indices for
+   // easier calculation). For binary trees these are positions 2*i and 2*i+1. A
+   // node's parent is located at the array position floor((i-2)/d)+1 (for one-based
+   // indices).
    T* m_root{nullptr};
    size_t m_heapSize{0};
 
@@ -102,104 +135,198 @@ template <typename T, typename Condition> class HeapView
 
 // Standard heap types.
 // Max-heaps are used for the heap sort algorithm.
-template <typename T> using MaxHeap = HeapView<T, std::greater<T>>;
+template <typename T, std::size_t Arity = 2>
+using MaxHeap = HeapView<T, std::greater<T>, Arity>;
 // Min-heaps are used to implement priority queue.
-template <typename T> using MinHeap = HeapView<T, std::less<T>>;
+template <typename T, std::size_t Arity = 2>
+using MinHeap = HeapView<T, std::less<T>, Arity>;
 
 // Implementation
 
-template <typename T, typename Condition>
-HeapView<T, Condition>::HeapView(T* vals, size_t numVals, const Condition& heapProp)
+template <typename T, typename Condition, std::size_t Arity>
+HeapView<T, Condition, Arity>::HeapView(T* vals, size_t numVals,
+                                        const Condition& heapProp)
 : m_root{vals}, m_heapSize{numVals}, m_heapProp{heapProp}
 {
    assert((numVals > 0 && vals) || numVals == 0);
    buildHeap();
 }
 
-template <typename T, typename Condition>
+template <typename T, typename Condition, std::size_t Arity>
 template <typename Container>
-HeapView<T, Condition>::HeapView(Container& arrayLike, const Condition& heapProp)
+HeapView<T, Condition, Arity>::HeapView(Container& arrayLike, const Condition& heapProp)
 : HeapView{arrayLike.data(), arrayLike.size(), heapProp}
 {
 }
 
-template <typename T, typename Condition> const T& HeapView<T, Condition>::top() const
+template <typename T, typename Condition, std::size_t Arity>
+const T& HeapView<T, Condition, Arity>::top() const
 {
    if (empty())
       throw std::runtime_error("Cannot access top of an empty heap.");
    return m_root[0];
 }
 
-template <typename T, typename Condition> T HeapView<T, Condition>::pop()
+template <typename T, typename Condition, std::size_t Arity>
+T HeapView<T, Condition, Arity>::pop()
 {
-   if (empty())
-      throw std::runtime_error("Cannot pop from an empty heap.");
-
-   // Swap first (next one in sort order) with last element. This puts the element into
-   // its correct order. Reduce the heap size by one to exclude the now sorted last
-   // element from the data structure.
-   std::swap(m_root[0], m_root[--m_heapSize]);
-
-   // Restore the heap property for the element that got swapped into the root position.
-   heapify(1);
+   removeTop();
 
    // Return sorted element.
    return m_root[m_heapSize];
 }
 
-template <typename T, typename Condition> void HeapView<T, Condition>::set(T* vals)
+template <typename T, typename Condition, std::size_t Arity>
+void HeapView<T, Condition, Arity>::removeTop()
+{
+   if (empty())
+      throw std::runtime_error("Cannot pop from an empty heap.");
+
+   // Reduce the heap size by one to exclude the last element from the data structure.
+   // The top element (next one in sort order) moves into its place which is its correct
+   // order. The last element then gets sifted into the heap from the root position.
+   // Since it came from the bottom of the heap it most likely sinks back down to a
+   // leaf, which is the case the bottom-up variant is best at.
+   if (--m_heapSize > 0)
+   {
+      T last = std::move(m_root[m_heapSize]);
+      m_root[m_heapSize] = std::move(m_root[0]);
+      siftDownBottomUp(1, std::move(last));
+   }
+}
+
+template <typename T, typename Condition, std::size_t Arity>
+void HeapView<T, Condition, Arity>::set(T* vals)
 {
    assert((m_heapSize > 0 && vals) || m_heapSize == 0);
    m_root = vals;
 }
 
-template <typename T, typename Condition>
-void HeapView<T, Condition>::set(T* vals, size_t numVals)
+template <typename T, typename Condition, std::size_t Arity>
+void HeapView<T, Condition, Arity>::set(T* vals, size_t numVals)
 {
    assert((numVals > 0 && vals) || numVals == 0);
    m_root = vals;
    m_heapSize = numVals;
 }
 
-template <typename T, typename Condition>
-void HeapView<T, Condition>::reset(T* vals, size_t numVals)
+template <typename T, typename Condition, std::size_t Arity>
+void HeapView<T, Condition, Arity>::reset(T* vals, size_t numVals)
 {
    set(vals, numVals);
    buildHeap();
 }
 
-template <typename T, typename Condition> void HeapView<T, Condition>::buildHeap()
+template <typename T, typename Condition, std::size_t Arity>
+void HeapView<T, Condition, Arity>::buildHeap()
 {
    if (empty())
       return;
 
-   const HeapIdx lastInnerNode = size() >> 1;
+   const HeapIdx lastInnerNode = parent(size());
 
    // From bottom to top heapify all non-leaf nodes.
+   // Most of these nodes have low subtrees where the element stops early, so the
+   // top-down variant is used.
    for (HeapIdx i = lastInnerNode; i >= 1; --i)
       heapify(i);
 }
 
-template <typename Iter, typename Condition>
-void HeapView<Iter, Condition>::heapify(HeapIdx i)
+template <typename T, typename Condition, std::size_t Arity>
+void HeapView<T, Condition, Arity>::heapify(HeapIdx i)
+{
+   siftDown(i, std::move(elem(i)));
+}
+
+template <typename T, typename Condition, std::size_t Arity>
+void HeapView<T, Condition, Arity>::heapifyBottomUp(HeapIdx i)
+{
+   siftDownBottomUp(i, std::move(elem(i)));
+}
+
+template <typename T, typename Condition, std::size_t Arity>
+void HeapView<T, Condition, Arity>::heapifyUp(HeapIdx i)
+{
+   siftUp(i, 1, std::move(elem(i)));
+}
+
+template <typename T, typename Condition, std::size_t Arity>
+typename HeapView<T, Condition, Arity>::HeapIdx
+HeapView<T, Condition, Arity>::extremeChild(HeapIdx first) const
+{
+   HeapIdx extreme = first;
+
+   if (first + Arity - 1 <= size())
+   {
+      // Full family. The fixed number of siblings lets the compiler unroll the loop.
+      for (HeapIdx k = 1; k < Arity; ++k)
+         extreme = compare(first + k, extreme) ? first + k : extreme;
+   }
+   else
+   {
+      // Last family of the heap which can have fewer children.
+      for (HeapIdx c = first + 1; c <= size(); ++c)
+         extreme = compare(c, extreme) ? c : extreme;
+   }
+
+   return extreme;
+}
+
+template <typename T, typename Condition, std::size_t Arity>
+void HeapView<T, Condition, Arity>::siftDown(HeapIdx hole, T val)
+{
+   // Move the most-extreme child element up into the hole as long as it is more extreme
+   // than the value. Note that the heap-property condition is inverted below by
+   // reversing the order of the passed elements, i.e. the child element is the first
+   // parameter.
+   HeapIdx child = firstChild(hole);
+   while (child <= size())
+   {
+      child = extremeChild(child);
+      if (!m_heapProp(elem(child), val))
+         break;
+
+      elem(hole) = std::move(elem(child));
+      hole = child;
+      child = firstChild(hole);
+   }
+
+   elem(hole) = std::move(val);
+}
+
+template <typename T, typename Condition, std::size_t Arity>
+void HeapView<T, Condition, Arity>::siftDownBottomUp(HeapIdx hole, T val)
 {
-   const HeapIdx l = left(i);
-   const HeapIdx r = right(i);
+   const HeapIdx top = hole;
+
+   // Move the hole down to a leaf along the path of most-extreme children without
+   // comparing them to the value. Saves one comparison per level.
+   HeapIdx child = firstChild(hole);
+   while (child <= size())
+   {
+      child = extremeChild(child);
+      elem(hole) = std::move(elem(child));
+      hole = child;
+      child = firstChild(hole);
+   }
 
-   // Swap element at given index with the most-extrem child element (if any).
-   // Note that the heap-property condition is inverted below by reversing the order of
-   // the passed elements, i.e. the child element is the first parameter.
-   HeapIdx largest = i;
-   if (l <= size() && compare(l, i))
-      largest = l;
-   if (r <= size() && compare(r, largest))
-      largest = r;
+   siftUp(hole, top, std::move(val));
+}
 
-   if (largest != i)
+template <typename T, typename Condition, std::size_t Arity>
+void HeapView<T, Condition, Arity>::siftUp(HeapIdx hole, HeapIdx top, T val)
+{
+   while (hole > top)
    {
-      exchange(i, largest);
-      heapify(largest);
+      const HeapIdx p = parent(hole);
+      if (!m_heapProp(val, elem(p)))
+         break;
+
+      elem(hole) = std::move(elem(p));
+      hole = p;
    }
+
+   elem(hole) = std::move(val);
 }
 
 } // namespace ds
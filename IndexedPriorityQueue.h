@@ -0,0 +1,312 @@
+#pragma once
+#include "Heap.h"
+#include <cstddef>
+#include <functional>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace ds
+{
+
+///////////////////
+
+// Priority queue of handles ordered by priorities that can be changed and removed
+// after insertion, e.g. for Dijkstra's algorithm or rescheduling timers.
+// Handles are small non-negative integers chosen by the caller, e.g. vertex indices.
+// The queue keeps a map from each handle to the heap node of its entry. The map is
+// indexed by handle, so its memory is proportional to the largest inserted handle.
+// Each handle can be in the queue only once.
+template <typename Prio, typename Criterium = std::less<Prio>, std::size_t Arity = 2>
+class IndexedPriorityQueue
+{
+ public:
+   using Handle = std::size_t;
+
+   struct Entry
+   {
+      Prio prio;
+      Handle handle;
+   };
+
+ public:
+   IndexedPriorityQueue();
+   explicit IndexedPriorityQueue(const Criterium& crit);
+   IndexedPriorityQueue(const IndexedPriorityQueue& other);
+   IndexedPriorityQueue(IndexedPriorityQueue&& other) noexcept;
+   ~IndexedPriorityQueue() = default;
+
+   IndexedPriorityQueue& operator=(const IndexedPriorityQueue& other);
+   IndexedPriorityQueue& operator=(IndexedPriorityQueue&& other) noexcept;
+
+   std::size_t size() const noexcept { return m_heap.size(); }
+   bool empty() const noexcept { return m_heap.empty(); }
+   bool contains(Handle handle) const noexcept;
+
+   // Entry with the top priority.
+   const Entry& top() const { return m_heap.top(); }
+   // Priority of the given handle.
+   const Prio& priority(Handle handle) const;
+
+   Entry pop();
+   // Throws if the handle is already in the queue.
+   void insert(Handle handle, const Prio& prio);
+   // Changes the priority of the given handle. Throws if the handle is not in the queue.
+   void update(Handle handle, const Prio& prio);
+   // Removes the given handle. Throws if the handle is not in the queue.
+   void erase(Handle handle);
+   void clear() noexcept;
+
+ private:
+   // Heap condition that orders entries by their priorities.
+   struct EntryCriterium
+   {
+      bool operator()(const Entry& a, const Entry& b) const
+      {
+         return crit(a.prio, b.prio);
+      }
+
+      Criterium crit;
+   };
+
+   using Heap = HeapView<Entry, EntryCriterium, Arity>;
+   using HeapIdx = typename Heap::HeapIdx;
+
+   // Map value for handles that are not in the queue. The heap is 1-based, so no
+   // entry is at node 0.
+   static constexpr HeapIdx NotQueued = 0;
+
+   Entry& entry(HeapIdx i) { return m_storage[i - 1]; }
+   HeapIdx position(Handle handle) const;
+   // Updates the heap after the storage changed.
+   void syncHeap() { m_heap.set(m_storage.data(), m_storage.size()); }
+
+   // Swaps two entries and keeps the handle map in sync.
+   void exchange(HeapIdx a, HeapIdx b);
+   // Move the entry at the given node up or down until the heap condition holds.
+   // Return the node that the entry ends up at.
+   HeapIdx siftUp(HeapIdx i);
+   HeapIdx siftDown(HeapIdx i);
+   // Removes the entry at the given node.
+   Entry remove(HeapIdx i);
+
+ private:
+   std::vector<Entry> m_storage;
+   Heap m_heap;
+   // Heap nodes of the entries indexed by handle.
+   std::vector<HeapIdx> m_positions;
+};
+
+
+template <typename Prio, typename Criterium, std::size_t Arity>
+IndexedPriorityQueue<Prio, Criterium, Arity>::IndexedPriorityQueue()
+: m_storage{}, m_heap{m_storage}
+{
+}
+
+
+template <typename Prio, typename Criterium, std::size_t Arity>
+IndexedPriorityQueue<Prio, Criterium, Arity>::IndexedPriorityQueue(const Criterium& crit)
+: m_storage{}, m_heap{m_storage, EntryCriterium{crit}}
+{
+}
+
+
+template <typename Prio, typename Criterium, std::size_t Arity>
+IndexedPriorityQueue<Prio, Criterium, Arity>::IndexedPriorityQueue(
+   const IndexedPriorityQueue& other)
+: m_storage{other.m_storage}, m_heap{other.m_heap}, m_positions{other.m_positions}
+{
+   syncHeap();
+}
+
+
+template <typename Prio, typename Criterium, std::size_t Arity>
+IndexedPriorityQueue<Prio, Criterium, Arity>::IndexedPriorityQueue(
+   IndexedPriorityQueue&& other) noexcept
+: m_storage{std::move(other.m_storage)}, m_heap{std::as_const(other.m_heap)},
+  m_positions{std::move(other.m_positions)}
+{
+   syncHeap();
+   other.clear();
+}
+
+
+template <typename Prio, typename Criterium, std::size_t Arity>
+IndexedPriorityQueue<Prio, Criterium, Arity>&
+IndexedPriorityQueue<Prio, Criterium, Arity>::operator=(const IndexedPriorityQueue& other)
+{
+   if (this != &other)
+   {
+      m_storage = other.m_storage;
+      m_heap = other.m_heap;
+      m_positions = other.m_positions;
+      syncHeap();
+   }
+   return *this;
+}
+
+
+template <typename Prio, typename Criterium, std::size_t Arity>
+IndexedPriorityQueue<Prio, Criterium, Arity>&
+IndexedPriorityQueue<Prio, Criterium, Arity>::operator=(
+   IndexedPriorityQueue&& other) noexcept
+{
+   if (this != &other)
+   {
+      m_storage = std::move(other.m_storage);
+      m_heap = other.m_heap;
+      m_positions = std::move(other.m_positions);
+      syncHeap();
+      other.clear();
+   }
+   return *this;
+}
+
+
+template <typename Prio, typename Criterium, std::size_t Arity>
+bool IndexedPriorityQueue<Prio, Criterium, Arity>::contains(Handle handle) const noexcept
+{
+   return handle < m_positions.size() && m_positions[handle] != NotQueued;
+}
+
+
+template <typename Prio, typename Criterium, std::size_t Arity>
+const Prio& IndexedPriorityQueue<Prio, Criterium, Arity>::priority(Handle handle) const
+{
+   return m_storage[position(handle) - 1].prio;
+}
+
+
+template <typename Prio, typename Criterium, std::size_t Arity>
+typename IndexedPriorityQueue<Prio, Criterium, Arity>::Entry
+IndexedPriorityQueue<Prio, Criterium, Arity>::pop()
+{
+   if (empty())
+      throw std::runtime_error("Cannot pop from an empty priority queue.");
+   return remove(1);
+}
+
+
+template <typename Prio, typename Criterium, std::size_t Arity>
+void IndexedPriorityQueue<Prio, Criterium, Arity>::insert(Handle handle, const Prio& prio)
+{
+   if (contains(handle))
+      throw std::runtime_error("Handle is already in priority queue.");
+
+   if (handle >= m_positions.size())
+      m_positions.resize(handle + 1, NotQueued);
+
+   // Insert at end of heap.
+   m_storage.push_back(Entry{prio, handle});
+   syncHeap();
+   m_positions[handle] = size();
+
+   siftUp(size());
+}
+
+
+template <typename Prio, typename Criterium, std::size_t Arity>
+void IndexedPriorityQueue<Prio, Criterium, Arity>::update(Handle handle, const Prio& prio)
+{
+   const HeapIdx i = position(handle);
+   entry(i).prio = prio;
+
+   // The entry moves in only one direction. If it does not move up it might have to
+   // move down.
+   if (siftUp(i) == i)
+      siftDown(i);
+}
+
+
+template <typename Prio, typename Criterium, std::size_t Arity>
+void IndexedPriorityQueue<Prio, Criterium, Arity>::erase(Handle handle)
+{
+   remove(position(handle));
+}
+
+
+template <typename Prio, typename Criterium, std::size_t Arity>
+void IndexedPriorityQueue<Prio, Criterium, Arity>::clear() noexcept
+{
+   m_storage.clear();
+   m_positions.clear();
+   syncHeap();
+}
+
+
+template <typename Prio, typename Criterium, std::size_t Arity>
+typename IndexedPriorityQueue<Prio, Criterium, Arity>::HeapIdx
+IndexedPriorityQueue<Prio, Criterium, Arity>::position(Handle handle) const
+{
+   if (!contains(handle))
+      throw std::out_of_range("Handle is not in priority queue.");
+   return m_positions[handle];
+}
+
+
+template <typename Prio, typename Criterium, std::size_t Arity>
+void IndexedPriorityQueue<Prio, Criterium, Arity>::exchange(HeapIdx a, HeapIdx b)
+{
+   m_heap.exchange(a, b);
+   m_positions[entry(a).handle] = a;
+   m_positions[entry(b).handle] = b;
+}
+
+
+template <typename Prio, typename Criterium, std::size_t Arity>
+typename IndexedPriorityQueue<Prio, Criterium, Arity>::HeapIdx
+IndexedPriorityQueue<Prio, Criterium, Arity>::siftUp(HeapIdx i)
+{
+   HeapIdx parentIdx = Heap::parent(i);
+   while (i > 1 && m_heap.compare(i, parentIdx))
+   {
+      exchange(i, parentIdx);
+      i = parentIdx;
+      parentIdx = Heap::parent(i);
+   }
+   return i;
+}
+
+
+template <typename Prio, typename Criterium, std::size_t Arity>
+typename IndexedPriorityQueue<Prio, Criterium, Arity>::HeapIdx
+IndexedPriorityQueue<Prio, Criterium, Arity>::siftDown(HeapIdx i)
+{
+   HeapIdx child = Heap::firstChild(i);
+   while (child <= size())
+   {
+      child = m_heap.extremeChild(child);
+      if (!m_heap.compare(child, i))
+         break;
+
+      exchange(i, child);
+      i = child;
+      child = Heap::firstChild(i);
+   }
+   return i;
+}
+
+
+template <typename Prio, typename Criterium, std::size_t Arity>
+typename IndexedPriorityQueue<Prio, Criterium, Arity>::Entry
+IndexedPriorityQueue<Prio, Criterium, Arity>::remove(HeapIdx i)
+{
+   // Swap the entry with the last entry and remove it from the end of the heap.
+   const HeapIdx last = size();
+   if (i != last)
+      exchange(i, last);
+
+   Entry removed = std::move(m_storage.back());
+   m_storage.pop_back();
+   syncHeap();
+   m_positions[removed.handle] = NotQueued;
+
+   // Restore the heap property for the entry that got swapped into the node.
+   if (i <= size() && siftUp(i) == i)
+      siftDown(i);
+
+   return removed;
+}
+
+} // namespace ds
@@ -0,0 +1,672 @@
+#pragma once
+#include "RingBuffer.h"
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <limits>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+
+namespace ds
+{
+namespace internals
+{
+///////////////////
+
+// Read-write mapping of a whole file into memory. Changes to the mapped memory are
+// written to the file by the OS, even if the process crashes.
+class MappedFile
+{
+ public:
+   MappedFile() = default;
+   // Maps the file at the given path. For a size of zero the file has to exist and is
+   // mapped with its current size. Otherwise the file is created if needed and sized to
+   // the given size.
+   MappedFile(const std::filesystem::path& path, std::size_t size);
+   ~MappedFile();
+   MappedFile(const MappedFile&) = delete;
+   MappedFile& operator=(const MappedFile&) = delete;
+   MappedFile(MappedFile&& other) noexcept;
+   MappedFile& operator=(MappedFile&& other) noexcept;
+
+   std::byte* data() const noexcept { return m_data; }
+   std::size_t size() const noexcept { return m_size; }
+   // Blocks until the mapped memory is written to the file. Only needed to survive
+   // power losses. Process crashes don't lose the data.
+   void flush();
+
+ private:
+   void unmap() noexcept;
+
+ private:
+   std::byte* m_data = nullptr;
+   std::size_t m_size = 0;
+};
+
+
+inline MappedFile::MappedFile(const std::filesystem::path& path, std::size_t size)
+{
+   const std::string failure = "Failed to map file " + path.string() + ".";
+
+#ifdef _WIN32
+   HANDLE file = CreateFileW(path.c_str(), GENERIC_READ | GENERIC_WRITE,
+                             FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr,
+                             size > 0 ? OPEN_ALWAYS : OPEN_EXISTING,
+                             FILE_ATTRIBUTE_NORMAL, nullptr);
+   if (file == INVALID_HANDLE_VALUE)
+      throw std::runtime_error(failure);
+
+   if (size == 0)
+   {
+      LARGE_INTEGER fileSize;
+      if (GetFileSizeEx(file, &fileSize))
+         size = static_cast<std::size_t>(fileSize.QuadPart);
+   }
+
+   // The mapping grows the file to the mapped size. The view keeps the mapping and the
+   // file alive, so their handles can be closed right away.
+   HANDLE mapping = nullptr;
+   if (size > 0)
+   {
+      const auto size64 = static_cast<uint64_t>(size);
+      mapping = CreateFileMappingW(file, nullptr, PAGE_READWRITE,
+                                   static_cast<DWORD>(size64 >> 32),
+                                   static_cast<DWORD>(size64 & 0xFFFFFFFF), nullptr);
+   }
+   CloseHandle(file);
+   if (!mapping)
+      throw std::runtime_error(failure);
+
+   void* mem = MapViewOfFile(mapping, FILE_MAP_ALL_ACCESS, 0, 0, size);
+   CloseHandle(mapping);
+   if (!mem)
+      throw std::runtime_error(failure);
+#else
+   const int fd = ::open(path.c_str(), size > 0 ? O_RDWR | O_CREAT : O_RDWR, 0644);
+   if (fd < 0)
+      throw std::runtime_error(failure);
+
+   bool isSized = false;
+   if (size > 0)
+   {
+      isSized = ::ftruncate(fd, static_cast<off_t>(size)) == 0;
+   }
+   else
+   {
+      struct stat fileStat;
+      if (::fstat(fd, &fileStat) == 0)
+         size = static_cast<std::size_t>(fileStat.st_size);
+      isSized = size > 0;
+   }
+
+   // The mapping keeps the file alive, so the descriptor can be closed right away.
+   void* mem = isSized ? ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0)
+                       : MAP_FAILED;
+   ::close(fd);
+   if (mem == MAP_FAILED)
+      throw std::runtime_error(failure);
+#endif
+
+   m_data = static_cast<std::byte*>(mem);
+   m_size = size;
+}
+
+
+inline MappedFile::~MappedFile()
+{
+   unmap();
+}
+
+
+inline MappedFile::MappedFile(MappedFile&& other) noexcept
+: m_data{std::exchange(other.m_data, nullptr)}, m_size{std::exchange(other.m_size, 0)}
+{
+}
+
+
+inline MappedFile& MappedFile::operator=(MappedFile&& other) noexcept
+{
+   if (this != &other)
+   {
+      unmap();
+      m_data = std::exchange(other.m_data, nullptr);
+      m_size = std::exchange(other.m_size, 0);
+   }
+   return *this;
+}
+
+
+inline void MappedFile::flush()
+{
+   if (!m_data)
+      return;
+
+#ifdef _WIN32
+   const bool flushed = FlushViewOfFile(m_data, m_size) != 0;
+#else
+   const bool flushed = ::msync(m_data, m_size, MS_SYNC) == 0;
+#endif
+   if (!flushed)
+      throw std::runtime_error("Failed to flush mapped file.");
+}
+
+
+inline void MappedFile::unmap() noexcept
+{
+   if (!m_data)
+      return;
+
+#ifdef _WIN32
+   UnmapViewOfFile(m_data);
+#else
+   ::munmap(m_data, m_size);
+#endif
+   m_data = nullptr;
+   m_size = 0;
+}
+
+} // namespace internals
+
+
+///////////////////
+
+// Ring buffer of trivially copyable elements whose storage and positions live in a
+// memory-mapped file.
+// Will overwrite oldest elements once full. Pushing is a plain memory write without
+// system calls. The OS writes the mapped memory to the file, so the elements survive
+// crashes of the process, e.g. to keep the latest events for post-mortem diagnostics.
+// The file starts with a header that holds the capacity, the element size, a format
+// version and the positions of the first and one-past-the-last element. The elements
+// follow after the header. Opening an existing file continues with the elements in
+// it. Reading the file after a crash yields the surviving elements in order.
+// Positions are published only after the elements they cover are completely written,
+// so a crash while pushing at most loses the pushed element.
+// Accessing the same file from multiple processes at the same time is not supported.
+template <typename T> class MappedRingBuffer
+{
+   static_assert(std::is_trivially_copyable_v<T>,
+                 "Element type must be trivially copyable to be stored in a file.");
+
+   template <typename RB> friend class RingBufferConstIterator;
+   template <typename RB> friend class RingBufferIterator;
+
+ public:
+   using value_type = T;
+   using size_type = std::size_t;
+   using difference_type = int64_t;
+   using reference = T&;
+   using const_reference = const T&;
+   using pointer = T*;
+   using const_pointer = const T*;
+   using iterator = RingBufferIterator<MappedRingBuffer<T>>;
+   using const_iterator = RingBufferConstIterator<MappedRingBuffer<T>>;
+   using reverse_iterator = std::reverse_iterator<iterator>;
+   using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+   using spans = RingBufferSpans<T>;
+   using const_spans = RingBufferSpans<const T>;
+
+   // Version of the file format.
+   static constexpr uint32_t Version = 1;
+
+ public:
+   // Opens the ring buffer stored in the given file, e.g. to read the elements that
+   // survived a crash. Throws if the file does not exist or holds no ring buffer of
+   // this element type.
+   explicit MappedRingBuffer(const std::filesystem::path& path);
+   // Opens the ring buffer stored in the given file or creates the file if it does not
+   // exist. Throws if an existing file holds a ring buffer of a different capacity or
+   // element type.
+   MappedRingBuffer(const std::filesystem::path& path, size_type capacity);
+   ~MappedRingBuffer() = default;
+   MappedRingBuffer(const MappedRingBuffer&) = delete;
+   MappedRingBuffer& operator=(const MappedRingBuffer&) = delete;
+   MappedRingBuffer(MappedRingBuffer&& other) noexcept;
+   MappedRingBuffer& operator=(MappedRingBuffer&& other) noexcept;
+
+   size_type size() const noexcept;
+   size_type capacity() const noexcept;
+   bool empty() const noexcept;
+   bool full() const noexcept;
+   T& at(size_type idx);
+   const T& at(size_type idx) const;
+   T& operator[](size_type idx);
+   const T& operator[](size_type idx) const;
+   void push(const T& val);
+   // Pushes the elements as if each was pushed individually.
+   void write(std::span<const T> src);
+   void clear();
+
+   // Regions of the populated elements from oldest to newest.
+   spans readable_spans() noexcept;
+   const_spans readable_spans() const noexcept;
+
+   // Blocks until the elements are written to the file. Only needed to survive power
+   // losses or OS crashes.
+   void flush();
+
+   // Number of elements that were overwritten since opening the file or the last
+   // reset. The counter is not stored in the file.
+   uint64_t num_overwritten() const noexcept { return m_numOverwritten; }
+   void reset_counters() noexcept { m_numOverwritten = 0; }
+
+   iterator begin() noexcept;
+   iterator end() noexcept;
+   const_iterator begin() const noexcept;
+   const_iterator end() const noexcept;
+   const_iterator cbegin() const noexcept;
+   const_iterator cend() const noexcept;
+   reverse_iterator rbegin() noexcept;
+   reverse_iterator rend() noexcept;
+   const_reverse_iterator rbegin() const noexcept;
+   const_reverse_iterator rend() const noexcept;
+   const_reverse_iterator crbegin() const noexcept;
+   const_reverse_iterator crend() const noexcept;
+
+ private:
+   // Free-running position like for RingBuffer.
+   using Pos = uint64_t;
+
+   // Layout of the beginning of the file.
+   struct Header
+   {
+      uint32_t magic;
+      uint32_t version;
+      uint64_t capacity;
+      uint64_t elemSize;
+      uint64_t elemAlign;
+      // Position of the first (oldest) element.
+      Pos start;
+      // Position of the one-past-the-last element.
+      Pos end;
+   };
+
+   // Marks files that hold a ring buffer. Reads 'DSRB' in a hex dump.
+   static constexpr uint32_t Magic = 0x42525344;
+   // The elements start at this offset. Leaves room for the header to grow and keeps
+   // the elements aligned.
+   static constexpr std::size_t ElemOffset = 64;
+   static_assert(sizeof(Header) <= ElemOffset);
+   static_assert(alignof(T) <= ElemOffset,
+                 "Element alignment exceeds the alignment of the mapped storage.");
+
+   // Largest capacity whose file size can be represented.
+   static constexpr size_type MaxCapacity =
+      (std::numeric_limits<std::size_t>::max() - ElemOffset) / sizeof(T);
+
+   static std::size_t fileSize(size_type capacity) noexcept;
+   // Sets up the header of a new file.
+   void initialize(size_type capacity);
+   // Checks that the mapped file holds a valid ring buffer of the given capacity.
+   void validate(size_type capacity) const;
+   void attach();
+
+   size_type slot(Pos pos) const noexcept;
+   Pos loadPos(const Pos& pos) const noexcept;
+   void storePos(Pos& pos, Pos val) noexcept;
+   template <typename Elem>
+   RingBufferSpans<Elem> regions(Elem* storage, Pos from, size_type count) const;
+
+ private:
+   internals::MappedFile m_file;
+   Header* m_header = nullptr;
+   T* m_elems = nullptr;
+   uint64_t m_numOverwritten = 0;
+};
+
+
+template <typename T>
+MappedRingBuffer<T>::MappedRingBuffer(const std::filesystem::path& path)
+: m_file{path, 0}
+{
+   if (m_file.size() < sizeof(Header))
+      throw std::runtime_error("File does not hold a ring buffer.");
+   attach();
+   validate(m_header->capacity);
+}
+
+
+template <typename T>
+MappedRingBuffer<T>::MappedRingBuffer(const std::filesystem::path& path,
+                                      size_type capacity)
+{
+   if (capacity == 0)
+      throw std::runtime_error("Mapped ring buffer needs storage.");
+   if (capacity > MaxCapacity)
+      throw std::runtime_error("Capacity of mapped ring buffer is too large.");
+
+   std::error_code ec;
+   const bool exists = std::filesystem::file_size(path, ec) > 0 && !ec;
+   m_file = internals::MappedFile{path, exists ? 0 : fileSize(capacity)};
+   attach();
+   if (exists)
+      validate(capacity);
+   else
+      initialize(capacity);
+}
+
+
+template <typename T>
+MappedRingBuffer<T>::MappedRingBuffer(MappedRingBuffer&& other) noexcept
+: m_file{std::move(other.m_file)}, m_header{std::exchange(other.m_header, nullptr)},
+  m_elems{std::exchange(other.m_elems, nullptr)},
+  m_numOverwritten{std::exchange(other.m_numOverwritten, 0)}
+{
+}
+
+
+template <typename T>
+MappedRingBuffer<T>& MappedRingBuffer<T>::operator=(MappedRingBuffer&& other) noexcept
+{
+   if (this != &other)
+   {
+      m_file = std::move(other.m_file);
+      m_header = std::exchange(other.m_header, nullptr);
+      m_elems = std::exchange(other.m_elems, nullptr);
+      m_numOverwritten = std::exchange(other.m_numOverwritten, 0);
+   }
+   return *this;
+}
+
+
+template <typename T>
+typename MappedRingBuffer<T>::size_type MappedRingBuffer<T>::size() const noexcept
+{
+   return static_cast<size_type>(loadPos(m_header->end) - loadPos(m_header->start));
+}
+
+
+template <typename T>
+typename MappedRingBuffer<T>::size_type MappedRingBuffer<T>::capacity() const noexcept
+{
+   return static_cast<size_type>(m_header->capacity);
+}
+
+
+template <typename T> bool MappedRingBuffer<T>::empty() const noexcept
+{
+   return size() == 0;
+}
+
+
+template <typename T> bool MappedRingBuffer<T>::full() const noexcept
+{
+   return size() == capacity();
+}
+
+
+template <typename T> T& MappedRingBuffer<T>::at(size_type idx)
+{
+   if (idx >= size())
+      throw std::out_of_range("Invalid index into ring buffer.");
+   return (*this)[idx];
+}
+
+
+template <typename T> const T& MappedRingBuffer<T>::at(size_type idx) const
+{
+   if (idx >= size())
+      throw std::out_of_range("Invalid index into ring buffer.");
+   return (*this)[idx];
+}
+
+
+template <typename T> T& MappedRingBuffer<T>::operator[](size_type idx)
+{
+   return m_elems[slot(loadPos(m_header->start) + idx)];
+}
+
+
+template <typename T> const T& MappedRingBuffer<T>::operator[](size_type idx) const
+{
+   return m_elems[slot(loadPos(m_header->start) + idx)];
+}
+
+
+template <typename T> void MappedRingBuffer<T>::push(const T& val)
+{
+   write(std::span<const T>{&val, 1});
+}
+
+
+template <typename T> void MappedRingBuffer<T>::write(std::span<const T> src)
+{
+   const size_type cap = capacity();
+   // Elements that would be overwritten right away are skipped.
+   if (src.size() > cap)
+   {
+      m_numOverwritten += src.size() - cap;
+      src = src.subspan(src.size() - cap);
+   }
+
+   const Pos start = loadPos(m_header->start);
+   const Pos end = loadPos(m_header->end);
+
+   // Drop the overwritten oldest elements before overwriting them, so that a crash
+   // never leaves partially written elements inside the populated positions.
+   const Pos newEnd = end + src.size();
+   if (newEnd - start > cap)
+   {
+      m_numOverwritten += newEnd - start - cap;
+      storePos(m_header->start, newEnd - cap);
+   }
+
+   const spans dest = regions(m_elems, end, src.size());
+   std::copy_n(src.begin(), dest.first.size(), dest.first.begin());
+   std::copy(src.begin() + dest.first.size(), src.end(), dest.second.begin());
+
+   storePos(m_header->end, newEnd);
+}
+
+
+template <typename T> void MappedRingBuffer<T>::clear()
+{
+   storePos(m_header->start, loadPos(m_header->end));
+}
+
+
+template <typename T>
+typename MappedRingBuffer<T>::spans MappedRingBuffer<T>::readable_spans() noexcept
+{
+   return regions(m_elems, loadPos(m_header->start), size());
+}
+
+
+template <typename T>
+typename MappedRingBuffer<T>::const_spans
+MappedRingBuffer<T>::readable_spans() const noexcept
+{
+   return regions(static_cast<const T*>(m_elems), loadPos(m_header->start), size());
+}
+
+
+template <typename T> void MappedRingBuffer<T>::flush()
+{
+   m_file.flush();
+}
+
+
+template <typename T>
+typename MappedRingBuffer<T>::iterator MappedRingBuffer<T>::begin() noexcept
+{
+   return iterator(this, 0);
+}
+
+
+template <typename T>
+typename MappedRingBuffer<T>::iterator MappedRingBuffer<T>::end() noexcept
+{
+   return iterator(this, size());
+}
+
+
+template <typename T>
+typename MappedRingBuffer<T>::const_iterator MappedRingBuffer<T>::begin() const noexcept
+{
+   return cbegin();
+}
+
+
+template <typename T>
+typename MappedRingBuffer<T>::const_iterator MappedRingBuffer<T>::end() const noexcept
+{
+   return cend();
+}
+
+
+template <typename T>
+typename MappedRingBuffer<T>::const_iterator MappedRingBuffer<T>::cbegin() const noexcept
+{
+   return const_iterator(this, 0);
+}
+
+
+template <typename T>
+typename MappedRingBuffer<T>::const_iterator MappedRingBuffer<T>::cend() const noexcept
+{
+   return const_iterator(this, size());
+}
+
+
+template <typename T>
+typename MappedRingBuffer<T>::reverse_iterator MappedRingBuffer<T>::rbegin() noexcept
+{
+   return reverse_iterator(end());
+}
+
+
+template <typename T>
+typename MappedRingBuffer<T>::reverse_iterator MappedRingBuffer<T>::rend() noexcept
+{
+   return reverse_iterator(begin());
+}
+
+
+template <typename T>
+typename MappedRingBuffer<T>::const_reverse_iterator
+MappedRingBuffer<T>::rbegin() const noexcept
+{
+   return crbegin();
+}
+
+
+template <typename T>
+typename MappedRingBuffer<T>::const_reverse_iterator
+MappedRingBuffer<T>::rend() const noexcept
+{
+   return crend();
+}
+
+
+template <typename T>
+typename MappedRingBuffer<T>::const_reverse_iterator
+MappedRingBuffer<T>::crbegin() const noexcept
+{
+   return const_reverse_iterator(cend());
+}
+
+
+template <typename T>
+typename MappedRingBuffer<T>::const_reverse_iterator
+MappedRingBuffer<T>::crend() const noexcept
+{
+   return const_reverse_iterator(cbegin());
+}
+
+
+template <typename T>
+std::size_t MappedRingBuffer<T>::fileSize(size_type capacity) noexcept
+{
+   return ElemOffset + capacity * sizeof(T);
+}
+
+
+template <typename T> void MappedRingBuffer<T>::initialize(size_type capacity)
+{
+   m_header->magic = Magic;
+   m_header->version = Version;
+   m_header->capacity = capacity;
+   m_header->elemSize = sizeof(T);
+   m_header->elemAlign = alignof(T);
+   storePos(m_header->start, 0);
+   storePos(m_header->end, 0);
+}
+
+
+template <typename T> void MappedRingBuffer<T>::validate(size_type capacity) const
+{
+   if (m_file.size() < ElemOffset || m_header->magic != Magic)
+      throw std::runtime_error("File does not hold a ring buffer.");
+   if (m_header->version != Version)
+      throw std::runtime_error("Unsupported version of ring buffer file.");
+   if (m_header->elemSize != sizeof(T) || m_header->elemAlign != alignof(T))
+      throw std::runtime_error("Ring buffer file holds elements of a different type.");
+   if (m_header->capacity != capacity || capacity == 0)
+      throw std::runtime_error("Ring buffer file has a different capacity.");
+   // Compare against the number of elements that fit into the file instead of
+   // computing the file size for the capacity, which can overflow for corrupted
+   // headers.
+   if (capacity > (m_file.size() - ElemOffset) / sizeof(T))
+      throw std::runtime_error("Ring buffer file is truncated.");
+   if (loadPos(m_header->end) - loadPos(m_header->start) > capacity)
+      throw std::runtime_error("Ring buffer file is corrupted.");
+}
+
+
+template <typename T> void MappedRingBuffer<T>::attach()
+{
+   m_header = reinterpret_cast<Header*>(m_file.data());
+   m_elems = reinterpret_cast<T*>(m_file.data() + ElemOffset);
+}
+
+
+template <typename T>
+typename MappedRingBuffer<T>::size_type MappedRingBuffer<T>::slot(Pos pos) const noexcept
+{
+   return static_cast<size_type>(pos % m_header->capacity);
+}
+
+
+template <typename T>
+typename MappedRingBuffer<T>::Pos MappedRingBuffer<T>::loadPos(const Pos& pos) const noexcept
+{
+   return std::atomic_ref<Pos>{const_cast<Pos&>(pos)}.load(std::memory_order_acquire);
+}
+
+
+template <typename T> void MappedRingBuffer<T>::storePos(Pos& pos, Pos val) noexcept
+{
+   // The release order keeps the compiler from moving element writes after the update
+   // of the positions that cover them.
+   std::atomic_ref<Pos>{pos}.store(val, std::memory_order_release);
+}
+
+
+template <typename T>
+template <typename Elem>
+RingBufferSpans<Elem> MappedRingBuffer<T>::regions(Elem* storage, Pos from,
+                                                   size_type count) const
+{
+   const size_type startSlot = slot(from);
+   const size_type numAtEnd = std::min(count, capacity() - startSlot);
+   return {std::span<Elem>{storage + startSlot, numAtEnd},
+           std::span<Elem>{storage, count - numAtEnd}};
+}
+
+} // namespace ds
@@ -0,0 +1,501 @@
+#pragma once
+// Mirroring the storage relies on memfd_create, so the ring buffer is only available
+// on Linux.
+#ifdef __linux__
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <new>
+#include <numeric>
+#include <span>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <sys/mman.h>
+#include <unistd.h>
+
+
+namespace ds
+{
+///////////////////
+
+// Ring buffer of trivially copyable elements whose storage is mapped twice into
+// consecutive virtual memory. Element i and element i + capacity() share the same
+// physical memory, so any window of up to capacity() elements is one contiguous range
+// regardless of where it wraps around. This allows to process the elements with plain
+// pointers, memcpy or parsers without copying wrapped elements into a scratch buffer.
+// Will overwrite oldest elements once full.
+// The capacity is chosen at runtime and is rounded up, so that the storage fills whole
+// pages. Like for DynamicRingBuffer the start slot is kept wrapped.
+template <typename T> class MirroredRingBuffer
+{
+   static_assert(std::is_trivially_copyable_v<T>,
+                 "Element type must be trivially copyable to share mirrored memory.");
+
+ public:
+   using value_type = T;
+   using size_type = std::size_t;
+   using difference_type = std::ptrdiff_t;
+   using reference = T&;
+   using const_reference = const T&;
+   using pointer = T*;
+   using const_pointer = const T*;
+   // The elements are contiguous, so pointers serve as iterators.
+   using iterator = T*;
+   using const_iterator = const T*;
+   using reverse_iterator = std::reverse_iterator<iterator>;
+   using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+ public:
+   MirroredRingBuffer() = default;
+   // Creates a buffer with at least the given capacity.
+   explicit MirroredRingBuffer(size_type minCapacity);
+   ~MirroredRingBuffer();
+   MirroredRingBuffer(const MirroredRingBuffer&) = delete;
+   MirroredRingBuffer& operator=(const MirroredRingBuffer&) = delete;
+   MirroredRingBuffer(MirroredRingBuffer&& other) noexcept;
+   MirroredRingBuffer& operator=(MirroredRingBuffer&& other) noexcept;
+
+   size_type size() const noexcept;
+   size_type capacity() const noexcept;
+   bool empty() const noexcept;
+   bool full() const noexcept;
+   T& at(size_type idx);
+   const T& at(size_type idx) const;
+   T& operator[](size_type idx);
+   const T& operator[](size_type idx) const;
+   void push(const T& val);
+   // Removes the newest element.
+   T pop();
+   // Removes the oldest element.
+   T pop_front();
+   void clear() noexcept;
+   void swap(MirroredRingBuffer& other) noexcept;
+
+   // Appends the elements as if each was pushed individually, i.e. overwrites the
+   // oldest elements once full.
+   void write(std::span<const T> src);
+   // Removes the oldest elements and copies them into the given span. Returns the
+   // number of read elements.
+   size_type read(std::span<T> dest);
+
+   // Direct access to the storage.
+   // The populated elements from oldest to newest.
+   std::span<T> readable_span() noexcept;
+   std::span<const T> readable_span() const noexcept;
+   // The unpopulated slots in the order that they get populated.
+   std::span<T> writable_span() noexcept;
+   // Appends the given number of elements that were written to the writable span.
+   void commit(size_type count);
+   // Removes the given number of oldest elements, e.g. after processing them through
+   // the readable span.
+   void consume(size_type count);
+
+   // Number of elements that were overwritten since construction or the last reset.
+   uint64_t num_overwritten() const noexcept { return m_numOverwritten; }
+   void reset_counters() noexcept { m_numOverwritten = 0; }
+
+   iterator begin() noexcept;
+   iterator end() noexcept;
+   const_iterator begin() const noexcept;
+   const_iterator end() const noexcept;
+   const_iterator cbegin() const noexcept;
+   const_iterator cend() const noexcept;
+   reverse_iterator rbegin() noexcept;
+   reverse_iterator rend() noexcept;
+   const_reverse_iterator rbegin() const noexcept;
+   const_reverse_iterator rend() const noexcept;
+   const_reverse_iterator crbegin() const noexcept;
+   const_reverse_iterator crend() const noexcept;
+
+ private:
+   // Smallest number of elements that fill whole pages.
+   static size_type capacityGranularity();
+   // Maps the storage for the given capacity twice. Returns the start of the first
+   // mapping.
+   static T* mapStorage(size_type capacity);
+   static void unmapStorage(T* storage, size_type capacity) noexcept;
+
+   // Start slot after advancing by the given number of slots. Valid for advancing by up
+   // to the capacity.
+   size_type advanced(size_type count) const noexcept;
+
+ private:
+   T* m_buffer = nullptr;
+   size_type m_capacity = 0;
+   // Slot of the first (oldest) element. Always inside the first mapping.
+   size_type m_start = 0;
+   size_type m_size = 0;
+   uint64_t m_numOverwritten = 0;
+};
+
+
+template <typename T> MirroredRingBuffer<T>::MirroredRingBuffer(size_type minCapacity)
+{
+   if (minCapacity == 0)
+      return;
+
+   const size_type granularity = capacityGranularity();
+   const size_type capacity = (minCapacity + granularity - 1) / granularity * granularity;
+   m_buffer = mapStorage(capacity);
+   m_capacity = capacity;
+}
+
+
+template <typename T> MirroredRingBuffer<T>::~MirroredRingBuffer()
+{
+   unmapStorage(m_buffer, m_capacity);
+}
+
+
+template <typename T>
+MirroredRingBuffer<T>::MirroredRingBuffer(MirroredRingBuffer&& other) noexcept
+: m_buffer{std::exchange(other.m_buffer, nullptr)},
+  m_capacity{std::exchange(other.m_capacity, 0)},
+  m_start{std::exchange(other.m_start, 0)}, m_size{std::exchange(other.m_size, 0)},
+  m_numOverwritten{std::exchange(other.m_numOverwritten, 0)}
+{
+}
+
+
+template <typename T>
+MirroredRingBuffer<T>& MirroredRingBuffer<T>::operator=(MirroredRingBuffer&& other) noexcept
+{
+   if (this != &other)
+   {
+      MirroredRingBuffer moved{std::move(other)};
+      swap(moved);
+   }
+   return *this;
+}
+
+
+template <typename T>
+typename MirroredRingBuffer<T>::size_type MirroredRingBuffer<T>::size() const noexcept
+{
+   return m_size;
+}
+
+
+template <typename T>
+typename MirroredRingBuffer<T>::size_type MirroredRingBuffer<T>::capacity() const noexcept
+{
+   return m_capacity;
+}
+
+
+template <typename T> bool MirroredRingBuffer<T>::empty() const noexcept
+{
+   return m_size == 0;
+}
+
+
+template <typename T> bool MirroredRingBuffer<T>::full() const noexcept
+{
+   return m_size == m_capacity;
+}
+
+
+template <typename T> T& MirroredRingBuffer<T>::at(size_type idx)
+{
+   if (idx >= size())
+      throw std::out_of_range("Invalid index into ring buffer.");
+   return m_buffer[m_start + idx];
+}
+
+
+template <typename T> const T& MirroredRingBuffer<T>::at(size_type idx) const
+{
+   if (idx >= size())
+      throw std::out_of_range("Invalid index into ring buffer.");
+   return m_buffer[m_start + idx];
+}
+
+
+template <typename T> T& MirroredRingBuffer<T>::operator[](size_type idx)
+{
+   // Indices past the end of the first mapping land in the mirror.
+   return m_buffer[m_start + idx];
+}
+
+
+template <typename T> const T& MirroredRingBuffer<T>::operator[](size_type idx) const
+{
+   return m_buffer[m_start + idx];
+}
+
+
+template <typename T> void MirroredRingBuffer<T>::push(const T& val)
+{
+   write(std::span<const T>{&val, 1});
+}
+
+
+template <typename T> T MirroredRingBuffer<T>::pop()
+{
+   if (empty())
+      throw std::runtime_error("Popping from empty ring buffer.");
+
+   --m_size;
+   return m_buffer[m_start + m_size];
+}
+
+
+template <typename T> T MirroredRingBuffer<T>::pop_front()
+{
+   if (empty())
+      throw std::runtime_error("Popping from empty ring buffer.");
+
+   const T popped = m_buffer[m_start];
+   m_start = advanced(1);
+   --m_size;
+   return popped;
+}
+
+
+template <typename T> void MirroredRingBuffer<T>::clear() noexcept
+{
+   m_start = 0;
+   m_size = 0;
+}
+
+
+template <typename T> void MirroredRingBuffer<T>::swap(MirroredRingBuffer& other) noexcept
+{
+   std::swap(m_buffer, other.m_buffer);
+   std::swap(m_capacity, other.m_capacity);
+   std::swap(m_start, other.m_start);
+   std::swap(m_size, other.m_size);
+   std::swap(m_numOverwritten, other.m_numOverwritten);
+}
+
+
+template <typename T> void MirroredRingBuffer<T>::write(std::span<const T> src)
+{
+   // Elements that would be overwritten right away are skipped.
+   if (src.size() > m_capacity)
+   {
+      m_numOverwritten += src.size() - m_capacity;
+      src = src.subspan(src.size() - m_capacity);
+   }
+
+   // Drop the oldest elements that get overwritten.
+   const size_type numFree = m_capacity - m_size;
+   if (src.size() > numFree)
+   {
+      m_numOverwritten += src.size() - numFree;
+      consume(src.size() - numFree);
+   }
+
+   std::copy(src.begin(), src.end(), m_buffer + m_start + m_size);
+   m_size += src.size();
+}
+
+
+template <typename T>
+typename MirroredRingBuffer<T>::size_type MirroredRingBuffer<T>::read(std::span<T> dest)
+{
+   const size_type numRead = std::min(dest.size(), m_size);
+   std::copy_n(m_buffer + m_start, numRead, dest.begin());
+   consume(numRead);
+   return numRead;
+}
+
+
+template <typename T> std::span<T> MirroredRingBuffer<T>::readable_span() noexcept
+{
+   return {m_buffer + m_start, m_size};
+}
+
+
+template <typename T>
+std::span<const T> MirroredRingBuffer<T>::readable_span() const noexcept
+{
+   return {m_buffer + m_start, m_size};
+}
+
+
+template <typename T> std::span<T> MirroredRingBuffer<T>::writable_span() noexcept
+{
+   return {m_buffer + m_start + m_size, m_capacity - m_size};
+}
+
+
+template <typename T> void MirroredRingBuffer<T>::commit(size_type count)
+{
+   if (count > m_capacity - m_size)
+      throw std::out_of_range("Committing more elements than free slots in ring buffer.");
+   m_size += count;
+}
+
+
+template <typename T> void MirroredRingBuffer<T>::consume(size_type count)
+{
+   if (count > m_size)
+      throw std::out_of_range("Consuming more elements than stored in ring buffer.");
+   m_start = advanced(count);
+   m_size -= count;
+}
+
+
+template <typename T>
+typename MirroredRingBuffer<T>::iterator MirroredRingBuffer<T>::begin() noexcept
+{
+   return m_buffer + m_start;
+}
+
+
+template <typename T>
+typename MirroredRingBuffer<T>::iterator MirroredRingBuffer<T>::end() noexcept
+{
+   return m_buffer + m_start + m_size;
+}
+
+
+template <typename T>
+typename MirroredRingBuffer<T>::const_iterator MirroredRingBuffer<T>::begin() const noexcept
+{
+   return cbegin();
+}
+
+
+template <typename T>
+typename MirroredRingBuffer<T>::const_iterator MirroredRingBuffer<T>::end() const noexcept
+{
+   return cend();
+}
+
+
+template <typename T>
+typename MirroredRingBuffer<T>::const_iterator
+MirroredRingBuffer<T>::cbegin() const noexcept
+{
+   return m_buffer + m_start;
+}
+
+
+template <typename T>
+typename MirroredRingBuffer<T>::const_iterator MirroredRingBuffer<T>::cend() const noexcept
+{
+   return m_buffer + m_start + m_size;
+}
+
+
+template <typename T>
+typename MirroredRingBuffer<T>::reverse_iterator MirroredRingBuffer<T>::rbegin() noexcept
+{
+   return reverse_iterator(end());
+}
+
+
+template <typename T>
+typename MirroredRingBuffer<T>::reverse_iterator MirroredRingBuffer<T>::rend() noexcept
+{
+   return reverse_iterator(begin());
+}
+
+
+template <typename T>
+typename MirroredRingBuffer<T>::const_reverse_iterator
+MirroredRingBuffer<T>::rbegin() const noexcept
+{
+   return crbegin();
+}
+
+
+template <typename T>
+typename MirroredRingBuffer<T>::const_reverse_iterator
+MirroredRingBuffer<T>::rend() const noexcept
+{
+   return crend();
+}
+
+
+template <typename T>
+typename MirroredRingBuffer<T>::const_reverse_iterator
+MirroredRingBuffer<T>::crbegin() const noexcept
+{
+   return const_reverse_iterator(cend());
+}
+
+
+template <typename T>
+typename MirroredRingBuffer<T>::const_reverse_iterator
+MirroredRingBuffer<T>::crend() const noexcept
+{
+   return const_reverse_iterator(cbegin());
+}
+
+
+template <typename T>
+typename MirroredRingBuffer<T>::size_type MirroredRingBuffer<T>::capacityGranularity()
+{
+   const auto pageSize = static_cast<size_type>(::sysconf(_SC_PAGESIZE));
+   return std::lcm(pageSize, sizeof(T)) / sizeof(T);
+}
+
+
+template <typename T> T* MirroredRingBuffer<T>::mapStorage(size_type capacity)
+{
+   const size_type numBytes = capacity * sizeof(T);
+   if (numBytes / sizeof(T) != capacity)
+      throw std::bad_alloc();
+
+   // Anonymous file whose pages get mapped twice.
+   const int fd = ::memfd_create("dscpp_mirrored_ring_buffer", MFD_CLOEXEC);
+   if (fd < 0)
+      throw std::runtime_error("Failed to create memory for mirrored ring buffer.");
+   if (::ftruncate(fd, static_cast<off_t>(numBytes)) != 0)
+   {
+      ::close(fd);
+      throw std::bad_alloc();
+   }
+
+   // Reserve the address range for both mappings first, so that no other mapping can
+   // end up between them.
+   void* reserved = ::mmap(nullptr, 2 * numBytes, PROT_NONE,
+                           MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+   if (reserved == MAP_FAILED)
+   {
+      ::close(fd);
+      throw std::bad_alloc();
+   }
+
+   auto* base = static_cast<std::byte*>(reserved);
+   const bool isMapped =
+      ::mmap(base, numBytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd, 0) !=
+         MAP_FAILED &&
+      ::mmap(base + numBytes, numBytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED,
+             fd, 0) != MAP_FAILED;
+   // The mappings keep the memory alive.
+   ::close(fd);
+   if (!isMapped)
+   {
+      ::munmap(reserved, 2 * numBytes);
+      throw std::runtime_error("Failed to mirror memory for ring buffer.");
+   }
+
+   return reinterpret_cast<T*>(base);
+}
+
+
+template <typename T>
+void MirroredRingBuffer<T>::unmapStorage(T* storage, size_type capacity) noexcept
+{
+   if (storage)
+      ::munmap(storage, 2 * capacity * sizeof(T));
+}
+
+
+template <typename T>
+typename MirroredRingBuffer<T>::size_type
+MirroredRingBuffer<T>::advanced(size_type count) const noexcept
+{
+   const size_type start = m_start + count;
+   return (start >= m_capacity) ? start - m_capacity : start;
+}
+
+} // namespace ds
+
+#endif // __linux__
@@ -0,0 +1,363 @@
+#pragma once
+#include "Concurrency.h"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+
+
+namespace ds
+{
+///////////////////
+
+// Bounded lock-free queue of fixed size N for any number of producer and consumer
+// threads.
+// Follows Dmitry Vyukov's design. Each slot of the fixed-size storage carries a
+// sequence number that tells which position of the queue may use the slot next and
+// whether it holds an element. Position pos maps to slot pos % N in round pos / N:
+// - seq == 2 * round:     The slot is free for the producer of position pos.
+// - seq == 2 * round + 1: The slot holds the element of position pos.
+// After popping, the consumer sets the sequence to 2 * round + 2, which frees the slot
+// for the next round. Encoding the round instead of the position also supports N = 1.
+// Producers and consumers only contend on the two position counters. Everything else
+// is synchronized through the slots that they own.
+//
+// The try functions fail immediately if the queue is full or empty. The timed
+// functions retry until the timeout expires. The blocking functions draw a ticket
+// for their position and wait until its slot is ready, which avoids repeated failing
+// compare-exchange operations under high contention. Waiting spins briefly and then
+// yields the thread.
+// Like SpscRingBuffer, pushing into a full queue never overwrites elements.
+template <typename T, std::size_t N> class MpmcRingBuffer
+{
+   static_assert(std::is_default_constructible_v<T>,
+                 "Element type must be default-constructible.");
+   static_assert(std::is_move_assignable_v<T>, "Element type must be move-assignable.");
+   static_assert(N > 0, "Zero-sized queue is not supported.");
+
+ private:
+   using Index = std::size_t;
+
+   struct Slot
+   {
+      std::atomic<Index> seq = 0;
+      T value{};
+   };
+
+   using BufferType = std::array<Slot, N>;
+
+ public:
+   using value_type = T;
+   using size_type = std::size_t;
+   using reference = T&;
+   using const_reference = const T&;
+   using pointer = T*;
+   using const_pointer = const T*;
+
+ public:
+   MpmcRingBuffer() = default;
+   ~MpmcRingBuffer() = default;
+   MpmcRingBuffer(const MpmcRingBuffer&) = delete;
+   MpmcRingBuffer& operator=(const MpmcRingBuffer&) = delete;
+   MpmcRingBuffer(MpmcRingBuffer&&) = delete;
+   MpmcRingBuffer& operator=(MpmcRingBuffer&&) = delete;
+
+   // The state functions only give a snapshot while other threads modify the queue.
+   size_type size() const noexcept;
+   constexpr size_type capacity() const noexcept;
+   bool empty() const noexcept;
+   bool full() const noexcept;
+
+   // Waits until there is space.
+   void push(const T& val);
+   void push(T&& val);
+   // Returns false if the queue is full.
+   bool try_push(const T& val);
+   bool try_push(T&& val);
+   // Returns false if the queue stays full for the given time.
+   template <typename Rep, typename Period>
+   bool try_push_for(const T& val, const std::chrono::duration<Rep, Period>& timeout);
+   template <typename Rep, typename Period>
+   bool try_push_for(T&& val, const std::chrono::duration<Rep, Period>& timeout);
+   // Number of elements that the try functions rejected because the queue was full.
+   // Elements that are pushed again after being rejected are counted again.
+   uint64_t num_dropped() const noexcept;
+
+   // Waits until there is an element.
+   T pop();
+   // Returns false if the queue is empty.
+   bool try_pop(T& val);
+   // Returns false if the queue stays empty for the given time.
+   template <typename Rep, typename Period>
+   bool try_pop_for(T& val, const std::chrono::duration<Rep, Period>& timeout);
+
+ private:
+   Slot& slotAt(Index pos) noexcept { return m_buffer[pos % N]; }
+   // Sequence number of a slot that is free for the producer of the given position.
+   static constexpr Index freeSeq(Index pos) noexcept { return 2 * (pos / N); }
+   // Sequence number of a slot that holds the element of the given position.
+   static constexpr Index populatedSeq(Index pos) noexcept { return freeSeq(pos) + 1; }
+   // Signed difference between two counter values.
+   static std::ptrdiff_t signedDiff(Index a, Index b) noexcept;
+
+   template <typename U> void pushValue(U&& val);
+   template <typename U> bool tryPushValue(U&& val);
+   template <typename U, typename Rep, typename Period>
+   bool tryPushValueFor(U&& val, const std::chrono::duration<Rep, Period>& timeout);
+   // Counts a rejected element. Returns whether the element was pushed.
+   bool countIfDropped(bool isPushed) noexcept;
+
+ private:
+   // Position of the next pushed element.
+   alignas(internals::CacheLineSize) std::atomic<Index> m_pushPos = 0;
+   // Position of the next popped element.
+   alignas(internals::CacheLineSize) std::atomic<Index> m_popPos = 0;
+   alignas(internals::CacheLineSize) BufferType m_buffer;
+   // Only updated when pushing fails, so it does not slow down successful pushes.
+   alignas(internals::CacheLineSize) std::atomic<uint64_t> m_numDropped = 0;
+};
+
+
+template <typename T, std::size_t N>
+typename MpmcRingBuffer<T, N>::size_type MpmcRingBuffer<T, N>::size() const noexcept
+{
+   const Index popPos = m_popPos.load(std::memory_order_acquire);
+   const Index pushPos = m_pushPos.load(std::memory_order_acquire);
+   // Blocked consumers can draw positions ahead of the pushed elements and blocked
+   // producers positions beyond the capacity.
+   const std::ptrdiff_t diff = signedDiff(pushPos, popPos);
+   if (diff < 0)
+      return 0;
+   return std::min(static_cast<size_type>(diff), N);
+}
+
+
+template <typename T, std::size_t N>
+constexpr typename MpmcRingBuffer<T, N>::size_type
+MpmcRingBuffer<T, N>::capacity() const noexcept
+{
+   return N;
+}
+
+
+template <typename T, std::size_t N> bool MpmcRingBuffer<T, N>::empty() const noexcept
+{
+   return size() == 0;
+}
+
+
+template <typename T, std::size_t N> bool MpmcRingBuffer<T, N>::full() const noexcept
+{
+   return size() == N;
+}
+
+
+template <typename T, std::size_t N> void MpmcRingBuffer<T, N>::push(const T& val)
+{
+   pushValue(val);
+}
+
+
+template <typename T, std::size_t N> void MpmcRingBuffer<T, N>::push(T&& val)
+{
+   pushValue(std::move(val));
+}
+
+
+template <typename T, std::size_t N> bool MpmcRingBuffer<T, N>::try_push(const T& val)
+{
+   return countIfDropped(tryPushValue(val));
+}
+
+
+template <typename T, std::size_t N> bool MpmcRingBuffer<T, N>::try_push(T&& val)
+{
+   return countIfDropped(tryPushValue(std::move(val)));
+}
+
+
+template <typename T, std::size_t N>
+template <typename Rep, typename Period>
+bool MpmcRingBuffer<T, N>::try_push_for(const T& val,
+                                        const std::chrono::duration<Rep, Period>& timeout)
+{
+   return countIfDropped(tryPushValueFor(val, timeout));
+}
+
+
+template <typename T, std::size_t N>
+template <typename Rep, typename Period>
+bool MpmcRingBuffer<T, N>::try_push_for(T&& val,
+                                        const std::chrono::duration<Rep, Period>& timeout)
+{
+   return countIfDropped(tryPushValueFor(std::move(val), timeout));
+}
+
+
+template <typename T, std::size_t N>
+uint64_t MpmcRingBuffer<T, N>::num_dropped() const noexcept
+{
+   return m_numDropped.load(std::memory_order_relaxed);
+}
+
+
+template <typename T, std::size_t N> T MpmcRingBuffer<T, N>::pop()
+{
+   const Index pos = m_popPos.fetch_add(1, std::memory_order_relaxed);
+   Slot& slot = slotAt(pos);
+
+   internals::Backoff backoff;
+   while (slot.seq.load(std::memory_order_acquire) != populatedSeq(pos))
+      backoff.pause();
+
+   T popped = std::move(slot.value);
+   // Frees the slot for the next round.
+   slot.seq.store(freeSeq(pos + N), std::memory_order_release);
+   return popped;
+}
+
+
+template <typename T, std::size_t N> bool MpmcRingBuffer<T, N>::try_pop(T& val)
+{
+   Index pos = m_popPos.load(std::memory_order_relaxed);
+   for (;;)
+   {
+      Slot& slot = slotAt(pos);
+      const std::ptrdiff_t offset =
+         signedDiff(slot.seq.load(std::memory_order_acquire), populatedSeq(pos));
+
+      if (offset == 0)
+      {
+         // The slot holds the element of this position. Claim it, unless another
+         // consumer was faster. A failed exchange loads the current position.
+         if (m_popPos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+         {
+            val = std::move(slot.value);
+            slot.seq.store(freeSeq(pos + N), std::memory_order_release);
+            return true;
+         }
+      }
+      else if (offset < 0)
+      {
+         // The slot was not populated for this position yet.
+         return false;
+      }
+      else
+      {
+         // Another consumer already popped this position.
+         pos = m_popPos.load(std::memory_order_relaxed);
+      }
+   }
+}
+
+
+template <typename T, std::size_t N>
+template <typename Rep, typename Period>
+bool MpmcRingBuffer<T, N>::try_pop_for(T& val,
+                                       const std::chrono::duration<Rep, Period>& timeout)
+{
+   const auto deadline = std::chrono::steady_clock::now() + timeout;
+   internals::Backoff backoff;
+   while (!try_pop(val))
+   {
+      if (std::chrono::steady_clock::now() >= deadline)
+         return false;
+      backoff.pause();
+   }
+   return true;
+}
+
+
+template <typename T, std::size_t N>
+std::ptrdiff_t MpmcRingBuffer<T, N>::signedDiff(Index a, Index b) noexcept
+{
+   // Interpreting the difference as signed value keeps the comparison correct when the
+   // counters wrap around.
+   return static_cast<std::ptrdiff_t>(a - b);
+}
+
+
+template <typename T, std::size_t N>
+template <typename U>
+void MpmcRingBuffer<T, N>::pushValue(U&& val)
+{
+   const Index pos = m_pushPos.fetch_add(1, std::memory_order_relaxed);
+   Slot& slot = slotAt(pos);
+
+   // Wait for the consumer of the previous round to free the slot.
+   internals::Backoff backoff;
+   while (slot.seq.load(std::memory_order_acquire) != freeSeq(pos))
+      backoff.pause();
+
+   slot.value = std::forward<U>(val);
+   slot.seq.store(populatedSeq(pos), std::memory_order_release);
+}
+
+
+template <typename T, std::size_t N>
+template <typename U>
+bool MpmcRingBuffer<T, N>::tryPushValue(U&& val)
+{
+   Index pos = m_pushPos.load(std::memory_order_relaxed);
+   for (;;)
+   {
+      Slot& slot = slotAt(pos);
+      const std::ptrdiff_t offset =
+         signedDiff(slot.seq.load(std::memory_order_acquire), freeSeq(pos));
+
+      if (offset == 0)
+      {
+         // The slot is free for this position. Claim it, unless another producer was
+         // faster. A failed exchange loads the current position.
+         if (m_pushPos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+         {
+            slot.value = std::forward<U>(val);
+            slot.seq.store(populatedSeq(pos), std::memory_order_release);
+            return true;
+         }
+      }
+      else if (offset < 0)
+      {
+         // The slot still holds the element of the previous round.
+         return false;
+      }
+      else
+      {
+         // Another producer already populated this position.
+         pos = m_pushPos.load(std::memory_order_relaxed);
+      }
+   }
+}
+
+
+template <typename T, std::size_t N>
+template <typename U, typename Rep, typename Period>
+bool MpmcRingBuffer<T, N>::tryPushValueFor(
+   U&& val, const std::chrono::duration<Rep, Period>& timeout)
+{
+   const auto deadline = std::chrono::steady_clock::now() + timeout;
+   internals::Backoff backoff;
+   // The value is only moved from once pushing succeeds.
+   while (!tryPushValue(std::forward<U>(val)))
+   {
+      if (std::chrono::steady_clock::now() >= deadline)
+         return false;
+      backoff.pause();
+   }
+   return true;
+}
+
+
+template <typename T, std::size_t N>
+bool MpmcRingBuffer<T, N>::countIfDropped(bool isPushed) noexcept
+{
+   if (!isPushed)
+      m_numDropped.fetch_add(1, std::memory_order_relaxed);
+   return isPushed;
+}
+
+} // namespace ds
@@ -4,9 +4,12 @@
 //
 #pragma once
 #include "Heap.h"
+#include <bit>
+#include <cstddef>
 #include <functional>
 #include <initializer_list>
 #include <stdexcept>
+#include <utility>
 #include <vector>
 
 namespace ds
@@ -15,7 +18,10 @@ namespace ds
 ///////////////////
 
 // Priority queue that orders elements based on a given criterium.
-template <typename T, typename Criterium = std::less<T>> class PriorityQueue
+// The arity of the underlying heap can be raised, e.g. to 4, to make operations on
+// large queues cause fewer cache misses.
+template <typename T, typename Criterium = std::less<T>, std::size_t Arity = 2>
+class PriorityQueue
 {
  public:
    PriorityQueue();
@@ -24,77 +30,167 @@ template <typename T, typename Criterium = std::less<T>> class PriorityQueue
    PriorityQueue(std::initializer_list<T> ilist, const Criterium& crit);
    template <typename Iter> PriorityQueue(Iter first, Iter last);
    template <typename Iter> PriorityQueue(Iter first, Iter last, const Criterium& crit);
+   PriorityQueue(const PriorityQueue& other);
+   PriorityQueue(PriorityQueue&& other) noexcept;
+   ~PriorityQueue() = default;
+
+   PriorityQueue& operator=(const PriorityQueue& other);
+   PriorityQueue& operator=(PriorityQueue&& other) noexcept;
 
    size_t size() const noexcept { return m_heap.size(); }
    bool empty() const noexcept { return m_heap.empty(); }
    const T& top() const { return m_heap.top(); }
-   T pop() { return m_heap.pop(); }
-   void insert(const T& val);
+   // Moves the top element out of the queue.
+   T pop();
+   void insert(const T& val) { emplace(val); }
+   void insert(T&& val) { emplace(std::move(val)); }
+   template <typename... Args> void emplace(Args&&... args);
+   // Inserts a sequence of elements. Rebuilds the heap in linear time if that is
+   // cheaper than inserting the elements one by one, i.e. for large sequences.
+   template <typename Iter> void insert_range(Iter first, Iter last);
+
+ private:
+   using Heap = HeapView<T, Criterium, Arity>;
+
+   // Updates the heap after the storage changed.
+   void syncHeap() { m_heap.set(m_storage.data(), m_storage.size()); }
 
  private:
    std::vector<T> m_storage;
-   HeapView<T, Criterium> m_heap;
+   Heap m_heap;
 };
 
-template <typename T, typename Criterium>
-PriorityQueue<T, Criterium>::PriorityQueue() : m_storage{}, m_heap{m_storage}
+template <typename T, typename Criterium, std::size_t Arity>
+PriorityQueue<T, Criterium, Arity>::PriorityQueue() : m_storage{}, m_heap{m_storage}
 {
 }
 
-template <typename T, typename Criterium>
-PriorityQueue<T, Criterium>::PriorityQueue(const Criterium& crit)
+template <typename T, typename Criterium, std::size_t Arity>
+PriorityQueue<T, Criterium, Arity>::PriorityQueue(const Criterium& crit)
 : m_storage{}, m_heap{m_storage, crit}
 {
 }
 
-template <typename T, typename Criterium>
-PriorityQueue<T, Criterium>::PriorityQueue(std::initializer_list<T> ilist)
+template <typename T, typename Criterium, std::size_t Arity>
+PriorityQueue<T, Criterium, Arity>::PriorityQueue(std::initializer_list<T> ilist)
 : m_storage{ilist}, m_heap{m_storage}
 {
 }
 
-template <typename T, typename Criterium>
-PriorityQueue<T, Criterium>::PriorityQueue(std::initializer_list<T> ilist,
-                                         const Criterium& crit)
+template <typename T, typename Criterium, std::size_t Arity>
+PriorityQueue<T, Criterium, Arity>::PriorityQueue(std::initializer_list<T> ilist,
+                                                  const Criterium& crit)
 : m_storage{ilist}, m_heap{m_storage, crit}
 {
 }
 
-template <typename T, typename Criterium>
+template <typename T, typename Criterium, std::size_t Arity>
 template <typename Iter>
-PriorityQueue<T, Criterium>::PriorityQueue(Iter first, Iter last)
+PriorityQueue<T, Criterium, Arity>::PriorityQueue(Iter first, Iter last)
 : m_storage{first, last}, m_heap{m_storage}
 {
 }
 
-template <typename T, typename Criterium>
+template <typename T, typename Criterium, std::size_t Arity>
 template <typename Iter>
-PriorityQueue<T, Criterium>::PriorityQueue(Iter first, Iter last, const Criterium& crit)
+PriorityQueue<T, Criterium, Arity>::PriorityQueue(Iter first, Iter last,
+                                                  const Criterium& crit)
 : m_storage{first, last}, m_heap{m_storage, crit}
 {
 }
 
-template <typename T, typename Criterium>
-void PriorityQueue<T, Criterium>::insert(const T& val)
+template <typename T, typename Criterium, std::size_t Arity>
+PriorityQueue<T, Criterium, Arity>::PriorityQueue(const PriorityQueue& other)
+: m_storage{other.m_storage}, m_heap{other.m_heap}
 {
-   // Since the heap can shrink below the capacity of the storage when elements are
-   // removed, we might have unused space. If not resize the storage.
-   if (m_storage.size() == m_heap.size())
-      m_storage.resize(m_storage.size() + 1);
+   syncHeap();
+}
 
-   // Insert at end of heap.
-   m_storage[m_heap.size()] = val;
-   m_heap.set(m_storage.data(), m_heap.size() + 1);
+template <typename T, typename Criterium, std::size_t Arity>
+PriorityQueue<T, Criterium, Arity>::PriorityQueue(PriorityQueue&& other) noexcept
+: m_storage{std::move(other.m_storage)}, m_heap{std::as_const(other.m_heap)}
+{
+   syncHeap();
+   other.m_storage.clear();
+   other.syncHeap();
+}
+
+template <typename T, typename Criterium, std::size_t Arity>
+PriorityQueue<T, Criterium, Arity>&
+PriorityQueue<T, Criterium, Arity>::operator=(const PriorityQueue& other)
+{
+   if (this != &other)
+   {
+      m_storage = other.m_storage;
+      m_heap = other.m_heap;
+      syncHeap();
+   }
+   return *this;
+}
+
+template <typename T, typename Criterium, std::size_t Arity>
+PriorityQueue<T, Criterium, Arity>&
+PriorityQueue<T, Criterium, Arity>::operator=(PriorityQueue&& other) noexcept
+{
+   if (this != &other)
+   {
+      m_storage = std::move(other.m_storage);
+      m_heap = other.m_heap;
+      syncHeap();
+      other.m_storage.clear();
+      other.syncHeap();
+   }
+   return *this;
+}
+
+template <typename T, typename Criterium, std::size_t Arity>
+T PriorityQueue<T, Criterium, Arity>::pop()
+{
+   // The heap moves the top element right behind itself which is the end of the
+   // storage.
+   m_heap.removeTop();
+   T top = std::move(m_storage.back());
+   m_storage.pop_back();
+   return top;
+}
+
+template <typename T, typename Criterium, std::size_t Arity>
+template <typename... Args>
+void PriorityQueue<T, Criterium, Arity>::emplace(Args&&... args)
+{
+   // Insert at end of heap. The storage always has the size of the heap, so the
+   // element is constructed in place without default-constructing it first.
+   m_storage.emplace_back(std::forward<Args>(args)...);
+   syncHeap();
 
    // Move new element up in heap until the heap property is fulfilled.
-   using HeapIdx = HeapView<T, Criterium>::HeapIdx;
-   HeapIdx i = m_heap.size();
-   HeapIdx parentIdx = HeapView<T, Criterium>::parent(i);
-   while (i > 1 && m_heap.compare(i, parentIdx))
+   m_heap.heapifyUp(m_heap.size());
+}
+
+template <typename T, typename Criterium, std::size_t Arity>
+template <typename Iter>
+void PriorityQueue<T, Criterium, Arity>::insert_range(Iter first, Iter last)
+{
+   const size_t oldSize = m_storage.size();
+   m_storage.insert(m_storage.end(), first, last);
+   const size_t newSize = m_storage.size();
+   const size_t numAdded = newSize - oldSize;
+
+   // Rebuilding takes about two comparisons per element of the whole heap. Inserting
+   // the new elements one by one takes up to one comparison per level for each of
+   // them.
+   const size_t numLevels = std::bit_width(newSize) / std::bit_width(Arity - 1);
+   if (numAdded * numLevels > 2 * newSize)
+   {
+      m_heap.reset(m_storage.data(), newSize);
+   }
+   else
    {
-      m_heap.exchange(i, parentIdx);
-      i = parentIdx;
-      parentIdx = HeapView<T, Criterium>::parent(i);
+      for (size_t i = oldSize + 1; i <= newSize; ++i)
+      {
+         m_heap.set(m_storage.data(), i);
+         m_heap.heapifyUp(i);
+      }
    }
 }
 
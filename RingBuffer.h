@@ -1,5 +1,5 @@
 #pragma once
-#include <array>
+#include <algorithm>
 #include <cassert>
 #include <cmath>
 #include <cstdint>
@@ -7,6 +7,10 @@
 #include <exception>
 #include <initializer_list>
 #include <iterator>
+#include <memory>
+#include <span>
+#include <type_traits>
+#include <utility>
 #include <vector>
 #include <stdexcept>
 
@@ -15,41 +19,197 @@ namespace ds
 {
 ///////////////////
 
+// Contiguous regions of a ring buffer's storage. The second region continues the
+// first one after wrapping around to the beginning of the storage. It is empty if
+// the regions don't wrap.
+template <typename T> struct RingBufferSpans
+{
+   std::span<T> first;
+   std::span<T> second;
+
+   std::size_t size() const noexcept { return first.size() + second.size(); }
+   bool empty() const noexcept { return size() == 0; }
+};
+
+
+///////////////////
+
+// What a ring buffer does with pushed elements once it is full.
+enum class OverflowPolicy
+{
+   // Overwrites the oldest elements. Keeps the newest elements, e.g. for telemetry.
+   Overwrite,
+   // Rejects the pushed elements. Keeps the oldest elements, e.g. for queues.
+   Reject
+};
+
+
+///////////////////
+
+namespace internals
+{
+// Wrap and overflow logic shared by the ring buffers with a fixed and a runtime
+// capacity. Works on slots of the storage and takes the capacity as a runtime value,
+// so it does not depend on how a buffer tracks its start and end.
+
+// Regions of a storage with the given capacity that hold the given number of slots
+// starting at the given slot.
+template <typename Elem>
+RingBufferSpans<Elem> ringRegions(Elem* storage, std::size_t capacity,
+                                  std::size_t fromSlot, std::size_t count)
+{
+   assert(count <= capacity);
+   const std::size_t numAtEnd = std::min(count, capacity - fromSlot);
+   return {std::span<Elem>{storage + fromSlot, numAtEnd},
+           std::span<Elem>{storage, count - numAtEnd}};
+}
+
+
+// What happens when pushing elements into a ring buffer. The buffer applies the plan
+// in the order of the members.
+struct RingPushPlan
+{
+   // Oldest elements of the buffer that get overwritten. A single overwritten element
+   // can be reused by assigning the pushed element to it, e.g. to keep the memory of
+   // strings.
+   std::size_t numOverwritten = 0;
+   // Leading pushed elements that would be overwritten right away. They are not
+   // copied but still advance the end, so the buffer is populated the same way as
+   // when pushing the elements one after the other. The skipped slots stay empty,
+   // because all elements of the buffer are overwritten in that case.
+   std::size_t numSkipped = 0;
+   // Pushed elements that are copied into the buffer.
+   std::size_t numCopied = 0;
+   // Pushed elements that are rejected.
+   std::size_t numDropped = 0;
+
+   // Number of elements that count as pushed. Overwritten elements count as pushed.
+   std::size_t numPushed() const noexcept { return numSkipped + numCopied; }
+};
+
+
+template <OverflowPolicy Policy>
+RingPushPlan planRingPush(std::size_t count, std::size_t size,
+                          std::size_t capacity) noexcept
+{
+   assert(size <= capacity);
+   RingPushPlan plan;
+   if (capacity == 0)
+   {
+      // Without storage the pushed elements are dropped right away.
+      plan.numDropped = count;
+   }
+   else if constexpr (Policy == OverflowPolicy::Reject)
+   {
+      // Only the elements that fit are pushed.
+      plan.numCopied = std::min(count, capacity - size);
+      plan.numDropped = count - plan.numCopied;
+   }
+   else
+   {
+      plan.numSkipped = (count > capacity) ? count - capacity : 0;
+      plan.numCopied = count - plan.numSkipped;
+      plan.numOverwritten =
+         (size + plan.numCopied > capacity) ? size + plan.numCopied - capacity : 0;
+   }
+   return plan;
+}
+
+
+// Copies the elements into the uninitialized regions. Leaves the regions
+// uninitialized if copying throws.
+template <typename Iter, typename T>
+void uninitializedCopyToRegions(Iter first, const RingBufferSpans<T>& dest)
+{
+   T* copiedEnd = std::uninitialized_copy_n(first, dest.first.size(), dest.first.data());
+   try
+   {
+      std::advance(first, dest.first.size());
+      std::uninitialized_copy_n(first, dest.second.size(), dest.second.data());
+   }
+   catch (...)
+   {
+      std::destroy(dest.first.data(), copiedEnd);
+      throw;
+   }
+}
+
+
+// Moves the elements out of the regions in their order in the buffer.
+template <typename T, typename OutIter>
+OutIter moveFromRegions(const RingBufferSpans<T>& src, OutIter out)
+{
+   out = std::move(src.first.begin(), src.first.end(), out);
+   return std::move(src.second.begin(), src.second.end(), out);
+}
+
+
+// Moves the elements out of the regions in reverse order, i.e. newest first.
+template <typename T, typename OutIter>
+OutIter moveFromRegionsReversed(const RingBufferSpans<T>& src, OutIter out)
+{
+   out = std::move(src.second.rbegin(), src.second.rend(), out);
+   return std::move(src.first.rbegin(), src.first.rend(), out);
+}
+
+
+template <typename T> void destroyRegions(const RingBufferSpans<T>& populated) noexcept
+{
+   if constexpr (!std::is_trivially_destructible_v<T>)
+   {
+      std::destroy(populated.first.begin(), populated.first.end());
+      std::destroy(populated.second.begin(), populated.second.end());
+   }
+}
+
+} // namespace internals
+
+
+///////////////////
+
 // Ring buffer of fixed size N.
-// Will overwrite oldest elements once full.
-template <typename T, std::size_t N> class RingBuffer
+// Once full, the overflow policy decides whether pushing overwrites the oldest elements
+// or fails. The buffer counts the overwritten and the rejected elements, so that drop
+// rates can be monitored.
+// The start and end positions are free-running 64-bit counters that are mapped to
+// slots of the internal storage only when accessing elements. The size is the plain
+// difference of the counters and full and empty buffers are told apart without a
+// sentinel slot. Choose a power of two for N to map positions with a bit mask instead
+// of a modulo operation.
+// The storage is uninitialized. Elements are constructed when they are pushed and
+// destroyed when they are removed, so element types don't need to be
+// default-constructible and unused slots cost nothing.
+template <typename T, std::size_t N, OverflowPolicy Policy = OverflowPolicy::Overwrite>
+class RingBuffer
 {
    template <typename RB> friend class RingBufferConstIterator;
    template <typename RB> friend class RingBufferIterator;
 
- private:
-   // The internal std::array has one additional element that serves as one-past-the-end
-   // position.
-   static constexpr std::size_t M = N + 1;
-   using BufferType = std::array<T, M>;
-
  public:
    using value_type = T;
-   using size_type = typename BufferType::size_type;
+   using size_type = std::size_t;
    using difference_type = int64_t;
    using reference = T&;
    using const_reference = const T&;
    using pointer = T*;
    using const_pointer = const T*;
-   using iterator = RingBufferIterator<RingBuffer<T, N>>;
-   using const_iterator = RingBufferConstIterator<RingBuffer<T, N>>;
+   using iterator = RingBufferIterator<RingBuffer<T, N, Policy>>;
+   using const_iterator = RingBufferConstIterator<RingBuffer<T, N, Policy>>;
    using reverse_iterator = std::reverse_iterator<iterator>;
    using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+   using spans = RingBufferSpans<T>;
+   using const_spans = RingBufferSpans<const T>;
 
  public:
    RingBuffer() = default;
-   ~RingBuffer() = default;
+   ~RingBuffer();
    template <typename Iter> RingBuffer(Iter first, Iter last);
    RingBuffer(std::initializer_list<T> ilist);
-   RingBuffer(const RingBuffer&) = default;
-   RingBuffer& operator=(const RingBuffer&) = default;
-   RingBuffer(RingBuffer&& from) = default;
-   RingBuffer& operator=(RingBuffer&& from) = default;
+   RingBuffer(const RingBuffer& other);
+   RingBuffer& operator=(const RingBuffer& other);
+   RingBuffer(RingBuffer&& other) noexcept(std::is_nothrow_move_constructible_v<T>);
+   RingBuffer& operator=(RingBuffer&& other) noexcept(
+      std::is_nothrow_move_constructible_v<T>);
 
    size_type size() const noexcept;
    constexpr size_type capacity() const noexcept;
@@ -59,11 +219,53 @@ template <typename T, std::size_t N> class RingBuffer
    const T& at(size_type idx) const;
    T& operator[](size_type idx);
    const T& operator[](size_type idx) const;
-   void push(const T& val);
+   // Returns false if the element was rejected.
+   bool push(const T& val);
+   bool push(T&& val);
+   // Pushes an element constructed in place from the given arguments. Returns the new
+   // element. Throws if the element is rejected.
+   template <typename... Args> T& emplace(Args&&... args);
+   // Removes the newest element.
    T pop();
+   // Removes the oldest element.
+   T pop_front();
    void clear();
    void swap(RingBuffer& other);
 
+   // Bulk operations that copy elements in at most two contiguous chunks.
+   // Pushes the given number of elements as if each was pushed individually. Returns
+   // the number of elements that were not rejected.
+   template <typename Iter> size_type push_n(Iter first, size_type count);
+   // Pops up to the given number of elements as if each was popped individually, i.e.
+   // the newest element is written first. Returns the number of popped elements.
+   template <typename OutIter> size_type pop_n(OutIter out, size_type count);
+   // Appends the elements like push_n.
+   size_type write(std::span<const T> src);
+   // Removes the oldest elements and writes them into the given span in their
+   // order in the buffer. Returns the number of read elements.
+   size_type read(std::span<T> dest);
+
+   // Direct access to the storage, e.g. to pass it to writev.
+   // Regions of the populated elements from oldest to newest.
+   spans readable_spans() noexcept;
+   const_spans readable_spans() const noexcept;
+   // Regions of the unpopulated slots in the order that they get populated.
+   // The slots hold no constructed elements. Only available for trivially copyable
+   // element types that can be written into raw memory.
+   spans writable_spans() noexcept;
+   // Appends the given number of elements that were written to the writable spans.
+   void commit(size_type count);
+   // Removes the given number of oldest elements, e.g. after processing them through
+   // the readable spans.
+   void consume(size_type count);
+
+   // Number of elements that were overwritten since construction or the last reset.
+   uint64_t num_overwritten() const noexcept { return m_numOverwritten; }
+   // Number of pushed elements that were rejected since construction or the last
+   // reset.
+   uint64_t num_dropped() const noexcept { return m_numDropped; }
+   void reset_counters() noexcept;
+
    iterator begin() noexcept;
    iterator end() noexcept;
    const_iterator begin() const noexcept;
@@ -78,282 +280,567 @@ template <typename T, std::size_t N> class RingBuffer
    const_reverse_iterator crend() const noexcept;
 
  private:
-   using Index = size_type;
-
-   // Index of last populated (newest) element. End-index if the ring buffer is
-   // empty.
-   Index last() const;
+   // Free-running position. Does not overflow in practice.
+   using Pos = uint64_t;
+
+   static constexpr bool IsPow2Size = N > 0 && (N & (N - 1)) == 0;
+
+   // Maps a position to the index of its slot in the internal storage.
+   static constexpr size_type slot(Pos pos) noexcept;
+   T* storage() noexcept;
+   const T* storage() const noexcept;
+   template <typename U> bool pushValue(U&& val);
+   // Copies or moves the elements and counters of the other buffer into this empty
+   // buffer. The elements keep their positions, so that they are transferred in at most
+   // two chunks.
+   template <typename Other> void populateFrom(Other&& other);
+   // Destroys the elements at the given number of positions.
+   void destroy(Pos from, size_type count) noexcept;
+   // Regions of the storage that hold the given number of positions.
+   template <typename Elem>
+   static RingBufferSpans<Elem> regions(Elem* storage, Pos from, size_type count);
 
  private:
-   BufferType m_buffer;
-   // Index of the first (oldest) element.
-   Index m_start = 0;
-   // Index of the one-past-the-last element.
-   Index m_end = 0;
+   // Raw storage for the elements. Only slots between the start and end positions
+   // hold constructed elements.
+   std::aligned_storage_t<sizeof(T), alignof(T)> m_buffer[N > 0 ? N : 1];
+   // Position of the first (oldest) element.
+   Pos m_start = 0;
+   // Position of the one-past-the-last element.
+   Pos m_end = 0;
+   uint64_t m_numOverwritten = 0;
+   uint64_t m_numDropped = 0;
 };
 
 
 ///////////////////
 
-namespace internals
+template <typename T, std::size_t N, OverflowPolicy Policy>
+RingBuffer<T, N, Policy>::~RingBuffer()
 {
+   destroy(m_start, size());
+}
 
-// Modulus N addition.
-inline constexpr int64_t addModN(int64_t val, int64_t offset, std::size_t n) noexcept
+
+template <typename T, std::size_t N, OverflowPolicy Policy>
+template <typename Iter>
+RingBuffer<T, N, Policy>::RingBuffer(Iter first, Iter last)
+// Delegate to the default ctor, so that the dtor destroys the already populated
+// elements when populating throws.
+: RingBuffer<T, N, Policy>()
 {
-   assert(n > 0);
-   return (val + offset) % n;
+   push_n(first, static_cast<size_type>(std::distance(first, last)));
 }
 
-// Modulus N subtraction.
-inline constexpr int64_t subModN(int64_t val, int64_t offset, std::size_t n) noexcept
+
+template <typename T, std::size_t N, OverflowPolicy Policy>
+RingBuffer<T, N, Policy>::RingBuffer(std::initializer_list<T> ilist)
+: RingBuffer<T, N, Policy>(ilist.begin(), ilist.end())
 {
-   assert(n > 0);
-   return (val - offset) % n;
 }
 
-} // namespace internals
 
+template <typename T, std::size_t N, OverflowPolicy Policy>
+RingBuffer<T, N, Policy>::RingBuffer(const RingBuffer& other)
+: RingBuffer<T, N, Policy>()
+{
+   populateFrom(other);
+}
 
-///////////////////
 
-template <typename T, std::size_t N>
-template <typename Iter>
-RingBuffer<T, N>::RingBuffer(Iter first, Iter last)
+template <typename T, std::size_t N, OverflowPolicy Policy>
+RingBuffer<T, N, Policy>& RingBuffer<T, N, Policy>::operator=(const RingBuffer& other)
 {
-   const auto inputSize = std::distance(first, last);
-   const auto copySize = std::min<std::size_t>(inputSize, N);
-
-   if (inputSize <= N)
+   if (this != &other)
    {
-      // Simple case - Fill buffer from beginning.
-      std::copy_n(first, copySize, m_buffer.begin());
-      m_start = 0;
-      m_end = copySize;
+      clear();
+      populateFrom(other);
    }
-   else
-   {
-      // If not all input elements fit into the buffer, populate the
-      // buffer as if the elements were added one after the other. This
-      // avoid having different internal layouts for equivalent situation
-      // (initialization with all elements vs pushing the same elements
-      // one after the other).
-      Iter srcStart = first;
-      std::advance(srcStart, inputSize - N);
-      const size_type numWrapped = inputSize % N;
-      const size_type numAtEnd = copySize - numWrapped;
+   return *this;
+}
 
-      std::copy_n(srcStart, numAtEnd, m_buffer.begin() + M - numAtEnd);
-      std::advance(srcStart, numAtEnd);
-      std::copy_n(srcStart, numWrapped, m_buffer.begin());
 
-      m_start = M - numAtEnd;
-      m_end = numWrapped;
-   }
+template <typename T, std::size_t N, OverflowPolicy Policy>
+RingBuffer<T, N, Policy>::RingBuffer(RingBuffer&& other) noexcept(
+   std::is_nothrow_move_constructible_v<T>)
+: RingBuffer<T, N, Policy>()
+{
+   populateFrom(std::move(other));
+   other.clear();
 }
 
 
-template <typename T, std::size_t N>
-RingBuffer<T, N>::RingBuffer(std::initializer_list<T> ilist)
-: RingBuffer<T, N>(ilist.begin(), ilist.end())
+template <typename T, std::size_t N, OverflowPolicy Policy>
+RingBuffer<T, N, Policy>&
+RingBuffer<T, N, Policy>::operator=(RingBuffer&& other) noexcept(
+   std::is_nothrow_move_constructible_v<T>)
 {
+   if (this != &other)
+   {
+      clear();
+      populateFrom(std::move(other));
+      other.clear();
+   }
+   return *this;
 }
 
 
-template <typename T, std::size_t N>
-typename RingBuffer<T, N>::size_type RingBuffer<T, N>::size() const noexcept
+template <typename T, std::size_t N, OverflowPolicy Policy>
+typename RingBuffer<T, N, Policy>::size_type
+RingBuffer<T, N, Policy>::size() const noexcept
 {
-   // Make sure the end is larger than the start index to avoid multiple cases.
-   return internals::subModN(m_end + M, m_start, M);
+   return static_cast<size_type>(m_end - m_start);
 }
 
 
-template <typename T, std::size_t N>
-constexpr typename RingBuffer<T, N>::size_type RingBuffer<T, N>::capacity() const noexcept
+template <typename T, std::size_t N, OverflowPolicy Policy>
+constexpr typename RingBuffer<T, N, Policy>::size_type
+RingBuffer<T, N, Policy>::capacity() const noexcept
 {
    return N;
 }
 
 
-template <typename T, std::size_t N> bool RingBuffer<T, N>::empty() const noexcept
+template <typename T, std::size_t N, OverflowPolicy Policy>
+bool RingBuffer<T, N, Policy>::empty() const noexcept
 {
    return (m_start == m_end);
 }
 
 
-template <typename T, std::size_t N> bool RingBuffer<T, N>::full() const noexcept
+template <typename T, std::size_t N, OverflowPolicy Policy>
+bool RingBuffer<T, N, Policy>::full() const noexcept
 {
    return (size() == N);
 }
 
 
-template <typename T, std::size_t N> T& RingBuffer<T, N>::at(size_type idx)
+template <typename T, std::size_t N, OverflowPolicy Policy>
+T& RingBuffer<T, N, Policy>::at(size_type idx)
 {
    if (idx >= size())
       throw std::out_of_range("Invalid index into ring buffer.");
-   return m_buffer[internals::addModN(m_start, idx, M)];
+   return storage()[slot(m_start + idx)];
 }
 
 
-template <typename T, std::size_t N> const T& RingBuffer<T, N>::at(size_type idx) const
+template <typename T, std::size_t N, OverflowPolicy Policy>
+const T& RingBuffer<T, N, Policy>::at(size_type idx) const
 {
    if (idx >= size())
       throw std::out_of_range("Invalid index into ring buffer.");
-   return m_buffer[internals::addModN(m_start, idx, M)];
+   return storage()[slot(m_start + idx)];
+}
+
+
+template <typename T, std::size_t N, OverflowPolicy Policy>
+T& RingBuffer<T, N, Policy>::operator[](size_type idx)
+{
+   return storage()[slot(m_start + idx)];
+}
+
+
+template <typename T, std::size_t N, OverflowPolicy Policy>
+const T& RingBuffer<T, N, Policy>::operator[](size_type idx) const
+{
+   return storage()[slot(m_start + idx)];
 }
 
 
-template <typename T, std::size_t N> T& RingBuffer<T, N>::operator[](size_type idx)
+template <typename T, std::size_t N, OverflowPolicy Policy>
+bool RingBuffer<T, N, Policy>::push(const T& val)
 {
-   return m_buffer[internals::addModN(m_start, idx, M)];
+   return pushValue(val);
 }
 
 
-template <typename T, std::size_t N>
-const T& RingBuffer<T, N>::operator[](size_type idx) const
+template <typename T, std::size_t N, OverflowPolicy Policy>
+bool RingBuffer<T, N, Policy>::push(T&& val)
 {
-   return m_buffer[internals::addModN(m_start, idx, M)];
+   return pushValue(std::move(val));
 }
 
 
-template <typename T, std::size_t N> void RingBuffer<T, N>::push(const T& val)
+template <typename T, std::size_t N, OverflowPolicy Policy>
+template <typename... Args>
+T& RingBuffer<T, N, Policy>::emplace(Args&&... args)
 {
-   // The pushed value always goes into the slot indicated by the
-   // end index.
-   m_buffer[m_end] = val;
+   static_assert(N > 0, "Emplacing into ring buffer without storage.");
 
-   if (full())
+   const internals::RingPushPlan plan = internals::planRingPush<Policy>(1, size(), N);
+   if (plan.numDropped > 0)
    {
-      // Get rid of first (oldest) element.
-      m_end = m_start;
-      m_start = internals::addModN(m_start, 1, M);
+      ++m_numDropped;
+      throw std::runtime_error("Emplacing into full ring buffer.");
    }
-   else
+   if (plan.numOverwritten > 0)
    {
-      m_end = internals::addModN(m_end, 1, M);
+      // The arguments might refer to the oldest element, so construct the new
+      // element before dropping the oldest one.
+      T elem(std::forward<Args>(args)...);
+      std::destroy_at(storage() + slot(m_start));
+      ++m_start;
+      ++m_numOverwritten;
+      T* added = std::construct_at(storage() + slot(m_end), std::move(elem));
+      ++m_end;
+      return *added;
    }
+
+   T* added = std::construct_at(storage() + slot(m_end), std::forward<Args>(args)...);
+   ++m_end;
+   return *added;
+}
+
+
+template <typename T, std::size_t N, OverflowPolicy Policy>
+T RingBuffer<T, N, Policy>::pop()
+{
+   if (empty())
+      throw std::runtime_error("Popping from empty ring buffer.");
+
+   T* last = storage() + slot(m_end - 1);
+   T popped = std::move(*last);
+   std::destroy_at(last);
+   --m_end;
+   return popped;
 }
 
 
-template <typename T, std::size_t N> T RingBuffer<T, N>::pop()
+template <typename T, std::size_t N, OverflowPolicy Policy>
+T RingBuffer<T, N, Policy>::pop_front()
 {
    if (empty())
       throw std::runtime_error("Popping from empty ring buffer.");
 
-   const Index lastIdx = last();
-   T popped = m_buffer[lastIdx];
-   m_end = lastIdx;
+   T* first = storage() + slot(m_start);
+   T popped = std::move(*first);
+   std::destroy_at(first);
+   ++m_start;
    return popped;
 }
 
 
-template <typename T, std::size_t N> void RingBuffer<T, N>::clear()
+template <typename T, std::size_t N, OverflowPolicy Policy>
+void RingBuffer<T, N, Policy>::clear()
 {
+   destroy(m_start, size());
    m_start = 0;
    m_end = 0;
 }
 
 
-template <typename T, std::size_t N> void RingBuffer<T, N>::swap(RingBuffer& other)
+template <typename T, std::size_t N, OverflowPolicy Policy>
+void RingBuffer<T, N, Policy>::swap(RingBuffer& other)
+{
+   if (this == &other)
+      return;
+
+   RingBuffer tmp{std::move(other)};
+   other = std::move(*this);
+   *this = std::move(tmp);
+}
+
+
+template <typename T, std::size_t N, OverflowPolicy Policy>
+template <typename Iter>
+typename RingBuffer<T, N, Policy>::size_type
+RingBuffer<T, N, Policy>::push_n(Iter first, size_type count)
+{
+   const internals::RingPushPlan plan = internals::planRingPush<Policy>(count, size(), N);
+   m_numDropped += plan.numDropped;
+   consume(plan.numOverwritten);
+   m_numOverwritten += plan.numOverwritten + plan.numSkipped;
+   if (plan.numSkipped > 0)
+   {
+      std::advance(first, plan.numSkipped);
+      m_end += plan.numSkipped;
+      m_start = m_end;
+   }
+
+   internals::uninitializedCopyToRegions(first,
+                                         regions(storage(), m_end, plan.numCopied));
+   m_end += plan.numCopied;
+   return plan.numPushed();
+}
+
+
+template <typename T, std::size_t N, OverflowPolicy Policy>
+template <typename OutIter>
+typename RingBuffer<T, N, Policy>::size_type
+RingBuffer<T, N, Policy>::pop_n(OutIter out, size_type count)
+{
+   const size_type numPopped = std::min(count, size());
+   const spans src = regions(storage(), m_end - numPopped, numPopped);
+   internals::moveFromRegionsReversed(src, out);
+   destroy(m_end - numPopped, numPopped);
+   m_end -= numPopped;
+   return numPopped;
+}
+
+
+template <typename T, std::size_t N, OverflowPolicy Policy>
+typename RingBuffer<T, N, Policy>::size_type
+RingBuffer<T, N, Policy>::write(std::span<const T> src)
+{
+   return push_n(src.begin(), src.size());
+}
+
+
+template <typename T, std::size_t N, OverflowPolicy Policy>
+typename RingBuffer<T, N, Policy>::size_type
+RingBuffer<T, N, Policy>::read(std::span<T> dest)
+{
+   const size_type numRead = std::min(dest.size(), size());
+   internals::moveFromRegions(regions(storage(), m_start, numRead), dest.begin());
+   consume(numRead);
+   return numRead;
+}
+
+
+template <typename T, std::size_t N, OverflowPolicy Policy>
+typename RingBuffer<T, N, Policy>::spans
+RingBuffer<T, N, Policy>::readable_spans() noexcept
+{
+   return regions(storage(), m_start, size());
+}
+
+
+template <typename T, std::size_t N, OverflowPolicy Policy>
+typename RingBuffer<T, N, Policy>::const_spans
+RingBuffer<T, N, Policy>::readable_spans() const noexcept
+{
+   return regions(storage(), m_start, size());
+}
+
+
+template <typename T, std::size_t N, OverflowPolicy Policy>
+typename RingBuffer<T, N, Policy>::spans
+RingBuffer<T, N, Policy>::writable_spans() noexcept
 {
-   std::swap(m_buffer, other.m_buffer);
-   std::swap(m_start, other.m_start);
-   std::swap(m_end, other.m_end);
+   static_assert(std::is_trivially_copyable_v<T>,
+                 "Writing into raw slots requires trivially copyable elements.");
+   return regions(storage(), m_end, N - size());
 }
 
 
-template <typename T, std::size_t N>
-typename RingBuffer<T, N>::iterator RingBuffer<T, N>::begin() noexcept
+template <typename T, std::size_t N, OverflowPolicy Policy>
+void RingBuffer<T, N, Policy>::commit(size_type count)
+{
+   static_assert(std::is_trivially_copyable_v<T>,
+                 "Writing into raw slots requires trivially copyable elements.");
+   if (count > N - size())
+      throw std::out_of_range("Committing more elements than free slots in ring buffer.");
+   m_end += count;
+}
+
+
+template <typename T, std::size_t N, OverflowPolicy Policy>
+void RingBuffer<T, N, Policy>::consume(size_type count)
+{
+   if (count > size())
+      throw std::out_of_range("Consuming more elements than stored in ring buffer.");
+   destroy(m_start, count);
+   m_start += count;
+}
+
+
+template <typename T, std::size_t N, OverflowPolicy Policy>
+void RingBuffer<T, N, Policy>::reset_counters() noexcept
+{
+   m_numOverwritten = 0;
+   m_numDropped = 0;
+}
+
+
+template <typename T, std::size_t N, OverflowPolicy Policy>
+typename RingBuffer<T, N, Policy>::iterator RingBuffer<T, N, Policy>::begin() noexcept
 {
    return iterator(this, 0);
 }
 
 
-template <typename T, std::size_t N>
-typename RingBuffer<T, N>::iterator RingBuffer<T, N>::end() noexcept
+template <typename T, std::size_t N, OverflowPolicy Policy>
+typename RingBuffer<T, N, Policy>::iterator RingBuffer<T, N, Policy>::end() noexcept
 {
    return iterator(this, size());
 }
 
 
-template <typename T, std::size_t N>
-typename RingBuffer<T, N>::const_iterator RingBuffer<T, N>::begin() const noexcept
+template <typename T, std::size_t N, OverflowPolicy Policy>
+typename RingBuffer<T, N, Policy>::const_iterator
+RingBuffer<T, N, Policy>::begin() const noexcept
 {
    return cbegin();
 }
 
 
-template <typename T, std::size_t N>
-typename RingBuffer<T, N>::const_iterator RingBuffer<T, N>::end() const noexcept
+template <typename T, std::size_t N, OverflowPolicy Policy>
+typename RingBuffer<T, N, Policy>::const_iterator
+RingBuffer<T, N, Policy>::end() const noexcept
 {
    return cend();
 }
 
 
-template <typename T, std::size_t N>
-typename RingBuffer<T, N>::const_iterator RingBuffer<T, N>::cbegin() const noexcept
+template <typename T, std::size_t N, OverflowPolicy Policy>
+typename RingBuffer<T, N, Policy>::const_iterator
+RingBuffer<T, N, Policy>::cbegin() const noexcept
 {
    return const_iterator(this, 0);
 }
 
 
-template <typename T, std::size_t N>
-typename RingBuffer<T, N>::const_iterator RingBuffer<T, N>::cend() const noexcept
+template <typename T, std::size_t N, OverflowPolicy Policy>
+typename RingBuffer<T, N, Policy>::const_iterator
+RingBuffer<T, N, Policy>::cend() const noexcept
 {
    return const_iterator(this, size());
 }
 
 
-template <typename T, std::size_t N>
-typename RingBuffer<T, N>::reverse_iterator RingBuffer<T, N>::rbegin() noexcept
+template <typename T, std::size_t N, OverflowPolicy Policy>
+typename RingBuffer<T, N, Policy>::reverse_iterator
+RingBuffer<T, N, Policy>::rbegin() noexcept
 {
    return reverse_iterator(end());
 }
 
 
-template <typename T, std::size_t N>
-typename RingBuffer<T, N>::reverse_iterator RingBuffer<T, N>::rend() noexcept
+template <typename T, std::size_t N, OverflowPolicy Policy>
+typename RingBuffer<T, N, Policy>::reverse_iterator
+RingBuffer<T, N, Policy>::rend() noexcept
 {
    return reverse_iterator(begin());
 }
 
 
-template <typename T, std::size_t N>
-typename RingBuffer<T, N>::const_reverse_iterator RingBuffer<T, N>::rbegin() const
-   noexcept
+template <typename T, std::size_t N, OverflowPolicy Policy>
+typename RingBuffer<T, N, Policy>::const_reverse_iterator
+RingBuffer<T, N, Policy>::rbegin() const noexcept
 {
    return crbegin();
 }
 
 
-template <typename T, std::size_t N>
-typename RingBuffer<T, N>::const_reverse_iterator RingBuffer<T, N>::rend() const noexcept
+template <typename T, std::size_t N, OverflowPolicy Policy>
+typename RingBuffer<T, N, Policy>::const_reverse_iterator
+RingBuffer<T, N, Policy>::rend() const noexcept
 {
    return crend();
 }
 
 
-template <typename T, std::size_t N>
-typename RingBuffer<T, N>::const_reverse_iterator RingBuffer<T, N>::crbegin() const
-   noexcept
+template <typename T, std::size_t N, OverflowPolicy Policy>
+typename RingBuffer<T, N, Policy>::const_reverse_iterator
+RingBuffer<T, N, Policy>::crbegin() const noexcept
 {
    return const_reverse_iterator(cend());
 }
 
 
-template <typename T, std::size_t N>
-typename RingBuffer<T, N>::const_reverse_iterator RingBuffer<T, N>::crend() const noexcept
+template <typename T, std::size_t N, OverflowPolicy Policy>
+typename RingBuffer<T, N, Policy>::const_reverse_iterator
+RingBuffer<T, N, Policy>::crend() const noexcept
 {
    return const_reverse_iterator(cbegin());
 }
 
 
-template <typename T, std::size_t N>
-typename RingBuffer<T, N>::Index RingBuffer<T, N>::last() const
+template <typename T, std::size_t N, OverflowPolicy Policy>
+constexpr typename RingBuffer<T, N, Policy>::size_type
+RingBuffer<T, N, Policy>::slot(Pos pos) noexcept
 {
-   if (empty())
-      return m_end;
-   return internals::subModN(m_end, 1, M);
+   if constexpr (IsPow2Size)
+      return static_cast<size_type>(pos & (N - 1));
+   else if constexpr (N > 0)
+      return static_cast<size_type>(pos % N);
+   else
+      return 0;
+}
+
+
+template <typename T, std::size_t N, OverflowPolicy Policy>
+T* RingBuffer<T, N, Policy>::storage() noexcept
+{
+   return reinterpret_cast<T*>(m_buffer);
+}
+
+
+template <typename T, std::size_t N, OverflowPolicy Policy>
+const T* RingBuffer<T, N, Policy>::storage() const noexcept
+{
+   return reinterpret_cast<const T*>(m_buffer);
+}
+
+
+template <typename T, std::size_t N, OverflowPolicy Policy>
+template <typename U>
+bool RingBuffer<T, N, Policy>::pushValue(U&& val)
+{
+   const internals::RingPushPlan plan = internals::planRingPush<Policy>(1, size(), N);
+   if (plan.numDropped > 0)
+   {
+      ++m_numDropped;
+      return false;
+   }
+
+   // Without storage the value was dropped. Don't instantiate emplace in that case.
+   if constexpr (N > 0)
+   {
+      if constexpr (std::is_assignable_v<T&, U&&>)
+      {
+         if (plan.numOverwritten > 0)
+         {
+            // Reuse the oldest element.
+            storage()[slot(m_end)] = std::forward<U>(val);
+            ++m_end;
+            ++m_start;
+            ++m_numOverwritten;
+            return true;
+         }
+      }
+      emplace(std::forward<U>(val));
+   }
+   return true;
+}
+
+
+template <typename T, std::size_t N, OverflowPolicy Policy>
+template <typename Other>
+void RingBuffer<T, N, Policy>::populateFrom(Other&& other)
+{
+   assert(empty());
+   m_start = other.m_start;
+   m_end = other.m_start;
+   m_numOverwritten = other.m_numOverwritten;
+   m_numDropped = other.m_numDropped;
+
+   const auto src = other.readable_spans();
+   for (const auto& region : {src.first, src.second})
+   {
+      T* dest = storage() + slot(m_end);
+      if constexpr (std::is_rvalue_reference_v<Other&&>)
+         std::uninitialized_move(region.begin(), region.end(), dest);
+      else
+         std::uninitialized_copy(region.begin(), region.end(), dest);
+      m_end += region.size();
+   }
+}
+
+
+template <typename T, std::size_t N, OverflowPolicy Policy>
+void RingBuffer<T, N, Policy>::destroy(Pos from, size_type count) noexcept
+{
+   internals::destroyRegions(regions(storage(), from, count));
+}
+
+
+template <typename T, std::size_t N, OverflowPolicy Policy>
+template <typename Elem>
+RingBufferSpans<Elem> RingBuffer<T, N, Policy>::regions(Elem* storage, Pos from,
+                                                        size_type count)
+{
+   return internals::ringRegions(storage, N, slot(from), count);
 }
 
 
@@ -362,7 +849,9 @@ typename RingBuffer<T, N>::Index RingBuffer<T, N>::last() const
 // Const iterator for ring buffer. Does not allow changing elements.
 template <typename RB> class RingBufferConstIterator
 {
-   template <typename T, std::size_t N> friend class RingBuffer;
+   template <typename T, std::size_t N, OverflowPolicy P> friend class RingBuffer;
+   template <typename T, OverflowPolicy P, typename Alloc> friend class DynamicRingBuffer;
+   template <typename T> friend class MappedRingBuffer;
 
  public:
    using iterator_category = std::random_access_iterator_tag;
@@ -555,7 +1044,9 @@ RingBufferConstIterator<RB>::operator-=(const difference_type offset)
 // const iterators can also be called with non-const iterators.
 template <typename RB> class RingBufferIterator : public RingBufferConstIterator<RB>
 {
-   template <typename T, std::size_t N> friend class RingBuffer;
+   template <typename T, std::size_t N, OverflowPolicy P> friend class RingBuffer;
+   template <typename T, OverflowPolicy P, typename Alloc> friend class DynamicRingBuffer;
+   template <typename T> friend class MappedRingBuffer;
 
  public:
    using iterator_category = std::random_access_iterator_tag;
@@ -4,18 +4,32 @@
 #define VS_COMPILER
 #endif
 
+#include "AlignedAllocator.h"
 #include "TypeTraitsEx.h"
 #include <algorithm>
+#ifdef SBOVEC_MEM_INSTR
+#include <array>
+#include <atomic>
+#include <bit>
+#endif // SBOVEC_MEM_INSTR
 #include <cassert>
+#include <cstdint>
 #include <cstdlib>
+#include <cstring>
 #include <iterator>
-#ifdef VS_COMPILER
-#include <malloc.h>
-#endif
 #include <memory>
+#include <memory_resource>
+#include <ranges>
 #include <stdexcept>
 #include <type_traits>
 
+// Allows empty allocators to not occupy any space in the vector.
+#ifdef VS_COMPILER
+#define SBOVEC_NO_UNIQUE_ADDRESS [[msvc::no_unique_address]]
+#else
+#define SBOVEC_NO_UNIQUE_ADDRESS [[no_unique_address]]
+#endif
+
 
 namespace ds
 {
@@ -25,6 +39,113 @@ template <typename T, std::size_t N> class SboVectorIterator;
 template <typename T, std::size_t N> class SboVectorConstIterator;
 
 
+///////////////////
+
+#ifdef SBOVEC_MEM_INSTR
+
+// Memory statistics collected for all instances of an SboVector type.
+struct SboVectorMemStats
+{
+   // Number of peak size buckets. Bucket 0 counts vectors that never held elements,
+   // bucket i (i > 0) counts vectors with peak sizes in [2^(i-1), 2^i).
+   static constexpr std::size_t NumPeakSizeBuckets = 65;
+
+   // Heap capacity (in elements) that is currently allocated.
+   int64_t allocatedCapacity = 0;
+   // Number of heap allocations and deallocations.
+   int64_t numAllocations = 0;
+   int64_t numDeallocations = 0;
+   // Number of times elements were moved from one heap allocation to another.
+   int64_t numReallocations = 0;
+   // Number of times vectors moved their data from the buffer onto the heap.
+   int64_t numSpills = 0;
+   // Number of times vectors moved their data from the heap back into the buffer.
+   int64_t numReturns = 0;
+   // Histogram of the peak sizes that destroyed vectors had reached.
+   std::array<int64_t, NumPeakSizeBuckets> peakSizes{};
+
+   // Returns the histogram bucket for a given peak size.
+   static constexpr std::size_t peakSizeBucket(std::size_t peakSize) noexcept
+   {
+      return std::bit_width(peakSize);
+   }
+};
+
+#endif // SBOVEC_MEM_INSTR
+
+
+///////////////////
+
+// Growth policies for SboVector.
+// A growth policy calculates the heap capacity that a vector grows to when it runs
+// out of capacity. Policies have to provide:
+// - static std::size_t grow(std::size_t cap, std::size_t minCap, std::size_t maxCap)
+//   Returns the new capacity given the current capacity, the minimal capacity that
+//   is required and the max capacity. The result must be at least minCap.
+// - static constexpr bool UseAllocationSize
+//   Whether a vector should use all of the memory the allocator provides for an
+//   allocation instead of only the requested capacity. Only takes effect for
+//   allocators that support allocate_at_least (e.g. AlignedAllocator).
+
+// Doubles the capacity.
+struct DoublingGrowth
+{
+   static constexpr bool UseAllocationSize = false;
+
+   static constexpr std::size_t grow(std::size_t cap, std::size_t minCap,
+                                     std::size_t maxCap) noexcept
+   {
+      if (cap > maxCap / 2)
+         return maxCap;
+      return std::max(2 * cap, minCap);
+   }
+};
+
+// Grows the capacity by half. Wastes less memory than doubling and allows allocators
+// to reuse previously freed blocks for later allocations.
+struct OneAndHalfGrowth
+{
+   static constexpr bool UseAllocationSize = false;
+
+   static constexpr std::size_t grow(std::size_t cap, std::size_t minCap,
+                                     std::size_t maxCap) noexcept
+   {
+      if (cap > maxCap / 3 * 2)
+         return maxCap;
+      return std::max(cap + cap / 2, minCap);
+   }
+};
+
+// Grows the capacity by a fixed number of elements.
+template <std::size_t Step> struct FixedStepGrowth
+{
+   static_assert(Step > 0, "Growth step must be positive.");
+
+   static constexpr bool UseAllocationSize = false;
+
+   static constexpr std::size_t grow(std::size_t cap, std::size_t minCap,
+                                     std::size_t maxCap) noexcept
+   {
+      if (cap > maxCap - Step)
+         return maxCap;
+      return std::max(cap + Step, minCap);
+   }
+};
+
+// Grows the capacity according to a given policy and then extends it to all memory
+// of the allocated block, i.e. to the size class of the allocator.
+template <typename BaseGrowth = DoublingGrowth> struct SizeClassGrowth
+{
+   static constexpr bool UseAllocationSize = true;
+
+   static constexpr std::size_t grow(std::size_t cap, std::size_t minCap,
+                                     std::size_t maxCap) noexcept
+   {
+      return BaseGrowth::grow(cap, minCap, maxCap);
+   }
+};
+
+
 ///////////////////
 
 // Vector type that use the small buffer optimization to avoid heap usage for
@@ -51,8 +172,25 @@ template <typename T, std::size_t N> class SboVectorConstIterator;
 // 4. Allocate new memory on the heap.
 // The strategies are listed in order of preference. Not all strategies can be used
 // in any situation, e.g. 1. can only be used for move operations.
+//
+// Element types that are trivially relocatable (see IsTriviallyRelocatable) are
+// transfered as raw memory whenever elements change their location, e.g. when the
+// vector grows or elements are shifted for insertions and erasures.
+//
+// Heap memory is obtained from the allocator given as template parameter. By default
+// the memory is allocated with the alignment of the element type directly from the
+// C runtime. The internal buffer is never allocated through the allocator.
+// Allocators are propagated according to std::allocator_traits. Transfering heap
+// memory between two vectors (moving, swapping) requires their allocators to compare
+// equal or to propagate. If they don't, moves fall back to relocating the elements
+// and swapping is not supported (just like for std::vector).
+//
+// How the heap capacity grows when elements are added is determined by the growth
+// policy given as template parameter. By default the capacity doubles.
 
-template <typename T, std::size_t N> class SboVector
+template <typename T, std::size_t N, typename Alloc = AlignedAllocator<T>,
+          typename Growth = DoublingGrowth>
+class SboVector
 {
    // Requirements for T (std::vector has the same requirements for its T).
    static_assert(std::is_copy_constructible_v<T>,
@@ -73,9 +211,15 @@ template <typename T, std::size_t N> class SboVector
                  "Type void is not erasable.");
    // Requirements for N.
    static_assert(N > 0, "Zero-sized buffer is not supported. Use std::vector.");
+   // Requirements for allocator.
+   static_assert(std::is_same_v<typename std::allocator_traits<Alloc>::value_type, T>,
+                 "Allocator must allocate elements of the vector's element type.");
+
+   using AllocTraits = std::allocator_traits<Alloc>;
 
  public:
    using value_type = T;
+   using allocator_type = Alloc;
    using reference = T&;
    using const_reference = const T&;
    using pointer = T*;
@@ -91,12 +235,15 @@ template <typename T, std::size_t N> class SboVector
 
  public:
    SboVector() = default;
-   explicit SboVector(std::size_t count, const T& value);
+   explicit SboVector(const Alloc& alloc) noexcept;
+   explicit SboVector(std::size_t count, const T& value, const Alloc& alloc = Alloc());
    template <typename FwdIter, typename = std::enable_if_t<IsIterator_v<FwdIter>, void>>
-   SboVector(FwdIter first, FwdIter last);
-   SboVector(std::initializer_list<T> ilist);
+   SboVector(FwdIter first, FwdIter last, const Alloc& alloc = Alloc());
+   SboVector(std::initializer_list<T> ilist, const Alloc& alloc = Alloc());
    SboVector(const SboVector& other);
+   SboVector(const SboVector& other, const Alloc& alloc);
    SboVector(SboVector&& other);
+   SboVector(SboVector&& other, const Alloc& alloc);
    ~SboVector();
 
    SboVector& operator=(const SboVector& other);
@@ -106,6 +253,7 @@ template <typename T, std::size_t N> class SboVector
    void assign(size_type count, const T& value);
    template <typename FwdIter> void assign(FwdIter first, FwdIter last);
    void assign(std::initializer_list<T> ilist);
+   allocator_type get_allocator() const noexcept;
 
    T& at(std::size_t pos);
    const T& at(std::size_t pos) const;
@@ -147,6 +295,9 @@ template <typename T, std::size_t N> class SboVector
    template <typename FwdIter>
    iterator insert(const_iterator pos, FwdIter first, FwdIter last);
    iterator insert(const_iterator pos, std::initializer_list<T> ilist);
+   // Appends the elements of a range. The range must not refer to elements of this
+   // vector.
+   template <std::ranges::forward_range Range> void append_range(Range&& range);
    void push_back(const T& value);
    void push_back(T&& value);
    void pop_back();
@@ -154,6 +305,16 @@ template <typename T, std::size_t N> class SboVector
    template <typename... Args> reference emplace_back(Args&&... args);
    void resize(size_type count);
    void resize(size_type count, const value_type& value);
+   // Resizes without initializing the added elements. Their values are indeterminate
+   // until they are written. Only available for types that need no initialization.
+   void resize_default_init(size_type count);
+   // Lets the given function write up to n elements directly into the memory after the
+   // last element. The function is called as fn(T* dest, n) and either returns the
+   // number of elements it wrote or nothing if it always writes all n elements.
+   // Negative results, e.g. errors of read()-style functions, count as nothing written.
+   // Returns the number of appended elements. Only available for types that need no
+   // initialization.
+   template <typename Fn> size_type append_with(size_type n, Fn fn);
    void swap(SboVector& other);
 
    bool inBuffer() const noexcept;
@@ -177,6 +338,7 @@ template <typename T, std::size_t N> class SboVector
    iterator insertOf(const_iterator pos, FwdIter first, std::size_t n);
    void adjustDataForInsertion(const_iterator pos, std::size_t n);
    void adjustDataForResize(std::size_t n);
+   T* prepareTail(std::size_t n);
    void clean();
 
    // Data operations.
@@ -193,8 +355,10 @@ template <typename T, std::size_t N> class SboVector
    void reallocateLess(std::size_t newCap);
    std::size_t recalcCapacity(std::size_t minCap) const;
 
-   static T* allocateMem(std::size_t cap);
-   static void deallocateMem(T* mem, std::size_t cap);
+   // Allocates memory for at least the given capacity. Updates the capacity if the
+   // growth policy makes use of all of the allocated memory.
+   T* allocateMem(std::size_t& cap);
+   void deallocateMem(T* mem, std::size_t cap);
 
  private:
    // Internal buffer.
@@ -205,15 +369,42 @@ template <typename T, std::size_t N> class SboVector
    std::size_t m_size = 0;
    // Number of allocated elements.
    std::size_t m_capacity = BufferCapacity;
+   // Allocator for heap memory.
+   SBOVEC_NO_UNIQUE_ADDRESS Alloc m_alloc{};
 
    // Memory instrumentation.
+   // Turned on by defining SBOVEC_MEM_INSTR. Tracking the peak size adds a member to
+   // each vector, so the macro has to be defined for the whole program, e.g. as a
+   // compile definition of the build target, and not before individual includes.
+   // The recording functions compile to nothing when instrumentation is turned off.
+   void recordStorageChange(bool fromHeap, bool toHeap) noexcept;
+   void recordSize() noexcept;
+   void recordPeakSize() noexcept;
+
 #ifdef SBOVEC_MEM_INSTR
  public:
-   static int64_t allocatedCapacity() noexcept { return m_allocatedCap; }
-   static void resetAllocatedCapacity() noexcept { m_allocatedCap = 0; }
+   // Statistics are shared by all instances of this vector type and are safe to be
+   // updated and read from multiple threads.
+   static SboVectorMemStats memStats() noexcept;
+   static void resetMemStats() noexcept;
+   static int64_t allocatedCapacity() noexcept;
+   static void resetAllocatedCapacity() noexcept;
 
  private:
-   inline static int64_t m_allocatedCap = 0;
+   struct MemInstrumentation
+   {
+      std::atomic<int64_t> allocatedCap = 0;
+      std::atomic<int64_t> numAllocs = 0;
+      std::atomic<int64_t> numDeallocs = 0;
+      std::atomic<int64_t> numReallocs = 0;
+      std::atomic<int64_t> numSpills = 0;
+      std::atomic<int64_t> numReturns = 0;
+      std::array<std::atomic<int64_t>, SboVectorMemStats::NumPeakSizeBuckets> peakSizes{};
+   };
+
+   inline static MemInstrumentation m_memInstr;
+   // Largest size this instance reached.
+   std::size_t m_peakSize = 0;
 #endif // SBOVEC_MEM_INSTR
 };
 
@@ -265,15 +456,39 @@ template <typename T, typename... Args> constexpr T* construct_at(T* p, Args&&..
 }
 
 
+// Checks if an allocator supports allocate_at_least (available in C++23 for
+// std::allocator).
+template <typename Alloc, typename = void>
+inline constexpr bool HasAllocateAtLeast_v = false;
+
+template <typename Alloc>
+inline constexpr bool HasAllocateAtLeast_v<
+   Alloc, std::void_t<decltype(std::declval<Alloc&>().allocate_at_least(1))>> = true;
+
+
 ///////////////////
 
+// Checks if a range of elements referenced by the given iterator type can be relocated
+// as raw memory.
+template <typename Iter>
+inline constexpr bool CanRelocateBitwise_v =
+   std::is_pointer_v<Iter> &&
+   IsTriviallyRelocatable_v<typename std::iterator_traits<Iter>::value_type>;
+
+
 // Depending on the element type moves or copies a of elements.
 // Does not make accomodations for overlapping ranges.
 template <typename Iter> void relocate_n(Iter first, std::size_t n, Iter dest)
 {
    using value_type = typename std::iterator_traits<Iter>::value_type;
 
-   if constexpr (std::is_move_constructible_v<value_type>)
+   if constexpr (CanRelocateBitwise_v<Iter>)
+   {
+      if (n > 0)
+         std::memcpy(static_cast<void*>(dest), static_cast<const void*>(first),
+                     n * sizeof(value_type));
+   }
+   else if constexpr (std::is_move_constructible_v<value_type>)
    {
       std::uninitialized_move_n(first, n, dest);
    }
@@ -291,10 +506,20 @@ template <typename Iter> void relocateLeftOverlapped(Iter first, Iter last, Iter
 {
    using value_type = typename std::iterator_traits<Iter>::value_type;
 
-   if constexpr (std::is_move_constructible_v<value_type>)
+   if constexpr (CanRelocateBitwise_v<Iter>)
+   {
+      if (first != last)
+         std::memmove(static_cast<void*>(dest), static_cast<const void*>(first),
+                      (last - first) * sizeof(value_type));
+   }
+   else if constexpr (std::is_move_constructible_v<value_type>)
+   {
       std::uninitialized_move(first, last, dest);
+   }
    else
+   {
       copyAndDestroyOverlapped(first, last - first, dest);
+   }
 }
 
 
@@ -304,10 +529,45 @@ template <typename Iter> void relocateRightOverlapped(Iter first, Iter last, Ite
 {
    using value_type = typename std::iterator_traits<Iter>::value_type;
 
-   if constexpr (std::is_move_constructible_v<value_type>)
+   if constexpr (CanRelocateBitwise_v<Iter>)
+   {
+      if (first != last)
+         std::memmove(static_cast<void*>(dest), static_cast<const void*>(first),
+                      (last - first) * sizeof(value_type));
+   }
+   else if constexpr (std::is_move_constructible_v<value_type>)
+   {
       moveOverlappedBackwards(first, last - first, dest);
+   }
    else
+   {
       copyAndDestroyOverlappedBackward(first, last - first, dest);
+   }
+}
+
+
+template <typename Iter, typename T>
+inline constexpr bool CanCopyBitwise_v =
+   IsContiguousIterator_v<Iter> && std::is_trivially_copyable_v<T> &&
+   std::is_same_v<std::remove_cv_t<typename std::iterator_traits<Iter>::value_type>, T>;
+
+
+// Copies elements into uninitialized memory. Copies contiguous ranges of trivially
+// copyable elements as a single block of raw memory. The source range is allowed to
+// overlap the destination in that case.
+template <typename Iter, typename T>
+void uninitialized_copy_n(Iter first, std::size_t n, T* dest)
+{
+   if constexpr (CanCopyBitwise_v<Iter, T>)
+   {
+      if (n > 0)
+         std::memmove(static_cast<void*>(dest),
+                      static_cast<const void*>(std::addressof(*first)), n * sizeof(T));
+   }
+   else
+   {
+      std::uninitialized_copy_n(first, n, dest);
+   }
 }
 
 } // namespace internals
@@ -315,94 +575,153 @@ template <typename Iter> void relocateRightOverlapped(Iter first, Iter last, Ite
 
 ///////////////////
 
-template <typename T, std::size_t N>
-SboVector<T, N>::SboVector(std::size_t count, const T& value)
+template <typename T, std::size_t N, typename Alloc, typename Growth>
+SboVector<T, N, Alloc, Growth>::SboVector(const Alloc& alloc) noexcept : m_alloc{alloc}
+{
+}
+
+
+template <typename T, std::size_t N, typename Alloc, typename Growth>
+SboVector<T, N, Alloc, Growth>::SboVector(std::size_t count, const T& value,
+                                          const Alloc& alloc)
+: m_alloc{alloc}
 {
    constructFrom(count, value);
 }
 
 
-template <typename T, std::size_t N>
+template <typename T, std::size_t N, typename Alloc, typename Growth>
 template <typename FwdIter, typename>
-SboVector<T, N>::SboVector(FwdIter first, FwdIter last)
+SboVector<T, N, Alloc, Growth>::SboVector(FwdIter first, FwdIter last, const Alloc& alloc)
+: m_alloc{alloc}
 {
    constructFrom(first, std::distance(first, last));
 }
 
 
-template <typename T, std::size_t N>
-SboVector<T, N>::SboVector(std::initializer_list<T> ilist)
+template <typename T, std::size_t N, typename Alloc, typename Growth>
+SboVector<T, N, Alloc, Growth>::SboVector(std::initializer_list<T> ilist,
+                                          const Alloc& alloc)
+: m_alloc{alloc}
 {
    constructFrom(ilist.begin(), ilist.size());
 }
 
 
-template <typename T, std::size_t N> SboVector<T, N>::SboVector(const SboVector& other)
+template <typename T, std::size_t N, typename Alloc, typename Growth>
+SboVector<T, N, Alloc, Growth>::SboVector(const SboVector& other)
+: m_alloc{AllocTraits::select_on_container_copy_construction(other.m_alloc)}
+{
+   constructFrom(other.data(), other.size());
+}
+
+
+template <typename T, std::size_t N, typename Alloc, typename Growth>
+SboVector<T, N, Alloc, Growth>::SboVector(const SboVector& other, const Alloc& alloc)
+: m_alloc{alloc}
 {
    constructFrom(other.data(), other.size());
 }
 
 
-template <typename T, std::size_t N> SboVector<T, N>::SboVector(SboVector&& other)
+template <typename T, std::size_t N, typename Alloc, typename Growth>
+SboVector<T, N, Alloc, Growth>::SboVector(SboVector&& other) : m_alloc{other.m_alloc}
 {
    moveFrom(std::move(other));
 }
 
 
-template <typename T, std::size_t N> SboVector<T, N>::~SboVector()
+template <typename T, std::size_t N, typename Alloc, typename Growth>
+SboVector<T, N, Alloc, Growth>::SboVector(SboVector&& other, const Alloc& alloc)
+: m_alloc{alloc}
 {
+   moveFrom(std::move(other));
+}
+
+
+template <typename T, std::size_t N, typename Alloc, typename Growth>
+SboVector<T, N, Alloc, Growth>::~SboVector()
+{
+   recordPeakSize();
    clean();
 }
 
 
-template <typename T, std::size_t N>
-SboVector<T, N>& SboVector<T, N>::operator=(const SboVector& other)
+template <typename T, std::size_t N, typename Alloc, typename Growth>
+SboVector<T, N, Alloc, Growth>&
+SboVector<T, N, Alloc, Growth>::operator=(const SboVector& other)
 {
+   if constexpr (AllocTraits::propagate_on_container_copy_assignment::value)
+   {
+      // Memory allocated by the current allocator has to be released before
+      // replacing it.
+      if (m_alloc != other.m_alloc)
+      {
+         clean();
+         m_size = 0;
+         m_capacity = BufferCapacity;
+      }
+      m_alloc = other.m_alloc;
+   }
+
    assignFrom(other.begin(), other.size());
    return *this;
 }
 
 
-template <typename T, std::size_t N>
-SboVector<T, N>& SboVector<T, N>::operator=(SboVector&& other)
+template <typename T, std::size_t N, typename Alloc, typename Growth>
+SboVector<T, N, Alloc, Growth>&
+SboVector<T, N, Alloc, Growth>::operator=(SboVector&& other)
 {
    clean();
+   if constexpr (AllocTraits::propagate_on_container_move_assignment::value)
+      m_alloc = other.m_alloc;
    moveFrom(std::move(other));
    return *this;
 }
 
 
-template <typename T, std::size_t N>
-SboVector<T, N>& SboVector<T, N>::operator=(std::initializer_list<T> ilist)
+template <typename T, std::size_t N, typename Alloc, typename Growth>
+SboVector<T, N, Alloc, Growth>&
+SboVector<T, N, Alloc, Growth>::operator=(std::initializer_list<T> ilist)
 {
    assignFrom(ilist.begin(), ilist.size());
    return *this;
 }
 
 
-template <typename T, std::size_t N>
-void SboVector<T, N>::assign(size_type count, const T& value)
+template <typename T, std::size_t N, typename Alloc, typename Growth>
+void SboVector<T, N, Alloc, Growth>::assign(size_type count, const T& value)
 {
    assignFrom(count, value);
 }
 
 
-template <typename T, std::size_t N>
+template <typename T, std::size_t N, typename Alloc, typename Growth>
 template <typename FwdIter>
-void SboVector<T, N>::assign(FwdIter first, FwdIter last)
+void SboVector<T, N, Alloc, Growth>::assign(FwdIter first, FwdIter last)
 {
    assignFrom(first, std::distance(first, last));
 }
 
 
-template <typename T, std::size_t N>
-void SboVector<T, N>::assign(std::initializer_list<T> ilist)
+template <typename T, std::size_t N, typename Alloc, typename Growth>
+void SboVector<T, N, Alloc, Growth>::assign(std::initializer_list<T> ilist)
 {
    assignFrom(ilist.begin(), ilist.size());
 }
 
 
-template <typename T, std::size_t N> T& SboVector<T, N>::at(std::size_t pos)
+template <typename T, std::size_t N, typename Alloc, typename Growth>
+typename SboVector<T, N, Alloc, Growth>::allocator_type
+SboVector<T, N, Alloc, Growth>::get_allocator() const noexcept
+{
+   return m_alloc;
+}
+
+
+template <typename T, std::size_t N, typename Alloc, typename Growth>
+T& SboVector<T, N, Alloc, Growth>::at(std::size_t pos)
 {
    if (pos >= m_size)
       throw std::out_of_range("SboVector - Accessing invalid element.");
@@ -410,7 +729,8 @@ template <typename T, std::size_t N> T& SboVector<T, N>::at(std::size_t pos)
 }
 
 
-template <typename T, std::size_t N> const T& SboVector<T, N>::at(std::size_t pos) const
+template <typename T, std::size_t N, typename Alloc, typename Growth>
+const T& SboVector<T, N, Alloc, Growth>::at(std::size_t pos) const
 {
    if (pos >= m_size)
       throw std::out_of_range("SboVector - Accessing invalid element.");
@@ -418,165 +738,187 @@ template <typename T, std::size_t N> const T& SboVector<T, N>::at(std::size_t po
 }
 
 
-template <typename T, std::size_t N> T& SboVector<T, N>::operator[](std::size_t pos)
+template <typename T, std::size_t N, typename Alloc, typename Growth>
+T& SboVector<T, N, Alloc, Growth>::operator[](std::size_t pos)
 {
    return m_data[pos];
 }
 
 
-template <typename T, std::size_t N>
-const T& SboVector<T, N>::operator[](std::size_t pos) const
+template <typename T, std::size_t N, typename Alloc, typename Growth>
+const T& SboVector<T, N, Alloc, Growth>::operator[](std::size_t pos) const
 {
    return m_data[pos];
 }
 
 
-template <typename T, std::size_t N> T& SboVector<T, N>::front()
+template <typename T, std::size_t N, typename Alloc, typename Growth>
+T& SboVector<T, N, Alloc, Growth>::front()
 {
    return m_data[0];
 }
 
 
-template <typename T, std::size_t N> const T& SboVector<T, N>::front() const
+template <typename T, std::size_t N, typename Alloc, typename Growth>
+const T& SboVector<T, N, Alloc, Growth>::front() const
 {
    return m_data[0];
 }
 
 
-template <typename T, std::size_t N> T& SboVector<T, N>::back()
+template <typename T, std::size_t N, typename Alloc, typename Growth>
+T& SboVector<T, N, Alloc, Growth>::back()
 {
    return m_data[m_size - 1];
 }
 
 
-template <typename T, std::size_t N> const T& SboVector<T, N>::back() const
+template <typename T, std::size_t N, typename Alloc, typename Growth>
+const T& SboVector<T, N, Alloc, Growth>::back() const
 {
    return m_data[m_size - 1];
 }
 
 
-template <typename T, std::size_t N> T* SboVector<T, N>::data() noexcept
+template <typename T, std::size_t N, typename Alloc, typename Growth>
+T* SboVector<T, N, Alloc, Growth>::data() noexcept
 {
    return m_data;
 }
 
 
-template <typename T, std::size_t N> const T* SboVector<T, N>::data() const noexcept
+template <typename T, std::size_t N, typename Alloc, typename Growth>
+const T* SboVector<T, N, Alloc, Growth>::data() const noexcept
 {
    return m_data;
 }
 
 
-template <typename T, std::size_t N>
-typename SboVector<T, N>::iterator SboVector<T, N>::begin() noexcept
+template <typename T, std::size_t N, typename Alloc, typename Growth>
+typename SboVector<T, N, Alloc, Growth>::iterator
+SboVector<T, N, Alloc, Growth>::begin() noexcept
 {
    return iterator(m_data);
 }
 
 
-template <typename T, std::size_t N>
-typename SboVector<T, N>::iterator SboVector<T, N>::end() noexcept
+template <typename T, std::size_t N, typename Alloc, typename Growth>
+typename SboVector<T, N, Alloc, Growth>::iterator
+SboVector<T, N, Alloc, Growth>::end() noexcept
 {
    return iterator(m_data + size());
 }
 
 
-template <typename T, std::size_t N>
-typename SboVector<T, N>::const_iterator SboVector<T, N>::begin() const noexcept
+template <typename T, std::size_t N, typename Alloc, typename Growth>
+typename SboVector<T, N, Alloc, Growth>::const_iterator
+SboVector<T, N, Alloc, Growth>::begin() const noexcept
 {
    return const_iterator(m_data);
 }
 
 
-template <typename T, std::size_t N>
-typename SboVector<T, N>::const_iterator SboVector<T, N>::end() const noexcept
+template <typename T, std::size_t N, typename Alloc, typename Growth>
+typename SboVector<T, N, Alloc, Growth>::const_iterator
+SboVector<T, N, Alloc, Growth>::end() const noexcept
 {
    return const_iterator(m_data + size());
 }
 
 
-template <typename T, std::size_t N>
-typename SboVector<T, N>::const_iterator SboVector<T, N>::cbegin() const noexcept
+template <typename T, std::size_t N, typename Alloc, typename Growth>
+typename SboVector<T, N, Alloc, Growth>::const_iterator
+SboVector<T, N, Alloc, Growth>::cbegin() const noexcept
 {
    return begin();
 }
 
 
-template <typename T, std::size_t N>
-typename SboVector<T, N>::const_iterator SboVector<T, N>::cend() const noexcept
+template <typename T, std::size_t N, typename Alloc, typename Growth>
+typename SboVector<T, N, Alloc, Growth>::const_iterator
+SboVector<T, N, Alloc, Growth>::cend() const noexcept
 {
    return end();
 }
 
 
-template <typename T, std::size_t N>
-typename SboVector<T, N>::reverse_iterator SboVector<T, N>::rbegin() noexcept
+template <typename T, std::size_t N, typename Alloc, typename Growth>
+typename SboVector<T, N, Alloc, Growth>::reverse_iterator
+SboVector<T, N, Alloc, Growth>::rbegin() noexcept
 {
    return reverse_iterator(end());
 }
 
 
-template <typename T, std::size_t N>
-typename SboVector<T, N>::reverse_iterator SboVector<T, N>::rend() noexcept
+template <typename T, std::size_t N, typename Alloc, typename Growth>
+typename SboVector<T, N, Alloc, Growth>::reverse_iterator
+SboVector<T, N, Alloc, Growth>::rend() noexcept
 {
    return reverse_iterator(begin());
 }
 
 
-template <typename T, std::size_t N>
-typename SboVector<T, N>::const_reverse_iterator SboVector<T, N>::rbegin() const noexcept
+template <typename T, std::size_t N, typename Alloc, typename Growth>
+typename SboVector<T, N, Alloc, Growth>::const_reverse_iterator
+SboVector<T, N, Alloc, Growth>::rbegin() const noexcept
 {
    return crbegin();
 }
 
 
-template <typename T, std::size_t N>
-typename SboVector<T, N>::const_reverse_iterator SboVector<T, N>::rend() const noexcept
+template <typename T, std::size_t N, typename Alloc, typename Growth>
+typename SboVector<T, N, Alloc, Growth>::const_reverse_iterator
+SboVector<T, N, Alloc, Growth>::rend() const noexcept
 {
    return crend();
 }
 
 
-template <typename T, std::size_t N>
-typename SboVector<T, N>::const_reverse_iterator SboVector<T, N>::crbegin() const noexcept
+template <typename T, std::size_t N, typename Alloc, typename Growth>
+typename SboVector<T, N, Alloc, Growth>::const_reverse_iterator
+SboVector<T, N, Alloc, Growth>::crbegin() const noexcept
 {
    return const_reverse_iterator(cend());
 }
 
 
-template <typename T, std::size_t N>
-typename SboVector<T, N>::const_reverse_iterator SboVector<T, N>::crend() const noexcept
+template <typename T, std::size_t N, typename Alloc, typename Growth>
+typename SboVector<T, N, Alloc, Growth>::const_reverse_iterator
+SboVector<T, N, Alloc, Growth>::crend() const noexcept
 {
    return const_reverse_iterator(cbegin());
 }
 
 
-template <typename T, std::size_t N> bool SboVector<T, N>::empty() const noexcept
+template <typename T, std::size_t N, typename Alloc, typename Growth>
+bool SboVector<T, N, Alloc, Growth>::empty() const noexcept
 {
    return (m_size == 0);
 }
 
 
-template <typename T, std::size_t N> std::size_t SboVector<T, N>::size() const noexcept
+template <typename T, std::size_t N, typename Alloc, typename Growth>
+std::size_t SboVector<T, N, Alloc, Growth>::size() const noexcept
 {
    return m_size;
 }
 
-template <typename T, std::size_t N>
-constexpr std::size_t SboVector<T, N>::max_size() const noexcept
+template <typename T, std::size_t N, typename Alloc, typename Growth>
+constexpr std::size_t SboVector<T, N, Alloc, Growth>::max_size() const noexcept
 {
    return std::numeric_limits<difference_type>::max();
 }
 
 
-template <typename T, std::size_t N>
-std::size_t SboVector<T, N>::capacity() const noexcept
+template <typename T, std::size_t N, typename Alloc, typename Growth>
+std::size_t SboVector<T, N, Alloc, Growth>::capacity() const noexcept
 {
    return m_capacity;
 }
 
 
-template <typename T, std::size_t N> void SboVector<T, N>::reserve(std::size_t cap)
+template <typename T, std::size_t N, typename Alloc, typename Growth>
+void SboVector<T, N, Alloc, Growth>::reserve(std::size_t cap)
 {
    // Vector spec calls for exception when request exceeds the max size.
    if (cap > max_size())
@@ -589,30 +931,33 @@ template <typename T, std::size_t N> void SboVector<T, N>::reserve(std::size_t c
 }
 
 
-template <typename T, std::size_t N> void SboVector<T, N>::shrink_to_fit()
+template <typename T, std::size_t N, typename Alloc, typename Growth>
+void SboVector<T, N, Alloc, Growth>::shrink_to_fit()
 {
    if (onHeap() && size() < capacity())
       reallocate(size());
 }
 
 
-template <typename T, std::size_t N> void SboVector<T, N>::clear() noexcept
+template <typename T, std::size_t N, typename Alloc, typename Growth>
+void SboVector<T, N, Alloc, Growth>::clear() noexcept
 {
    destroy();
    m_size = 0;
 }
 
 
-template <typename T, std::size_t N>
-typename SboVector<T, N>::iterator SboVector<T, N>::erase(const_iterator pos)
+template <typename T, std::size_t N, typename Alloc, typename Growth>
+typename SboVector<T, N, Alloc, Growth>::iterator
+SboVector<T, N, Alloc, Growth>::erase(const_iterator pos)
 {
    return erase(pos, pos + 1);
 }
 
 
-template <typename T, std::size_t N>
-typename SboVector<T, N>::iterator SboVector<T, N>::erase(const_iterator first,
-                                                          const_iterator last)
+template <typename T, std::size_t N, typename Alloc, typename Growth>
+typename SboVector<T, N, Alloc, Growth>::iterator
+SboVector<T, N, Alloc, Growth>::erase(const_iterator first, const_iterator last)
 {
    if (first >= cend())
       return end();
@@ -636,59 +981,73 @@ typename SboVector<T, N>::iterator SboVector<T, N>::erase(const_iterator first,
 }
 
 
-template <typename T, std::size_t N>
-typename SboVector<T, N>::iterator SboVector<T, N>::insert(const_iterator pos,
-                                                           const T& value)
+template <typename T, std::size_t N, typename Alloc, typename Growth>
+typename SboVector<T, N, Alloc, Growth>::iterator
+SboVector<T, N, Alloc, Growth>::insert(const_iterator pos, const T& value)
 {
    return insertOf(pos, 1, value);
 }
 
 
-template <typename T, std::size_t N>
-typename SboVector<T, N>::iterator SboVector<T, N>::insert(const_iterator pos, T&& value)
+template <typename T, std::size_t N, typename Alloc, typename Growth>
+typename SboVector<T, N, Alloc, Growth>::iterator
+SboVector<T, N, Alloc, Growth>::insert(const_iterator pos, T&& value)
 {
    return insertOf(pos, std::move(value));
 }
 
 
-template <typename T, std::size_t N>
-typename SboVector<T, N>::iterator
-SboVector<T, N>::insert(const_iterator pos, size_type count, const T& value)
+template <typename T, std::size_t N, typename Alloc, typename Growth>
+typename SboVector<T, N, Alloc, Growth>::iterator
+SboVector<T, N, Alloc, Growth>::insert(const_iterator pos, size_type count,
+                                       const T& value)
 {
    return insertOf(pos, count, value);
 }
 
 
-template <typename T, std::size_t N>
+template <typename T, std::size_t N, typename Alloc, typename Growth>
 template <typename FwdIter>
-typename SboVector<T, N>::iterator SboVector<T, N>::insert(const_iterator pos,
-                                                           FwdIter first, FwdIter last)
+typename SboVector<T, N, Alloc, Growth>::iterator
+SboVector<T, N, Alloc, Growth>::insert(const_iterator pos, FwdIter first, FwdIter last)
 {
    return insertOf(pos, first, std::distance(first, last));
 }
 
 
-template <typename T, std::size_t N>
-typename SboVector<T, N>::iterator SboVector<T, N>::insert(const_iterator pos,
-                                                           std::initializer_list<T> ilist)
+template <typename T, std::size_t N, typename Alloc, typename Growth>
+typename SboVector<T, N, Alloc, Growth>::iterator
+SboVector<T, N, Alloc, Growth>::insert(const_iterator pos, std::initializer_list<T> ilist)
 {
    return insertOf(pos, ilist.begin(), ilist.size());
 }
 
 
-template <typename T, std::size_t N> void SboVector<T, N>::push_back(const T& value)
+template <typename T, std::size_t N, typename Alloc, typename Growth>
+template <std::ranges::forward_range Range>
+void SboVector<T, N, Alloc, Growth>::append_range(Range&& range)
+{
+   insertOf(cend(), std::ranges::begin(range),
+            static_cast<std::size_t>(std::ranges::distance(range)));
+}
+
+
+template <typename T, std::size_t N, typename Alloc, typename Growth>
+void SboVector<T, N, Alloc, Growth>::push_back(const T& value)
 {
    insert(begin() + size(), value);
 }
 
 
-template <typename T, std::size_t N> void SboVector<T, N>::push_back(T&& value)
+template <typename T, std::size_t N, typename Alloc, typename Growth>
+void SboVector<T, N, Alloc, Growth>::push_back(T&& value)
 {
    insert(begin() + size(), std::move(value));
 }
 
 
-template <typename T, std::size_t N> void SboVector<T, N>::pop_back()
+template <typename T, std::size_t N, typename Alloc, typename Growth>
+void SboVector<T, N, Alloc, Growth>::pop_back()
 {
    // We don't need to worry about an empty vector case because calling pop_back on an
    // empty vector is UB according to the standard.
@@ -697,10 +1056,10 @@ template <typename T, std::size_t N> void SboVector<T, N>::pop_back()
 }
 
 
-template <typename T, std::size_t N>
+template <typename T, std::size_t N, typename Alloc, typename Growth>
 template <typename... Args>
-typename SboVector<T, N>::iterator SboVector<T, N>::emplace(const_iterator pos,
-                                                            Args&&... args)
+typename SboVector<T, N, Alloc, Growth>::iterator
+SboVector<T, N, Alloc, Growth>::emplace(const_iterator pos, Args&&... args)
 {
    const std::size_t diff = pos - cbegin();
    adjustDataForInsertion(pos, 1);
@@ -709,35 +1068,89 @@ typename SboVector<T, N>::iterator SboVector<T, N>::emplace(const_iterator pos,
 }
 
 
-template <typename T, std::size_t N>
+template <typename T, std::size_t N, typename Alloc, typename Growth>
 template <typename... Args>
-typename SboVector<T, N>::reference SboVector<T, N>::emplace_back(Args&&... args)
+typename SboVector<T, N, Alloc, Growth>::reference
+SboVector<T, N, Alloc, Growth>::emplace_back(Args&&... args)
 {
    emplace(begin() + size(), std::forward<Args>(args)...);
    return *(begin() + size() - 1);
 }
 
 
-template <typename T, std::size_t N> void SboVector<T, N>::resize(size_type count)
+template <typename T, std::size_t N, typename Alloc, typename Growth>
+void SboVector<T, N, Alloc, Growth>::resize(size_type count)
 {
    adjustDataForResize(count);
    if (count > m_size)
       std::uninitialized_default_construct_n(data() + size(), count - size());
    m_size = count;
+   recordSize();
 }
 
 
-template <typename T, std::size_t N>
-void SboVector<T, N>::resize(size_type count, const value_type& value)
+template <typename T, std::size_t N, typename Alloc, typename Growth>
+void SboVector<T, N, Alloc, Growth>::resize(size_type count, const value_type& value)
 {
    adjustDataForResize(count);
    if (count > m_size)
       std::uninitialized_fill_n(data() + size(), count - size(), value);
    m_size = count;
+   recordSize();
+}
+
+
+template <typename T, std::size_t N, typename Alloc, typename Growth>
+void SboVector<T, N, Alloc, Growth>::resize_default_init(size_type count)
+{
+   static_assert(std::is_trivially_default_constructible_v<T>,
+                 "Element type must be trivially default-constructible.");
+
+   adjustDataForResize(count);
+   m_size = count;
+   recordSize();
 }
 
 
-template <typename T, std::size_t N> void SboVector<T, N>::swap(SboVector& other)
+template <typename T, std::size_t N, typename Alloc, typename Growth>
+template <typename Fn>
+typename SboVector<T, N, Alloc, Growth>::size_type
+SboVector<T, N, Alloc, Growth>::append_with(size_type n, Fn fn)
+{
+   static_assert(std::is_trivially_default_constructible_v<T>,
+                 "Element type must be trivially default-constructible.");
+
+   T* dest = prepareTail(n);
+
+   using Result = std::invoke_result_t<Fn&, T*, size_type>;
+   size_type numWritten = n;
+   if constexpr (std::is_void_v<Result>)
+   {
+      fn(dest, n);
+   }
+   else
+   {
+      const Result result = fn(dest, n);
+      if constexpr (std::is_signed_v<Result>)
+      {
+         if (result < 0)
+            return 0;
+      }
+      numWritten = static_cast<size_type>(result);
+   }
+   assert(numWritten <= n);
+   // Never append more than the prepared elements, even if the function claims to have
+   // written more.
+   numWritten = std::min(numWritten, n);
+
+   m_size += numWritten;
+   recordSize();
+   return numWritten;
+}
+
+
+template <typename T, std::size_t N, typename Alloc, typename Growth>
+void SboVector<T, N, Alloc, Growth>::swap(SboVector& other)
 {
    // Cases:
    // - Both on heap: Swap heap pointers.
@@ -747,6 +1160,17 @@ template <typename T, std::size_t N> void SboVector<T, N>::swap(SboVector& other
    // - One on heap, one in buffer:
    //   Relocate buffered elements to buffer of heap vector, reassign heap pointer.
 
+   // Heap memory can only be exchanged if it can be released by either allocator.
+   if constexpr (AllocTraits::propagate_on_container_swap::value)
+   {
+      using std::swap; // Enable ADL.
+      swap(m_alloc, other.m_alloc);
+   }
+   else
+   {
+      assert(m_alloc == other.m_alloc);
+   }
+
    const bool thisOnHeap = onHeap();
    const bool otherOnHeap = other.onHeap();
 
@@ -760,16 +1184,28 @@ template <typename T, std::size_t N> void SboVector<T, N>::swap(SboVector& other
       SboVector& smaller = size() >= other.size() ? other : *this;
       const std::size_t commonSize = smaller.size();
 
-      for (std::size_t i = 0; i < commonSize; ++i)
+      if constexpr (IsTriviallyRelocatable_v<T>)
       {
-         using std::swap; // Enable ADL.
-         swap(smaller.m_data[i], larger.m_data[i]);
+         // Swap the occupied parts of the buffers as raw memory.
+         std::aligned_storage_t<sizeof(T), alignof(T)> tmp[N];
+         T* tmpData = reinterpret_cast<T*>(tmp);
+         internals::relocate_n(larger.data(), larger.size(), tmpData);
+         internals::relocate_n(smaller.data(), commonSize, larger.data());
+         internals::relocate_n(tmpData, larger.size(), smaller.data());
+      }
+      else
+      {
+         for (std::size_t i = 0; i < commonSize; ++i)
+         {
+            using std::swap; // Enable ADL.
+            swap(smaller.m_data[i], larger.m_data[i]);
+         }
+
+         T* src = larger.data() + commonSize;
+         T* dest = smaller.data() + commonSize;
+         const std::size_t numRelocate = larger.size() - commonSize;
+         internals::relocate_n(src, numRelocate, dest);
       }
-
-      T* src = larger.data() + commonSize;
-      T* dest = smaller.data() + commonSize;
-      const std::size_t numRelocate = larger.size() - commonSize;
-      internals::relocate_n(src, numRelocate, dest);
       m_data = buffer();
       other.m_data = other.buffer();
    }
@@ -785,52 +1221,58 @@ template <typename T, std::size_t N> void SboVector<T, N>::swap(SboVector& other
 
    std::swap(m_size, other.m_size);
    std::swap(m_capacity, other.m_capacity);
+   recordSize();
+   other.recordSize();
 }
 
 
-template <typename T, std::size_t N> bool SboVector<T, N>::inBuffer() const noexcept
+template <typename T, std::size_t N, typename Alloc, typename Growth>
+bool SboVector<T, N, Alloc, Growth>::inBuffer() const noexcept
 {
    return (m_data == buffer());
 }
 
 
-template <typename T, std::size_t N> bool SboVector<T, N>::onHeap() const noexcept
+template <typename T, std::size_t N, typename Alloc, typename Growth>
+bool SboVector<T, N, Alloc, Growth>::onHeap() const noexcept
 {
    return !inBuffer();
 }
 
 
-template <typename T, std::size_t N> constexpr T* SboVector<T, N>::buffer()
+template <typename T, std::size_t N, typename Alloc, typename Growth>
+constexpr T* SboVector<T, N, Alloc, Growth>::buffer()
 {
    return reinterpret_cast<T*>(m_buffer);
 }
 
 
-template <typename T, std::size_t N> constexpr const T* SboVector<T, N>::buffer() const
+template <typename T, std::size_t N, typename Alloc, typename Growth>
+constexpr const T* SboVector<T, N, Alloc, Growth>::buffer() const
 {
    return reinterpret_cast<const T*>(m_buffer);
 }
 
 
-template <typename T, std::size_t N>
-void SboVector<T, N>::constructFrom(std::size_t n, const T& value)
+template <typename T, std::size_t N, typename Alloc, typename Growth>
+void SboVector<T, N, Alloc, Growth>::constructFrom(std::size_t n, const T& value)
 {
    prepareDataForPopulating(n);
    populateWith(n, value);
 }
 
 
-template <typename T, std::size_t N>
+template <typename T, std::size_t N, typename Alloc, typename Growth>
 template <typename FwdIter>
-void SboVector<T, N>::constructFrom(FwdIter first, std::size_t n)
+void SboVector<T, N, Alloc, Growth>::constructFrom(FwdIter first, std::size_t n)
 {
    prepareDataForPopulating(n);
    populateWith(first, n);
 }
 
 
-template <typename T, std::size_t N>
-void SboVector<T, N>::prepareDataForPopulating(std::size_t n)
+template <typename T, std::size_t N, typename Alloc, typename Growth>
+void SboVector<T, N, Alloc, Growth>::prepareDataForPopulating(std::size_t n)
 {
    // Cases:
    // - Use the buffer.
@@ -839,30 +1281,30 @@ void SboVector<T, N>::prepareDataForPopulating(std::size_t n)
    if (!fitsIntoBuffer(n))
    {
       allocate(n);
-      m_capacity = n;
+      recordStorageChange(false, true);
    }
 }
 
 
-template <typename T, std::size_t N>
-void SboVector<T, N>::assignFrom(std::size_t n, const T& value)
+template <typename T, std::size_t N, typename Alloc, typename Growth>
+void SboVector<T, N, Alloc, Growth>::assignFrom(std::size_t n, const T& value)
 {
    adjustDataForAssignment(n);
    populateWith(n, value);
 }
 
 
-template <typename T, std::size_t N>
+template <typename T, std::size_t N, typename Alloc, typename Growth>
 template <typename FwdIter>
-void SboVector<T, N>::assignFrom(FwdIter first, std::size_t n)
+void SboVector<T, N, Alloc, Growth>::assignFrom(FwdIter first, std::size_t n)
 {
    adjustDataForAssignment(n);
    populateWith(first, n);
 }
 
 
-template <typename T, std::size_t N>
-void SboVector<T, N>::adjustDataForAssignment(std::size_t n)
+template <typename T, std::size_t N, typename Alloc, typename Growth>
+void SboVector<T, N, Alloc, Growth>::adjustDataForAssignment(std::size_t n)
 {
    // Cases:
    // - Use the buffer.
@@ -876,13 +1318,17 @@ void SboVector<T, N>::adjustDataForAssignment(std::size_t n)
    // Perform allocation up front to prevent inconsistencies if allocation
    // fails.
    T* newData = nullptr;
+   std::size_t newCap = n;
    if (allocHeap)
-      newData = allocateMem(n);
+      newData = allocateMem(newCap);
 
    // Clean up existing data.
    destroy();
    if (fitsBuffer || allocHeap)
+   {
+      recordStorageChange(onHeap(), allocHeap);
       deallocate();
+   }
 
    // Set up new data.
    if (fitsBuffer)
@@ -897,19 +1343,21 @@ void SboVector<T, N>::adjustDataForAssignment(std::size_t n)
    {
       assert(allocHeap && newData);
       m_data = newData;
-      m_capacity = n;
+      m_capacity = newCap;
    }
 }
 
 
-template <typename T, std::size_t N> void SboVector<T, N>::moveFrom(SboVector&& other)
+template <typename T, std::size_t N, typename Alloc, typename Growth>
+void SboVector<T, N, Alloc, Growth>::moveFrom(SboVector&& other)
 {
    // Cases:
    // - Steal heap allocation.
    // - Use buffer.
+   // - Make a new heap allocation because the heap allocation cannot be stolen.
 
    const auto srcSize = other.size();
-   const bool canSteal = other.onHeap();
+   const bool canSteal = other.onHeap() && m_alloc == other.m_alloc;
 
    if (canSteal)
    {
@@ -920,21 +1368,28 @@ template <typename T, std::size_t N> void SboVector<T, N>::moveFrom(SboVector&&
    }
    else
    {
-      // Elements must fit into the buffer.
-      assert(fitsIntoBuffer(srcSize));
+      if (fitsIntoBuffer(srcSize))
+      {
+         m_capacity = BufferCapacity;
+      }
+      else
+      {
+         allocate(srcSize);
+         recordStorageChange(false, true);
+      }
       std::uninitialized_move_n(other.m_data, srcSize, m_data);
-      m_capacity = BufferCapacity;
    }
 
    m_size = srcSize;
+   recordSize();
    // Reset other size to prevent destruction of the stolen or moved objects.
    other.m_size = 0;
 }
 
 
-template <typename T, std::size_t N>
-typename SboVector<T, N>::iterator SboVector<T, N>::insertOf(const_iterator pos,
-                                                             T&& value)
+template <typename T, std::size_t N, typename Alloc, typename Growth>
+typename SboVector<T, N, Alloc, Growth>::iterator
+SboVector<T, N, Alloc, Growth>::insertOf(const_iterator pos, T&& value)
 {
    const std::size_t diff = pos - cbegin();
    adjustDataForInsertion(pos, 1);
@@ -943,9 +1398,10 @@ typename SboVector<T, N>::iterator SboVector<T, N>::insertOf(const_iterator pos,
 }
 
 
-template <typename T, std::size_t N>
-typename SboVector<T, N>::iterator
-SboVector<T, N>::insertOf(const_iterator pos, std::size_t n, const T& value)
+template <typename T, std::size_t N, typename Alloc, typename Growth>
+typename SboVector<T, N, Alloc, Growth>::iterator
+SboVector<T, N, Alloc, Growth>::insertOf(const_iterator pos, std::size_t n,
+                                         const T& value)
 {
    const std::size_t diff = pos - cbegin();
    if (n > 0)
@@ -958,23 +1414,24 @@ SboVector<T, N>::insertOf(const_iterator pos, std::size_t n, const T& value)
 }
 
 
-template <typename T, std::size_t N>
+template <typename T, std::size_t N, typename Alloc, typename Growth>
 template <typename FwdIter, typename>
-typename SboVector<T, N>::iterator SboVector<T, N>::insertOf(const_iterator pos,
-                                                             FwdIter first, std::size_t n)
+typename SboVector<T, N, Alloc, Growth>::iterator
+SboVector<T, N, Alloc, Growth>::insertOf(const_iterator pos, FwdIter first, std::size_t n)
 {
    const std::size_t diff = pos - cbegin();
    if (n > 0)
    {
       adjustDataForInsertion(pos, n);
-      std::uninitialized_copy_n(first, n, data() + diff);
+      internals::uninitialized_copy_n(first, n, data() + diff);
    }
    return begin() + diff;
 }
 
 
-template <typename T, std::size_t N>
-void SboVector<T, N>::adjustDataForInsertion(const_iterator pos, std::size_t n)
+template <typename T, std::size_t N, typename Alloc, typename Growth>
+void SboVector<T, N, Alloc, Growth>::adjustDataForInsertion(const_iterator pos,
+                                                            std::size_t n)
 {
    // Cases:
    // - In buffer and enough capacity to stay in buffer.
@@ -987,7 +1444,7 @@ void SboVector<T, N>::adjustDataForInsertion(const_iterator pos, std::size_t n)
    const bool fitsBuffer = fitsIntoBuffer(newSize);
    const bool canReuseHeap = onHeap() && m_capacity >= newSize;
    const bool allocHeap = !fitsBuffer && !canReuseHeap;
-   const std::size_t newCap = allocHeap ? recalcCapacity(newSize) : capacity();
+   std::size_t newCap = allocHeap ? recalcCapacity(newSize) : capacity();
 
    // Perform allocation up front to prevent inconsistencies if allocation
    // fails.
@@ -1014,8 +1471,10 @@ void SboVector<T, N>::adjustDataForInsertion(const_iterator pos, std::size_t n)
    }
 
    m_size = newSize;
+   recordSize();
    if (allocHeap)
    {
+      recordStorageChange(onHeap(), true);
       deallocate();
       m_data = dest;
       m_capacity = newCap;
@@ -1023,8 +1482,8 @@ void SboVector<T, N>::adjustDataForInsertion(const_iterator pos, std::size_t n)
 }
 
 
-template <typename T, std::size_t N>
-void SboVector<T, N>::adjustDataForResize(std::size_t n)
+template <typename T, std::size_t N, typename Alloc, typename Growth>
+void SboVector<T, N, Alloc, Growth>::adjustDataForResize(std::size_t n)
 {
    // Cases:
    // - New size == old size: Nothing to do.
@@ -1050,50 +1509,72 @@ void SboVector<T, N>::adjustDataForResize(std::size_t n)
 }
 
 
-template <typename T, std::size_t N> void SboVector<T, N>::clean()
+template <typename T, std::size_t N, typename Alloc, typename Growth>
+T* SboVector<T, N, Alloc, Growth>::prepareTail(std::size_t n)
+{
+   // Grows the capacity according to the growth policy, so that repeatedly appending
+   // has amortized constant cost.
+   if (n > max_size() - size())
+      throw std::length_error("SboVector - Exceeding max size.");
+
+   const std::size_t newSize = size() + n;
+   if (newSize > capacity())
+      reallocate(recalcCapacity(newSize));
+   return data() + size();
+}
+
+
+template <typename T, std::size_t N, typename Alloc, typename Growth>
+void SboVector<T, N, Alloc, Growth>::clean()
 {
    destroy();
    deallocate();
 }
 
 
-template <typename T, std::size_t N>
-void SboVector<T, N>::populateWith(std::size_t n, const T& value)
+template <typename T, std::size_t N, typename Alloc, typename Growth>
+void SboVector<T, N, Alloc, Growth>::populateWith(std::size_t n, const T& value)
 {
    std::uninitialized_fill_n(m_data, n, value);
    m_size = n;
+   recordSize();
 }
 
 
-template <typename T, std::size_t N>
+template <typename T, std::size_t N, typename Alloc, typename Growth>
 template <typename FwdIter>
-void SboVector<T, N>::populateWith(FwdIter first, std::size_t n)
+void SboVector<T, N, Alloc, Growth>::populateWith(FwdIter first, std::size_t n)
 {
-   std::uninitialized_copy_n(first, n, m_data);
+   internals::uninitialized_copy_n(first, n, m_data);
    m_size = n;
+   recordSize();
 }
 
 
-template <typename T, std::size_t N> void SboVector<T, N>::destroy()
+template <typename T, std::size_t N, typename Alloc, typename Growth>
+void SboVector<T, N, Alloc, Growth>::destroy()
 {
    std::destroy_n(m_data, size());
 }
 
 
-template <typename T, std::size_t N>
-constexpr bool SboVector<T, N>::fitsIntoBuffer(std::size_t size)
+template <typename T, std::size_t N, typename Alloc, typename Growth>
+constexpr bool SboVector<T, N, Alloc, Growth>::fitsIntoBuffer(std::size_t size)
 {
    return size <= BufferCapacity;
 }
 
 
-template <typename T, std::size_t N> void SboVector<T, N>::allocate(std::size_t cap)
+template <typename T, std::size_t N, typename Alloc, typename Growth>
+void SboVector<T, N, Alloc, Growth>::allocate(std::size_t cap)
 {
    m_data = allocateMem(cap);
+   m_capacity = cap;
 }
 
 
-template <typename T, std::size_t N> void SboVector<T, N>::deallocate()
+template <typename T, std::size_t N, typename Alloc, typename Growth>
+void SboVector<T, N, Alloc, Growth>::deallocate()
 {
    if (onHeap())
    {
@@ -1103,7 +1584,8 @@ template <typename T, std::size_t N> void SboVector<T, N>::deallocate()
 }
 
 
-template <typename T, std::size_t N> void SboVector<T, N>::reallocate(std::size_t newCap)
+template <typename T, std::size_t N, typename Alloc, typename Growth>
+void SboVector<T, N, Alloc, Growth>::reallocate(std::size_t newCap)
 {
    // Cannot reallocate to less than what the current elements occupy.
    assert(newCap >= size());
@@ -1117,8 +1599,8 @@ template <typename T, std::size_t N> void SboVector<T, N>::reallocate(std::size_
 }
 
 
-template <typename T, std::size_t N>
-void SboVector<T, N>::reallocateMore(std::size_t newCap)
+template <typename T, std::size_t N, typename Alloc, typename Growth>
+void SboVector<T, N, Alloc, Growth>::reallocateMore(std::size_t newCap)
 {
    assert(newCap > capacity());
 
@@ -1129,6 +1611,7 @@ void SboVector<T, N>::reallocateMore(std::size_t newCap)
 
    T* newData = allocateMem(newCap);
    internals::relocate_n(data(), size(), newData);
+   recordStorageChange(onHeap(), true);
 
    // Will only dealloc if current data is on heap.
    deallocate();
@@ -1138,8 +1621,8 @@ void SboVector<T, N>::reallocateMore(std::size_t newCap)
 }
 
 
-template <typename T, std::size_t N>
-void SboVector<T, N>::reallocateLess(std::size_t newCap)
+template <typename T, std::size_t N, typename Alloc, typename Growth>
+void SboVector<T, N, Alloc, Growth>::reallocateLess(std::size_t newCap)
 {
    assert(newCap < capacity());
 
@@ -1160,6 +1643,7 @@ void SboVector<T, N>::reallocateLess(std::size_t newCap)
    T* newData = allocHeap ? allocateMem(newCap) : buffer();
 
    internals::relocate_n(data(), size(), newData);
+   recordStorageChange(true, allocHeap);
 
    // Will only dealloc if current data is on heap.
    deallocate();
@@ -1169,108 +1653,213 @@ void SboVector<T, N>::reallocateLess(std::size_t newCap)
 }
 
 
-template <typename T, std::size_t N>
-std::size_t SboVector<T, N>::recalcCapacity(std::size_t minCap) const
+template <typename T, std::size_t N, typename Alloc, typename Growth>
+std::size_t SboVector<T, N, Alloc, Growth>::recalcCapacity(std::size_t minCap) const
 {
-   const std::size_t maxCap = max_size();
-   if (m_capacity > maxCap / 2)
-      return maxCap;
-   return std::max(2 * m_capacity, minCap);
+   return Growth::grow(m_capacity, minCap, max_size());
 }
 
 
-template <typename T, std::size_t N> T* SboVector<T, N>::allocateMem(std::size_t cap)
+template <typename T, std::size_t N, typename Alloc, typename Growth>
+T* SboVector<T, N, Alloc, Growth>::allocateMem(std::size_t& cap)
 {
-#ifdef VS_COMPILER
-   // Visual Studio does not support std::aligned_alloc.
-   T* mem = reinterpret_cast<T*>(_aligned_malloc(cap * sizeof(T), alignof(T)));
-#else
-   T* mem = reinterpret_cast<T*>(std::aligned_alloc(alignof(T), cap * sizeof(T)));
-#endif
+   T* mem = nullptr;
+   if constexpr (Growth::UseAllocationSize && internals::HasAllocateAtLeast_v<Alloc>)
+   {
+      const auto res = m_alloc.allocate_at_least(cap);
+      mem = res.ptr;
+      cap = res.count;
+   }
+   else
+   {
+      mem = AllocTraits::allocate(m_alloc, cap);
+   }
    if (!mem)
       throw std::runtime_error("SboVector - Failed to allocate memory.");
 
 #ifdef SBOVEC_MEM_INSTR
-   m_allocatedCap += cap;
+   m_memInstr.allocatedCap.fetch_add(cap, std::memory_order_relaxed);
+   m_memInstr.numAllocs.fetch_add(1, std::memory_order_relaxed);
 #endif // SBOVEC_MEM_INSTR
 
    return mem;
 }
 
 
-template <typename T, std::size_t N>
-void SboVector<T, N>::deallocateMem(T* mem, std::size_t cap)
+template <typename T, std::size_t N, typename Alloc, typename Growth>
+void SboVector<T, N, Alloc, Growth>::deallocateMem(T* mem, std::size_t cap)
 {
-#ifdef VS_COMPILER
-   _aligned_free(mem);
-#else
-   std::free(mem);
-#endif
+   AllocTraits::deallocate(m_alloc, mem, cap);
 
 #ifdef SBOVEC_MEM_INSTR
-   m_allocatedCap -= cap;
+   m_memInstr.allocatedCap.fetch_sub(cap, std::memory_order_relaxed);
+   m_memInstr.numDeallocs.fetch_add(1, std::memory_order_relaxed);
+#endif // SBOVEC_MEM_INSTR
+}
+
+
+template <typename T, std::size_t N, typename Alloc, typename Growth>
+void SboVector<T, N, Alloc, Growth>::recordStorageChange(bool fromHeap,
+                                                         bool toHeap) noexcept
+{
+#ifdef SBOVEC_MEM_INSTR
+   if (!fromHeap && toHeap)
+      m_memInstr.numSpills.fetch_add(1, std::memory_order_relaxed);
+   else if (fromHeap && toHeap)
+      m_memInstr.numReallocs.fetch_add(1, std::memory_order_relaxed);
+   else if (fromHeap && !toHeap)
+      m_memInstr.numReturns.fetch_add(1, std::memory_order_relaxed);
 #else
-   (void)cap;
+   (void)fromHeap;
+   (void)toHeap;
 #endif // SBOVEC_MEM_INSTR
 }
 
 
+template <typename T, std::size_t N, typename Alloc, typename Growth>
+void SboVector<T, N, Alloc, Growth>::recordSize() noexcept
+{
+#ifdef SBOVEC_MEM_INSTR
+   m_peakSize = std::max(m_peakSize, m_size);
+#endif // SBOVEC_MEM_INSTR
+}
+
+
+template <typename T, std::size_t N, typename Alloc, typename Growth>
+void SboVector<T, N, Alloc, Growth>::recordPeakSize() noexcept
+{
+#ifdef SBOVEC_MEM_INSTR
+   const std::size_t bucket = SboVectorMemStats::peakSizeBucket(m_peakSize);
+   m_memInstr.peakSizes[bucket].fetch_add(1, std::memory_order_relaxed);
+#endif // SBOVEC_MEM_INSTR
+}
+
+
+#ifdef SBOVEC_MEM_INSTR
+
+template <typename T, std::size_t N, typename Alloc, typename Growth>
+SboVectorMemStats SboVector<T, N, Alloc, Growth>::memStats() noexcept
+{
+   // The counters are read individually, so the snapshot is not guaranteed to be
+   // consistent across counters while other threads modify vectors.
+   SboVectorMemStats stats;
+   stats.allocatedCapacity = m_memInstr.allocatedCap.load(std::memory_order_relaxed);
+   stats.numAllocations = m_memInstr.numAllocs.load(std::memory_order_relaxed);
+   stats.numDeallocations = m_memInstr.numDeallocs.load(std::memory_order_relaxed);
+   stats.numReallocations = m_memInstr.numReallocs.load(std::memory_order_relaxed);
+   stats.numSpills = m_memInstr.numSpills.load(std::memory_order_relaxed);
+   stats.numReturns = m_memInstr.numReturns.load(std::memory_order_relaxed);
+   for (std::size_t i = 0; i < SboVectorMemStats::NumPeakSizeBuckets; ++i)
+      stats.peakSizes[i] = m_memInstr.peakSizes[i].load(std::memory_order_relaxed);
+   return stats;
+}
+
+
+template <typename T, std::size_t N, typename Alloc, typename Growth>
+void SboVector<T, N, Alloc, Growth>::resetMemStats() noexcept
+{
+   m_memInstr.allocatedCap.store(0, std::memory_order_relaxed);
+   m_memInstr.numAllocs.store(0, std::memory_order_relaxed);
+   m_memInstr.numDeallocs.store(0, std::memory_order_relaxed);
+   m_memInstr.numReallocs.store(0, std::memory_order_relaxed);
+   m_memInstr.numSpills.store(0, std::memory_order_relaxed);
+   m_memInstr.numReturns.store(0, std::memory_order_relaxed);
+   for (auto& count : m_memInstr.peakSizes)
+      count.store(0, std::memory_order_relaxed);
+}
+
+
+template <typename T, std::size_t N, typename Alloc, typename Growth>
+int64_t SboVector<T, N, Alloc, Growth>::allocatedCapacity() noexcept
+{
+   return m_memInstr.allocatedCap.load(std::memory_order_relaxed);
+}
+
+
+template <typename T, std::size_t N, typename Alloc, typename Growth>
+void SboVector<T, N, Alloc, Growth>::resetAllocatedCapacity() noexcept
+{
+   m_memInstr.allocatedCap.store(0, std::memory_order_relaxed);
+}
+
+#endif // SBOVEC_MEM_INSTR
+
+
 ///////////////////
 
-template <typename T, std::size_t N>
-bool operator==(const SboVector<T, N>& a, const SboVector<T, N>& b)
+template <typename T, std::size_t N, typename Alloc, typename Growth>
+bool operator==(const SboVector<T, N, Alloc, Growth>& a,
+                const SboVector<T, N, Alloc, Growth>& b)
 {
    return a.size() == b.size() && std::equal(a.begin(), a.end(), b.begin());
 }
 
 
-template <typename T, std::size_t N>
-bool operator!=(const SboVector<T, N>& a, const SboVector<T, N>& b)
+template <typename T, std::size_t N, typename Alloc, typename Growth>
+bool operator!=(const SboVector<T, N, Alloc, Growth>& a,
+                const SboVector<T, N, Alloc, Growth>& b)
 {
    return !(a == b);
 }
 
 
-template <typename T, std::size_t N>
-bool operator<(const SboVector<T, N>& a, const SboVector<T, N>& b)
+template <typename T, std::size_t N, typename Alloc, typename Growth>
+bool operator<(const SboVector<T, N, Alloc, Growth>& a,
+               const SboVector<T, N, Alloc, Growth>& b)
 {
    return std::lexicographical_compare(a.begin(), a.end(), b.begin(), b.end());
 }
 
 
-template <typename T, std::size_t N>
-bool operator>(const SboVector<T, N>& a, const SboVector<T, N>& b)
+template <typename T, std::size_t N, typename Alloc, typename Growth>
+bool operator>(const SboVector<T, N, Alloc, Growth>& a,
+               const SboVector<T, N, Alloc, Growth>& b)
 {
    return b < a;
 }
 
 
-template <typename T, std::size_t N>
-bool operator<=(const SboVector<T, N>& a, const SboVector<T, N>& b)
+template <typename T, std::size_t N, typename Alloc, typename Growth>
+bool operator<=(const SboVector<T, N, Alloc, Growth>& a,
+                const SboVector<T, N, Alloc, Growth>& b)
 {
    return !(a > b);
 }
 
 
-template <typename T, std::size_t N>
-bool operator>=(const SboVector<T, N>& a, const SboVector<T, N>& b)
+template <typename T, std::size_t N, typename Alloc, typename Growth>
+bool operator>=(const SboVector<T, N, Alloc, Growth>& a,
+                const SboVector<T, N, Alloc, Growth>& b)
 {
    return !(a < b);
 }
 
 
-template <typename T, std::size_t N> void swap(SboVector<T, N>& a, SboVector<T, N>& b)
+template <typename T, std::size_t N, typename Alloc, typename Growth>
+void swap(SboVector<T, N, Alloc, Growth>& a, SboVector<T, N, Alloc, Growth>& b)
 {
    a.swap(b);
 }
 
 
+namespace pmr
+{
+// SboVector that allocates its heap memory from a std::pmr::memory_resource, e.g.
+// from a std::pmr::monotonic_buffer_resource.
+template <typename T, std::size_t N, typename Growth = DoublingGrowth>
+using SboVector = ds::SboVector<T, N, std::pmr::polymorphic_allocator<T>, Growth>;
+} // namespace pmr
+
+
 ///////////////////
 
 // Const iterator for SboVector.
 template <typename T, std::size_t N> class SboVectorConstIterator
 {
-   template <typename T, std::size_t N> friend class SboVector;
+   template <typename T, std::size_t N, typename Alloc, typename Growth>
+   friend class SboVector;
+   template <typename T, std::size_t N, typename Alloc, typename Growth>
+   friend class CompactSboVector;
 
  public:
    using SV = SboVector<T, N>;
@@ -1463,7 +2052,10 @@ SboVectorConstIterator<T, N>::operator-=(difference_type offset)
 template <typename T, std::size_t N>
 class SboVectorIterator : public SboVectorConstIterator<T, N>
 {
-   template <typename T, std::size_t N> friend class SboVector;
+   template <typename T, std::size_t N, typename Alloc, typename Growth>
+   friend class SboVector;
+   template <typename T, std::size_t N, typename Alloc, typename Growth>
+   friend class CompactSboVector;
 
  public:
    using SboVectorConstIterator<T, N>::SV;
@@ -1666,4 +2258,18 @@ SboVectorIterator<T, N>& SboVectorIterator<T, N>::operator-=(difference_type off
    return *this;
 }
 
+
+///////////////////
+
+// SboVector stores its elements contiguously.
+template <typename T, std::size_t N>
+struct IsContiguousIterator<SboVectorIterator<T, N>> : std::true_type
+{
+};
+
+template <typename T, std::size_t N>
+struct IsContiguousIterator<SboVectorConstIterator<T, N>> : std::true_type
+{
+};
+
 } // namespace ds
@@ -0,0 +1,347 @@
+#pragma once
+#include "RingBuffer.h"
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+
+namespace ds
+{
+///////////////////
+
+// Associative operations for SlidingWindowAggregate.
+
+template <typename T> struct MinOp
+{
+   T operator()(const T& a, const T& b) const { return std::min(a, b); }
+};
+
+template <typename T> struct MaxOp
+{
+   T operator()(const T& a, const T& b) const { return std::max(a, b); }
+};
+
+
+///////////////////
+
+// Window over the last N pushed values that keeps statistics of the values up to date
+// with O(1) work per push instead of recomputing them for each query.
+// The sum is accumulated in the element type. The mean and variance are maintained
+// with Welford's algorithm that is numerically stable for adding and removing values.
+// Min and max are tracked with monotonic deques whose fronts hold the current extrema.
+template <typename T, std::size_t N> class SlidingWindowStats
+{
+   static_assert(std::is_arithmetic_v<T>, "Element type must be arithmetic.");
+   static_assert(N > 0, "Window needs to hold elements.");
+
+ public:
+   using value_type = T;
+   using size_type = std::size_t;
+   using Window = RingBuffer<T, N>;
+
+ public:
+   size_type size() const noexcept { return m_window.size(); }
+   constexpr size_type capacity() const noexcept { return N; }
+   bool empty() const noexcept { return m_window.empty(); }
+   bool full() const noexcept { return m_window.full(); }
+   // The values in the window from oldest to newest.
+   const Window& window() const noexcept { return m_window; }
+
+   // Pushes a value and drops the oldest value once the window is full.
+   void push(T val);
+   // Removes the oldest value.
+   T pop_front();
+   void clear();
+
+   T sum() const noexcept { return m_sum; }
+   // Throws if the window is empty.
+   double mean() const;
+   T min() const;
+   T max() const;
+   // Population variance of the values.
+   double variance() const;
+   // Sample variance of the values. Throws for less than two values.
+   double sample_variance() const;
+
+ private:
+   // Window value together with its position, so that the deques can tell when their
+   // front value leaves the window.
+   struct Entry
+   {
+      T val;
+      uint64_t pos;
+   };
+   using Deque = RingBuffer<Entry, N>;
+
+   // Removes the values from the back of the deque that are not kept when the given
+   // value enters it, i.e. values that are worse than the given value for the whole
+   // time that both are in the window.
+   template <typename Better> static void enter(Deque& deque, const Entry& entry);
+   static void leave(Deque& deque, uint64_t pos);
+
+ private:
+   Window m_window;
+   // Position of the oldest value.
+   uint64_t m_start = 0;
+   T m_sum = T{};
+   double m_mean = 0.;
+   // Sum of squared differences from the mean.
+   double m_m2 = 0.;
+   // Increasing values from the oldest to the newest value. The front is the minimum.
+   Deque m_mins;
+   // Decreasing values from the oldest to the newest value. The front is the maximum.
+   Deque m_maxs;
+};
+
+
+template <typename T, std::size_t N> void SlidingWindowStats<T, N>::push(T val)
+{
+   if (full())
+      pop_front();
+
+   const Entry entry{val, m_start + size()};
+   m_window.push(val);
+
+   m_sum += val;
+   const double delta = static_cast<double>(val) - m_mean;
+   m_mean += delta / static_cast<double>(size());
+   m_m2 += delta * (static_cast<double>(val) - m_mean);
+
+   enter<std::less<T>>(m_mins, entry);
+   enter<std::greater<T>>(m_maxs, entry);
+}
+
+
+template <typename T, std::size_t N> T SlidingWindowStats<T, N>::pop_front()
+{
+   if (empty())
+      throw std::runtime_error("Popping from empty sliding window.");
+
+   const T val = m_window.pop_front();
+   m_sum -= val;
+   if (empty())
+   {
+      // Avoid keeping rounding errors around.
+      m_sum = T{};
+      m_mean = 0.;
+      m_m2 = 0.;
+   }
+   else
+   {
+      const double delta = static_cast<double>(val) - m_mean;
+      m_mean -= delta / static_cast<double>(size());
+      m_m2 = std::max(m_m2 - delta * (static_cast<double>(val) - m_mean), 0.);
+   }
+
+   leave(m_mins, m_start);
+   leave(m_maxs, m_start);
+   ++m_start;
+   return val;
+}
+
+
+template <typename T, std::size_t N> void SlidingWindowStats<T, N>::clear()
+{
+   m_window.clear();
+   m_mins.clear();
+   m_maxs.clear();
+   m_start = 0;
+   m_sum = T{};
+   m_mean = 0.;
+   m_m2 = 0.;
+}
+
+
+template <typename T, std::size_t N> double SlidingWindowStats<T, N>::mean() const
+{
+   if (empty())
+      throw std::runtime_error("Mean of empty sliding window.");
+   return m_mean;
+}
+
+
+template <typename T, std::size_t N> T SlidingWindowStats<T, N>::min() const
+{
+   if (empty())
+      throw std::runtime_error("Minimum of empty sliding window.");
+   return m_mins[0].val;
+}
+
+
+template <typename T, std::size_t N> T SlidingWindowStats<T, N>::max() const
+{
+   if (empty())
+      throw std::runtime_error("Maximum of empty sliding window.");
+   return m_maxs[0].val;
+}
+
+
+template <typename T, std::size_t N> double SlidingWindowStats<T, N>::variance() const
+{
+   if (empty())
+      throw std::runtime_error("Variance of empty sliding window.");
+   return m_m2 / static_cast<double>(size());
+}
+
+
+template <typename T, std::size_t N>
+double SlidingWindowStats<T, N>::sample_variance() const
+{
+   if (size() < 2)
+      throw std::runtime_error("Sample variance of less than two values.");
+   return m_m2 / static_cast<double>(size() - 1);
+}
+
+
+template <typename T, std::size_t N>
+template <typename Better>
+void SlidingWindowStats<T, N>::enter(Deque& deque, const Entry& entry)
+{
+   // Each value enters and leaves the deque once, so pushing is amortized O(1).
+   while (!deque.empty() && !Better{}(deque[deque.size() - 1].val, entry.val))
+      deque.pop();
+   deque.push(entry);
+}
+
+
+template <typename T, std::size_t N>
+void SlidingWindowStats<T, N>::leave(Deque& deque, uint64_t pos)
+{
+   if (!deque.empty() && deque[0].pos == pos)
+      deque.pop_front();
+}
+
+
+///////////////////
+
+// Window over the last N pushed values that keeps the aggregate of the values under an
+// associative operation up to date, e.g. MinOp, MaxOp, std::plus or a custom operation.
+// The operation does not need to be commutative or invertible.
+// Uses the two-stacks technique. The older values of the window form the front stack
+// that holds the aggregates of each of its values with all newer front values. The newer
+// values form the back stack whose aggregate is kept as a single value. Removing the
+// oldest value pops the front stack. Once it is empty, all values move to the front
+// stack. Each value moves once, so pushing is amortized O(1) applications of the
+// operation, and querying applies it at most once.
+template <typename T, std::size_t N, typename Op> class SlidingWindowAggregate
+{
+   static_assert(N > 0, "Window needs to hold elements.");
+
+ public:
+   using value_type = T;
+   using size_type = std::size_t;
+   using Window = RingBuffer<T, N>;
+
+ public:
+   SlidingWindowAggregate() = default;
+   explicit SlidingWindowAggregate(Op op);
+
+   size_type size() const noexcept { return m_window.size(); }
+   constexpr size_type capacity() const noexcept { return N; }
+   bool empty() const noexcept { return m_window.empty(); }
+   bool full() const noexcept { return m_window.full(); }
+   // The values in the window from oldest to newest.
+   const Window& window() const noexcept { return m_window; }
+
+   // Pushes a value and drops the oldest value once the window is full.
+   void push(const T& val);
+   // Removes the oldest value.
+   T pop_front();
+   void clear();
+
+   // Aggregate of the values from oldest to newest. Throws if the window is empty.
+   T aggregate() const;
+
+ private:
+   // Moves all values to the front stack.
+   void flip();
+
+ private:
+   Op m_op{};
+   Window m_window;
+   // Aggregates of the front values with all newer front values. Used as a stack with
+   // the oldest value's aggregate on top.
+   RingBuffer<T, N> m_front;
+   // Aggregate of the back values. Empty if there are no back values.
+   std::optional<T> m_back;
+};
+
+
+template <typename T, std::size_t N, typename Op>
+SlidingWindowAggregate<T, N, Op>::SlidingWindowAggregate(Op op) : m_op{std::move(op)}
+{
+}
+
+
+template <typename T, std::size_t N, typename Op>
+void SlidingWindowAggregate<T, N, Op>::push(const T& val)
+{
+   if (full())
+      pop_front();
+
+   m_window.push(val);
+   if (m_back)
+      m_back = m_op(*m_back, val);
+   else
+      m_back = val;
+}
+
+
+template <typename T, std::size_t N, typename Op>
+T SlidingWindowAggregate<T, N, Op>::pop_front()
+{
+   if (empty())
+      throw std::runtime_error("Popping from empty sliding window.");
+
+   if (m_front.empty())
+      flip();
+   m_front.pop();
+   return m_window.pop_front();
+}
+
+
+template <typename T, std::size_t N, typename Op>
+void SlidingWindowAggregate<T, N, Op>::clear()
+{
+   m_window.clear();
+   m_front.clear();
+   m_back.reset();
+}
+
+
+template <typename T, std::size_t N, typename Op>
+T SlidingWindowAggregate<T, N, Op>::aggregate() const
+{
+   if (empty())
+      throw std::runtime_error("Aggregate of empty sliding window.");
+
+   if (m_front.empty())
+      return *m_back;
+   const T& front = m_front[m_front.size() - 1];
+   return m_back ? m_op(front, *m_back) : front;
+}
+
+
+template <typename T, std::size_t N, typename Op>
+void SlidingWindowAggregate<T, N, Op>::flip()
+{
+   // Aggregate from the newest to the oldest value, so that the oldest value's
+   // aggregate ends up on top. Keeps the order of the operands for non-commutative
+   // operations.
+   auto it = m_window.rbegin();
+   T accum = *it;
+   m_front.push(accum);
+   for (++it; it != m_window.rend(); ++it)
+   {
+      accum = m_op(*it, accum);
+      m_front.push(accum);
+   }
+   m_back.reset();
+}
+
+} // namespace ds
@@ -0,0 +1,328 @@
+#pragma once
+#include "Concurrency.h"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+
+
+namespace ds
+{
+///////////////////
+
+// Lock-free ring buffer of fixed size N for one producer thread and one consumer
+// thread.
+// The producer thread calls the push functions and the consumer thread calls the pop
+// functions. The other functions can be called from both threads but only give a
+// snapshot of the state.
+// Unlike RingBuffer, pushing into a full buffer fails instead of overwriting the oldest
+// element. The producer must never touch elements that the consumer might be reading.
+// The blocking functions retry until they succeed, spinning briefly and then yielding
+// the thread.
+// Each thread owns one index and only reads the index of the other thread. Each
+// thread also caches the last seen value of the other thread's index, so that the
+// shared cache line only needs to be read once the cached value is used up.
+template <typename T, std::size_t N> class SpscRingBuffer
+{
+   static_assert(std::is_default_constructible_v<T>,
+                 "Element type must be default-constructible.");
+   static_assert(std::is_move_assignable_v<T>, "Element type must be move-assignable.");
+
+ private:
+   // The internal std::array has one additional element that serves as one-past-the-end
+   // position. This allows to tell a full buffer from an empty one by the indices alone.
+   static constexpr std::size_t M = N + 1;
+   using BufferType = std::array<T, M>;
+
+ public:
+   using value_type = T;
+   using size_type = typename BufferType::size_type;
+   using reference = T&;
+   using const_reference = const T&;
+   using pointer = T*;
+   using const_pointer = const T*;
+
+ public:
+   SpscRingBuffer() = default;
+   ~SpscRingBuffer() = default;
+   SpscRingBuffer(const SpscRingBuffer&) = delete;
+   SpscRingBuffer& operator=(const SpscRingBuffer&) = delete;
+   SpscRingBuffer(SpscRingBuffer&&) = delete;
+   SpscRingBuffer& operator=(SpscRingBuffer&&) = delete;
+
+   size_type size() const noexcept;
+   constexpr size_type capacity() const noexcept;
+   bool empty() const noexcept;
+   bool full() const noexcept;
+
+   // Producer interface.
+   // Waits until there is space.
+   void push(const T& val);
+   void push(T&& val);
+   // Returns false if the buffer is full.
+   bool try_push(const T& val);
+   bool try_push(T&& val);
+   // Pushes as many of the given count of elements as fit into the buffer. Returns the
+   // number of pushed elements. The elements become visible to the consumer all at
+   // once.
+   template <typename Iter> size_type try_push_n(Iter first, size_type count);
+   // Number of elements that the try functions rejected because the buffer was full.
+   // Elements that are pushed again after being rejected are counted again.
+   uint64_t num_dropped() const noexcept;
+
+   // Consumer interface.
+   // Waits until there is an element.
+   T pop();
+   // Returns false if the buffer is empty.
+   bool try_pop(T& val);
+   // Pops up to the given count of elements into the output iterator. Returns the
+   // number of popped elements.
+   template <typename OutIter> size_type try_pop_n(OutIter out, size_type count);
+
+ private:
+   using Index = size_type;
+
+   static constexpr Index next(Index idx) noexcept;
+   static constexpr Index advance(Index idx, size_type n) noexcept;
+   static constexpr size_type distance(Index from, Index to) noexcept;
+
+   template <typename U> bool pushValue(U&& val);
+   void countDropped(size_type count) noexcept;
+   // Returns the number of slots that the producer can populate. Only reads the
+   // consumer's index if the cached copy shows fewer than the wanted number.
+   size_type freeForProducer(Index end, size_type wanted);
+   // Returns the number of elements that the consumer can pop. Only reads the
+   // producer's index if the cached copy shows fewer than the wanted number.
+   size_type availableForConsumer(Index start, size_type wanted);
+
+ private:
+   // Index of the first (oldest) element. Written by the consumer.
+   alignas(internals::CacheLineSize) std::atomic<Index> m_start = 0;
+   // The consumer's copy of the end index.
+   Index m_cachedEnd = 0;
+   // Index of the one-past-the-last element. Written by the producer.
+   alignas(internals::CacheLineSize) std::atomic<Index> m_end = 0;
+   // The producer's copy of the start index.
+   Index m_cachedStart = 0;
+   // Written by the producer only. Atomic to allow reading it from other threads.
+   std::atomic<uint64_t> m_numDropped = 0;
+   alignas(internals::CacheLineSize) BufferType m_buffer{};
+};
+
+
+template <typename T, std::size_t N>
+typename SpscRingBuffer<T, N>::size_type SpscRingBuffer<T, N>::size() const noexcept
+{
+   const Index start = m_start.load(std::memory_order_acquire);
+   const Index end = m_end.load(std::memory_order_acquire);
+   return distance(start, end);
+}
+
+
+template <typename T, std::size_t N>
+constexpr typename SpscRingBuffer<T, N>::size_type
+SpscRingBuffer<T, N>::capacity() const noexcept
+{
+   return N;
+}
+
+
+template <typename T, std::size_t N> bool SpscRingBuffer<T, N>::empty() const noexcept
+{
+   return size() == 0;
+}
+
+
+template <typename T, std::size_t N> bool SpscRingBuffer<T, N>::full() const noexcept
+{
+   return size() == N;
+}
+
+
+template <typename T, std::size_t N> void SpscRingBuffer<T, N>::push(const T& val)
+{
+   internals::Backoff backoff;
+   while (!pushValue(val))
+      backoff.pause();
+}
+
+
+template <typename T, std::size_t N> void SpscRingBuffer<T, N>::push(T&& val)
+{
+   // The value is only moved from once it gets pushed.
+   internals::Backoff backoff;
+   while (!pushValue(std::move(val)))
+      backoff.pause();
+}
+
+
+template <typename T, std::size_t N> bool SpscRingBuffer<T, N>::try_push(const T& val)
+{
+   if (pushValue(val))
+      return true;
+   countDropped(1);
+   return false;
+}
+
+
+template <typename T, std::size_t N> bool SpscRingBuffer<T, N>::try_push(T&& val)
+{
+   if (pushValue(std::move(val)))
+      return true;
+   countDropped(1);
+   return false;
+}
+
+
+template <typename T, std::size_t N>
+template <typename Iter>
+typename SpscRingBuffer<T, N>::size_type
+SpscRingBuffer<T, N>::try_push_n(Iter first, size_type count)
+{
+   const Index end = m_end.load(std::memory_order_relaxed);
+   const size_type numPushed = std::min(count, freeForProducer(end, count));
+
+   // Populate the slots up to the end of the storage and then the wrapped slots.
+   const size_type numAtEnd = std::min(numPushed, M - end);
+   for (size_type i = 0; i < numAtEnd; ++i, ++first)
+      m_buffer[end + i] = *first;
+   for (size_type i = 0; i < numPushed - numAtEnd; ++i, ++first)
+      m_buffer[i] = *first;
+
+   m_end.store(advance(end, numPushed), std::memory_order_release);
+   countDropped(count - numPushed);
+   return numPushed;
+}
+
+
+template <typename T, std::size_t N>
+uint64_t SpscRingBuffer<T, N>::num_dropped() const noexcept
+{
+   return m_numDropped.load(std::memory_order_relaxed);
+}
+
+
+template <typename T, std::size_t N> T SpscRingBuffer<T, N>::pop()
+{
+   T val;
+   internals::Backoff backoff;
+   while (!try_pop(val))
+      backoff.pause();
+   return val;
+}
+
+
+template <typename T, std::size_t N> bool SpscRingBuffer<T, N>::try_pop(T& val)
+{
+   const Index start = m_start.load(std::memory_order_relaxed);
+   if (availableForConsumer(start, 1) == 0)
+      return false;
+
+   val = std::move(m_buffer[start]);
+   m_start.store(next(start), std::memory_order_release);
+   return true;
+}
+
+
+template <typename T, std::size_t N>
+template <typename OutIter>
+typename SpscRingBuffer<T, N>::size_type
+SpscRingBuffer<T, N>::try_pop_n(OutIter out, size_type count)
+{
+   const Index start = m_start.load(std::memory_order_relaxed);
+   const size_type numPopped = std::min(count, availableForConsumer(start, count));
+
+   const size_type numAtEnd = std::min(numPopped, M - start);
+   out = std::move(m_buffer.begin() + start, m_buffer.begin() + start + numAtEnd, out);
+   std::move(m_buffer.begin(), m_buffer.begin() + (numPopped - numAtEnd), out);
+
+   m_start.store(advance(start, numPopped), std::memory_order_release);
+   return numPopped;
+}
+
+
+template <typename T, std::size_t N>
+constexpr typename SpscRingBuffer<T, N>::Index
+SpscRingBuffer<T, N>::next(Index idx) noexcept
+{
+   return (idx + 1 == M) ? 0 : idx + 1;
+}
+
+
+template <typename T, std::size_t N>
+constexpr typename SpscRingBuffer<T, N>::Index
+SpscRingBuffer<T, N>::advance(Index idx, size_type n) noexcept
+{
+   // Both values are smaller than M, so a single subtraction is enough to wrap.
+   const Index advanced = idx + n;
+   return (advanced >= M) ? advanced - M : advanced;
+}
+
+
+template <typename T, std::size_t N>
+constexpr typename SpscRingBuffer<T, N>::size_type
+SpscRingBuffer<T, N>::distance(Index from, Index to) noexcept
+{
+   return (to >= from) ? to - from : to + M - from;
+}
+
+
+template <typename T, std::size_t N>
+template <typename U>
+bool SpscRingBuffer<T, N>::pushValue(U&& val)
+{
+   const Index end = m_end.load(std::memory_order_relaxed);
+   if (freeForProducer(end, 1) == 0)
+      return false;
+
+   m_buffer[end] = std::forward<U>(val);
+   // Publishes the element to the consumer.
+   m_end.store(next(end), std::memory_order_release);
+   return true;
+}
+
+
+template <typename T, std::size_t N>
+void SpscRingBuffer<T, N>::countDropped(size_type count) noexcept
+{
+   // Only the producer writes the counter, so it does not need a read-modify-write
+   // operation.
+   if (count > 0)
+      m_numDropped.store(m_numDropped.load(std::memory_order_relaxed) + count,
+                         std::memory_order_relaxed);
+}
+
+
+template <typename T, std::size_t N>
+typename SpscRingBuffer<T, N>::size_type
+SpscRingBuffer<T, N>::freeForProducer(Index end, size_type wanted)
+{
+   size_type numFree = N - distance(m_cachedStart, end);
+   if (numFree < wanted)
+   {
+      // Acquiring the index makes sure that the consumer is done with the freed slots.
+      m_cachedStart = m_start.load(std::memory_order_acquire);
+      numFree = N - distance(m_cachedStart, end);
+   }
+   return numFree;
+}
+
+
+template <typename T, std::size_t N>
+typename SpscRingBuffer<T, N>::size_type
+SpscRingBuffer<T, N>::availableForConsumer(Index start, size_type wanted)
+{
+   size_type numAvailable = distance(start, m_cachedEnd);
+   if (numAvailable < wanted)
+   {
+      // Acquiring the index makes the published elements visible.
+      m_cachedEnd = m_end.load(std::memory_order_acquire);
+      numAvailable = distance(start, m_cachedEnd);
+   }
+   return numAvailable;
+}
+
+} // namespace ds
@@ -1,5 +1,6 @@
 #pragma once
 #include <iterator>
+#include <memory>
 #include <type_traits>
 
 
@@ -20,4 +21,44 @@ template <typename T> struct IsIterator : std::bool_constant<IsIterator_v<T>>
 {
 };
 
+
+///////////////////
+
+// Marks iterators whose elements are stored contiguously in memory, so that ranges
+// can be processed as raw memory. Covers pointers and iterators modeling
+// std::contiguous_iterator. Other iterator types can opt in by specializing
+// IsContiguousIterator for them.
+template <typename T>
+struct IsContiguousIterator
+: std::bool_constant<std::is_pointer_v<T> || std::contiguous_iterator<T>>
+{
+};
+
+template <typename T>
+inline constexpr bool IsContiguousIterator_v = IsContiguousIterator<T>::value;
+
+
+///////////////////
+
+// Marks types whose objects can be relocated, i.e. moved to a new memory location
+// with the source object ceasing to exist, by simply copying their bytes.
+// Trivially copyable types are trivially relocatable. Other types can opt in by
+// specializing IsTriviallyRelocatable for them, e.g.
+//   template <> struct ds::IsTriviallyRelocatable<MyType> : std::true_type {};
+// Only opt in types that don't store pointers or references to themselves or their
+// members and don't register their address anywhere else.
+template <typename T>
+struct IsTriviallyRelocatable : std::bool_constant<std::is_trivially_copyable_v<T>>
+{
+};
+
+// std::unique_ptr with the default deleter only holds a pointer to the managed object.
+template <typename T>
+struct IsTriviallyRelocatable<std::unique_ptr<T, std::default_delete<T>>> : std::true_type
+{
+};
+
+template <typename T>
+inline constexpr bool IsTriviallyRelocatable_v = IsTriviallyRelocatable<T>::value;
+
 } // namespace ds
@@ -0,0 +1,528 @@
+#pragma once
+#include "PerfCounters.h"
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <iomanip>
+#include <initializer_list>
+#include <iostream>
+#include <memory>
+#include <numeric>
+#include <random>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+
+namespace bench
+{
+
+///////////////////
+
+// Prevents the compiler from optimizing away the computation of a value.
+template <typename T> void doNotOptimize(const T& val)
+{
+#if defined(_MSC_VER)
+   // Visual Studio does not support inline assembly for x64. Publishing the address
+   // forces the value into memory.
+   static const void* volatile sink = nullptr;
+   sink = &val;
+#else
+   asm volatile("" : : "r,m"(val) : "memory");
+#endif
+}
+
+
+///////////////////
+
+// Human-readable names for element types used in benchmark parameters.
+template <typename T> struct TypeName;
+
+// clang-format off
+template <> struct TypeName<int> { static constexpr const char* value = "int"; };
+template <> struct TypeName<int64_t> { static constexpr const char* value = "int64"; };
+template <> struct TypeName<uint8_t> { static constexpr const char* value = "uint8"; };
+template <> struct TypeName<float> { static constexpr const char* value = "float"; };
+template <> struct TypeName<double> { static constexpr const char* value = "double"; };
+template <> struct TypeName<std::string> { static constexpr const char* value = "string"; };
+// clang-format on
+
+template <typename T> inline constexpr const char* TypeName_v = TypeName<T>::value;
+
+
+///////////////////
+
+// Creates a deterministic value of a given type from an integer.
+// Strings are long enough to not fit into the small string buffer of common standard
+// library implementations.
+template <typename T> T makeValue(std::size_t i)
+{
+   if constexpr (std::is_same_v<T, std::string>)
+      return std::string(24, static_cast<char>('a' + i % 26)) + std::to_string(i);
+   else
+      return static_cast<T>(i);
+}
+
+
+// Creates a reproducible sequence of random values.
+template <typename T>
+std::vector<T> makeRandomValues(std::size_t n, unsigned int seed = 1)
+{
+   std::mt19937 gen{seed};
+   std::uniform_int_distribution<std::size_t> dist{0, 1'000'000};
+
+   std::vector<T> vals;
+   vals.reserve(n);
+   for (std::size_t i = 0; i < n; ++i)
+      vals.push_back(makeValue<T>(dist(gen)));
+   return vals;
+}
+
+
+///////////////////
+
+// Composes a parameter description in the form 'key=value'.
+template <typename Val> std::string param(std::string_view key, const Val& val)
+{
+   std::ostringstream out;
+   out << key << '=' << val;
+   return out.str();
+}
+
+// Joins multiple parameter descriptions, e.g. 'size=100/elem=int'.
+inline std::string params(std::initializer_list<std::string> descriptions)
+{
+   std::string joined;
+   for (const std::string& descr : descriptions)
+   {
+      if (!joined.empty())
+         joined += '/';
+      joined += descr;
+   }
+   return joined;
+}
+
+
+///////////////////
+
+// Statistical summary of a series of measurements.
+struct Stats
+{
+   double mean = 0.;
+   double median = 0.;
+   double p99 = 0.;
+   double stddev = 0.;
+   double min = 0.;
+   double max = 0.;
+};
+
+
+// Returns the value at a given percentile (0-100) of sorted samples using the
+// nearest-rank method.
+inline double percentile(const std::vector<double>& sorted, double pct)
+{
+   if (sorted.empty())
+      return 0.;
+
+   const double exactRank = pct / 100. * static_cast<double>(sorted.size());
+   const auto rank = static_cast<std::size_t>(std::ceil(exactRank));
+   return sorted[std::clamp<std::size_t>(rank, 1, sorted.size()) - 1];
+}
+
+
+inline Stats calcStats(std::vector<double> samples)
+{
+   Stats stats;
+   if (samples.empty())
+      return stats;
+
+   std::sort(samples.begin(), samples.end());
+   const std::size_t n = samples.size();
+   const auto numSamples = static_cast<double>(n);
+
+   stats.min = samples.front();
+   stats.max = samples.back();
+   stats.mean = std::accumulate(samples.begin(), samples.end(), 0.) / numSamples;
+   stats.median =
+      n % 2 == 1 ? samples[n / 2] : (samples[n / 2 - 1] + samples[n / 2]) / 2.;
+   stats.p99 = percentile(samples, 99.);
+
+   double sqDiffSum = 0.;
+   for (double sample : samples)
+      sqDiffSum += (sample - stats.mean) * (sample - stats.mean);
+   stats.stddev = n > 1 ? std::sqrt(sqDiffSum / (numSamples - 1.)) : 0.;
+
+   return stats;
+}
+
+
+///////////////////
+
+// Measures the duration of a scope and optionally the performance counters for it.
+class ScopedMeasurement
+{
+ public:
+   using Clock = std::chrono::steady_clock;
+
+   explicit ScopedMeasurement(double& elapsedNs, PerfCounters* counters = nullptr,
+                              CounterValues* counted = nullptr)
+   : m_elapsedNs{elapsedNs}, m_counters{counters}, m_counted{counted}
+   {
+      // Start the counters first to keep their overhead out of the time measurement.
+      if (m_counters)
+         m_counters->start();
+      m_start = Clock::now();
+   }
+   ~ScopedMeasurement()
+   {
+      const auto end = Clock::now();
+      if (m_counters && m_counted)
+         *m_counted = m_counters->stop();
+      m_elapsedNs = std::chrono::duration<double, std::nano>(end - m_start).count();
+   }
+
+   ScopedMeasurement(const ScopedMeasurement&) = delete;
+   ScopedMeasurement& operator=(const ScopedMeasurement&) = delete;
+
+ private:
+   double& m_elapsedNs;
+   PerfCounters* m_counters = nullptr;
+   CounterValues* m_counted = nullptr;
+   Clock::time_point m_start;
+};
+
+
+///////////////////
+
+struct Config
+{
+   // Number of unmeasured runs before the measurements start.
+   std::size_t warmupRuns = 2;
+   // Number of measured runs. Each run produces one sample.
+   std::size_t repetitions = 20;
+   // Only benchmarks whose name contains the filter are run.
+   std::string filter;
+   // Collect performance counters where available.
+   bool collectCounters = true;
+};
+
+
+struct Result
+{
+   // Benchmark name, e.g. 'SboVector/push_back'.
+   std::string name;
+   // Parameters of the benchmark, e.g. 'size=100/elem=int'.
+   std::string params;
+   // Number of calls of the benchmarked operation per repetition.
+   std::size_t iterations = 0;
+   std::size_t repetitions = 0;
+   // Duration of one call in nanoseconds.
+   Stats ns;
+   // Performance counters for one call. Only valid if the counter was available.
+   std::array<Stats, NumCounters> counters;
+   std::array<bool, NumCounters> hasCounter{};
+};
+
+
+///////////////////
+
+// Runs benchmarks and collects their results.
+class Runner
+{
+ public:
+   explicit Runner(Config config = {});
+
+   // Calls the benchmarked function a given number of times per repetition.
+   template <typename Fn>
+   void run(const std::string& name, const std::string& params, std::size_t iterations,
+            Fn&& fn);
+
+   // Calls the setup function before each repetition without measuring it and passes
+   // its result to the benchmarked function. Use when each call needs fresh input,
+   // e.g. unsorted data for sorting.
+   template <typename Setup, typename Fn>
+   void runWithSetup(const std::string& name, const std::string& params, Setup&& setup,
+                     Fn&& fn);
+
+   const std::vector<Result>& results() const noexcept { return m_results; }
+   bool countersAvailable() const noexcept { return m_counters != nullptr; }
+
+ private:
+   // Measurements of all repetitions of a benchmark.
+   struct Samples
+   {
+      std::vector<double> ns;
+      std::array<std::vector<double>, NumCounters> counters;
+      std::array<bool, NumCounters> hasCounter{};
+   };
+
+   bool isSelected(const std::string& name) const;
+   Samples makeSamples() const;
+   // Adds the measurement of one repetition that called the benchmarked operation a
+   // given number of times.
+   void addSample(Samples& samples, std::size_t iterations, double elapsedNs,
+                  const CounterValues& counted) const;
+   void addResult(const std::string& name, const std::string& params,
+                  std::size_t iterations, Samples samples);
+
+ private:
+   Config m_config;
+   // Only set if performance counters are available.
+   std::unique_ptr<PerfCounters> m_counters;
+   std::vector<Result> m_results;
+};
+
+
+inline Runner::Runner(Config config) : m_config{std::move(config)}
+{
+   if (m_config.collectCounters)
+   {
+      m_counters = std::make_unique<PerfCounters>();
+      if (!m_counters->available())
+         m_counters.reset();
+   }
+}
+
+
+template <typename Fn>
+void Runner::run(const std::string& name, const std::string& params,
+                 std::size_t iterations, Fn&& fn)
+{
+   if (!isSelected(name))
+      return;
+
+   iterations = std::max<std::size_t>(iterations, 1);
+
+   for (std::size_t w = 0; w < m_config.warmupRuns; ++w)
+      for (std::size_t i = 0; i < iterations; ++i)
+         fn();
+
+   Samples samples = makeSamples();
+   for (std::size_t r = 0; r < m_config.repetitions; ++r)
+   {
+      double elapsedNs = 0.;
+      CounterValues counted;
+      {
+         ScopedMeasurement measure{elapsedNs, m_counters.get(), &counted};
+         for (std::size_t i = 0; i < iterations; ++i)
+            fn();
+      }
+      addSample(samples, iterations, elapsedNs, counted);
+   }
+
+   addResult(name, params, iterations, std::move(samples));
+}
+
+
+template <typename Setup, typename Fn>
+void Runner::runWithSetup(const std::string& name, const std::string& params,
+                          Setup&& setup, Fn&& fn)
+{
+   if (!isSelected(name))
+      return;
+
+   for (std::size_t w = 0; w < m_config.warmupRuns; ++w)
+   {
+      auto input = setup();
+      fn(input);
+   }
+
+   Samples samples = makeSamples();
+   for (std::size_t r = 0; r < m_config.repetitions; ++r)
+   {
+      auto input = setup();
+      double elapsedNs = 0.;
+      CounterValues counted;
+      {
+         ScopedMeasurement measure{elapsedNs, m_counters.get(), &counted};
+         fn(input);
+      }
+      addSample(samples, 1, elapsedNs, counted);
+   }
+
+   addResult(name, params, 1, std::move(samples));
+}
+
+
+inline bool Runner::isSelected(const std::string& name) const
+{
+   return m_config.filter.empty() || name.find(m_config.filter) != std::string::npos;
+}
+
+
+inline Runner::Samples Runner::makeSamples() const
+{
+   Samples samples;
+   samples.ns.reserve(m_config.repetitions);
+   // Counters are reported if they are valid for all repetitions.
+   samples.hasCounter.fill(m_counters != nullptr);
+   return samples;
+}
+
+
+inline void Runner::addSample(Samples& samples, std::size_t iterations,
+                              double elapsedNs, const CounterValues& counted) const
+{
+   const auto numIters = static_cast<double>(iterations);
+   samples.ns.push_back(elapsedNs / numIters);
+
+   for (std::size_t i = 0; i < NumCounters; ++i)
+   {
+      samples.hasCounter[i] = samples.hasCounter[i] && counted.valid[i];
+      if (samples.hasCounter[i])
+         samples.counters[i].push_back(counted.values[i] / numIters);
+   }
+}
+
+
+inline void Runner::addResult(const std::string& name, const std::string& params,
+                              std::size_t iterations, Samples samples)
+{
+   Result res;
+   res.name = name;
+   res.params = params;
+   res.iterations = iterations;
+   res.repetitions = samples.ns.size();
+   res.ns = calcStats(std::move(samples.ns));
+   for (std::size_t i = 0; i < NumCounters; ++i)
+   {
+      res.hasCounter[i] = samples.hasCounter[i];
+      if (res.hasCounter[i])
+         res.counters[i] = calcStats(std::move(samples.counters[i]));
+   }
+   m_results.push_back(std::move(res));
+
+   // Report progress because complete runs take a while.
+   std::cerr << "Finished " << name << ' ' << params << '\n';
+}
+
+
+///////////////////
+
+// Output of results.
+// Counters are reported as the median per call of the benchmarked operation.
+
+namespace internals
+{
+
+inline bool hasAnyCounter(const std::vector<Result>& results)
+{
+   for (const Result& res : results)
+      for (bool has : res.hasCounter)
+         if (has)
+            return true;
+   return false;
+}
+
+
+inline std::string jsonEscape(const std::string& s)
+{
+   std::string escaped;
+   for (char ch : s)
+   {
+      if (ch == '"' || ch == '\\')
+         escaped += '\\';
+      escaped += ch;
+   }
+   return escaped;
+}
+
+} // namespace internals
+
+
+inline void writeText(std::ostream& out, const std::vector<Result>& results)
+{
+   const bool withCounters = internals::hasAnyCounter(results);
+
+   out << std::left << std::setw(40) << "benchmark" << std::setw(40) << "params"
+       << std::right << std::setw(14) << "median(ns)" << std::setw(14) << "p99(ns)"
+       << std::setw(14) << "stddev(ns)";
+   if (withCounters)
+      for (Counter counter : AllCounters)
+         out << std::setw(15) << counterName(counter);
+   out << '\n';
+
+   out << std::fixed << std::setprecision(1);
+   for (const Result& res : results)
+   {
+      out << std::left << std::setw(40) << res.name << std::setw(40) << res.params
+          << std::right << std::setw(14) << res.ns.median << std::setw(14) << res.ns.p99
+          << std::setw(14) << res.ns.stddev;
+      if (withCounters)
+      {
+         for (std::size_t i = 0; i < NumCounters; ++i)
+         {
+            if (res.hasCounter[i])
+               out << std::setw(15) << res.counters[i].median;
+            else
+               out << std::setw(15) << '-';
+         }
+      }
+      out << '\n';
+   }
+   out << std::defaultfloat;
+}
+
+
+inline void writeCsv(std::ostream& out, const std::vector<Result>& results)
+{
+   out << "name,params,iterations,repetitions,mean_ns,median_ns,p99_ns,stddev_ns,min_ns,"
+          "max_ns";
+   for (Counter counter : AllCounters)
+      out << ',' << counterName(counter);
+   out << '\n';
+
+   for (const Result& res : results)
+   {
+      out << res.name << ',' << res.params << ',' << res.iterations << ','
+          << res.repetitions << ',' << res.ns.mean << ',' << res.ns.median << ','
+          << res.ns.p99 << ',' << res.ns.stddev << ',' << res.ns.min << ','
+          << res.ns.max;
+      // Unavailable counters are left empty.
+      for (std::size_t i = 0; i < NumCounters; ++i)
+      {
+         out << ',';
+         if (res.hasCounter[i])
+            out << res.counters[i].median;
+      }
+      out << '\n';
+   }
+}
+
+
+inline void writeJson(std::ostream& out, const std::vector<Result>& results)
+{
+   using internals::jsonEscape;
+
+   out << "{\n  \"benchmarks\": [";
+   for (std::size_t i = 0; i < results.size(); ++i)
+   {
+      const Result& res = results[i];
+      out << (i > 0 ? ",\n" : "\n");
+      out << "    {\"name\": \"" << jsonEscape(res.name) << "\", \"params\": \""
+          << jsonEscape(res.params) << "\", \"iterations\": " << res.iterations
+          << ", \"repetitions\": " << res.repetitions << ", \"mean_ns\": " << res.ns.mean
+          << ", \"median_ns\": " << res.ns.median << ", \"p99_ns\": " << res.ns.p99
+          << ", \"stddev_ns\": " << res.ns.stddev << ", \"min_ns\": " << res.ns.min
+          << ", \"max_ns\": " << res.ns.max;
+      // Unavailable counters are null.
+      for (std::size_t c = 0; c < NumCounters; ++c)
+      {
+         out << ", \"" << counterName(AllCounters[c]) << "\": ";
+         if (res.hasCounter[c])
+            out << res.counters[c].median;
+         else
+            out << "null";
+      }
+      out << "}";
+   }
+   out << "\n  ]\n}\n";
+}
+
+} // namespace bench
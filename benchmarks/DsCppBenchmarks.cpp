@@ -0,0 +1,146 @@
+//
+// Michael Lindner
+// MIT license
+//
+#include "BenchmarkUtil.h"
+#include "HeapBenchmarks.h"
+#include "LinearAlgebraBenchmarks.h"
+#include "MathAlgBenchmarks.h"
+#include "RingBufferBenchmarks.h"
+#include "SboVectorBenchmarks.h"
+#include "SortBenchmarks.h"
+#include <charconv>
+#include <fstream>
+#include <iostream>
+#include <stdlib.h>
+#include <string>
+#include <string_view>
+
+
+namespace
+{
+
+///////////////////
+
+struct Options
+{
+   bench::Config config;
+   // Output format: text, csv or json.
+   std::string format = "text";
+   // Output file. Empty for standard output.
+   std::string outFile;
+};
+
+
+void printUsage()
+{
+   std::cout << "Usage: DsCppBenchmarks [options]\n"
+                "  --filter=<text>      Only run benchmarks whose name contains text.\n"
+                "  --format=<format>    Output format: text (default), csv or json.\n"
+                "  --out=<file>         Write results to file instead of stdout.\n"
+                "  --repetitions=<n>    Number of measured runs per benchmark (n > 0).\n"
+                "  --warmup=<n>         Number of unmeasured runs per benchmark.\n"
+                "  --no-counters        Don't collect performance counters.\n";
+}
+
+
+// Parses a non-negative number. Fails for other text instead of throwing.
+bool parseCount(std::string_view text, std::size_t& count)
+{
+   const char* end = text.data() + text.size();
+   const auto [parsedEnd, ec] = std::from_chars(text.data(), end, count);
+   return ec == std::errc{} && parsedEnd == end;
+}
+
+
+bool parseArgs(int argc, char* argv[], Options& opts)
+{
+   for (int i = 1; i < argc; ++i)
+   {
+      const std::string_view arg{argv[i]};
+      const std::size_t sep = arg.find('=');
+      const std::string_view key = arg.substr(0, sep);
+      const std::string value{sep != std::string_view::npos ? arg.substr(sep + 1) : ""};
+      bool valid = true;
+
+      if (key == "--filter")
+         opts.config.filter = value;
+      else if (key == "--format" &&
+               (value == "text" || value == "csv" || value == "json"))
+         opts.format = value;
+      else if (key == "--out")
+         opts.outFile = value;
+      else if (key == "--repetitions")
+      {
+         // Without measured runs there are no stats to report.
+         valid =
+            parseCount(value, opts.config.repetitions) && opts.config.repetitions > 0;
+      }
+      else if (key == "--warmup")
+         valid = parseCount(value, opts.config.warmupRuns);
+      else if (arg == "--no-counters")
+         opts.config.collectCounters = false;
+      else
+         valid = false;
+
+      if (!valid)
+         return false;
+   }
+   return true;
+}
+
+
+void writeResults(std::ostream& out, const Options& opts,
+                  const std::vector<bench::Result>& results)
+{
+   if (opts.format == "csv")
+      bench::writeCsv(out, results);
+   else if (opts.format == "json")
+      bench::writeJson(out, results);
+   else
+      bench::writeText(out, results);
+}
+
+} // namespace
+
+
+int main(int argc, char* argv[])
+{
+   Options opts;
+   if (!parseArgs(argc, argv, opts))
+   {
+      printUsage();
+      return EXIT_FAILURE;
+   }
+
+#ifndef NDEBUG
+   std::cerr << "Warning - Benchmarking a debug build.\n";
+#endif
+
+   bench::Runner runner{opts.config};
+   if (opts.config.collectCounters && !runner.countersAvailable())
+      std::cerr << "Performance counters are not available. Reporting times only.\n";
+   benchmarkSboVector(runner);
+   benchmarkRingBuffer(runner);
+   benchmarkHeap(runner);
+   benchmarkSort(runner);
+   benchmarkLinearAlgebra(runner);
+   benchmarkMathAlg(runner);
+
+   if (opts.outFile.empty())
+   {
+      writeResults(std::cout, opts, runner.results());
+   }
+   else
+   {
+      std::ofstream out{opts.outFile};
+      if (!out)
+      {
+         std::cerr << "Failed to open output file " << opts.outFile << ".\n";
+         return EXIT_FAILURE;
+      }
+      writeResults(out, opts, runner.results());
+   }
+
+   return EXIT_SUCCESS;
+}
@@ -0,0 +1,281 @@
+#include "HeapBenchmarks.h"
+#include "BenchmarkUtil.h"
+#include "ConcurrentPriorityQueue.h"
+#include "Heap.h"
+#include "IndexedPriorityQueue.h"
+#include "PriorityQueue.h"
+#include <algorithm>
+#include <functional>
+#include <mutex>
+#include <queue>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+using namespace ds;
+using namespace bench;
+
+
+namespace
+{
+
+///////////////////
+
+template <typename T, std::size_t Arity>
+void benchBuildHeap(Runner& runner, std::size_t numElems)
+{
+   const std::vector<T> vals = makeRandomValues<T>(numElems);
+   auto setup = [&vals]() { return vals; };
+   const std::string descr = params({param("size", numElems),
+                                     param("elem", TypeName_v<T>),
+                                     param("arity", Arity)});
+
+   runner.runWithSetup("HeapView/build", descr, setup,
+                       [](std::vector<T>& data)
+                       {
+                          MaxHeap<T, Arity> heap{data};
+                          doNotOptimize(heap.top());
+                       });
+
+   if constexpr (Arity == 2)
+   {
+      runner.runWithSetup("std::make_heap/build", descr, setup,
+                          [](std::vector<T>& data)
+                          {
+                             std::make_heap(data.begin(), data.end());
+                             doNotOptimize(data.front());
+                          });
+   }
+}
+
+
+template <typename T, std::size_t Arity>
+void benchPopAll(Runner& runner, std::size_t numElems)
+{
+   const std::vector<T> vals = makeRandomValues<T>(numElems);
+   const std::string descr = params({param("size", numElems),
+                                     param("elem", TypeName_v<T>),
+                                     param("arity", Arity)});
+
+   runner.runWithSetup(
+      "HeapView/pop_all", descr,
+      [&vals]()
+      {
+         std::vector<T> data = vals;
+         MaxHeap<T, Arity> heap{data};
+         return data;
+      },
+      [](std::vector<T>& data)
+      {
+         // The data is already a max-heap, so building the view is cheap.
+         MaxHeap<T, Arity> heap{data};
+         while (!heap.empty())
+            doNotOptimize(heap.pop());
+      });
+}
+
+
+template <typename T, std::size_t Arity>
+void benchPriorityQueue(Runner& runner, std::size_t numElems)
+{
+   const std::vector<T> vals = makeRandomValues<T>(numElems);
+   const std::string descr = params({param("size", numElems),
+                                     param("elem", TypeName_v<T>),
+                                     param("arity", Arity)});
+
+   runner.run("PriorityQueue/insert_pop", descr, 1,
+              [&vals]()
+              {
+                 PriorityQueue<T, std::less<T>, Arity> pq;
+                 for (const T& val : vals)
+                    pq.insert(val);
+                 while (!pq.empty())
+                    doNotOptimize(pq.pop());
+              });
+
+   runner.run("PriorityQueue/insert_range_pop", descr, 1,
+              [&vals]()
+              {
+                 PriorityQueue<T, std::less<T>, Arity> pq;
+                 pq.insert_range(vals.begin(), vals.end());
+                 while (!pq.empty())
+                    doNotOptimize(pq.pop());
+              });
+
+   if constexpr (Arity == 2)
+   {
+      runner.run("std::priority_queue/insert_pop", descr, 1,
+                 [&vals]()
+                 {
+                    std::priority_queue<T, std::vector<T>, std::greater<T>> pq;
+                    for (const T& val : vals)
+                       pq.push(val);
+                    while (!pq.empty())
+                    {
+                       doNotOptimize(pq.top());
+                       pq.pop();
+                    }
+                 });
+   }
+}
+
+
+// Lowers the priorities of random queued handles, e.g. as Dijkstra's algorithm does,
+// and pops all handles. Compares updating in place with inserting duplicates and
+// skipping the stale ones when popping.
+void benchDecreaseKey(Runner& runner, std::size_t numElems)
+{
+   const std::vector<int> prios = makeRandomValues<int>(numElems);
+   const std::vector<int> handles = makeRandomValues<int>(numElems, 2);
+   const std::string descr = params({param("size", numElems)});
+
+   runner.run("IndexedPriorityQueue/update_pop", descr, 1,
+              [&]()
+              {
+                 IndexedPriorityQueue<int> pq;
+                 for (std::size_t h = 0; h < numElems; ++h)
+                    pq.insert(h, prios[h]);
+                 for (int val : handles)
+                 {
+                    const std::size_t h = static_cast<std::size_t>(val) % numElems;
+                    if (pq.contains(h))
+                       pq.update(h, pq.priority(h) - 1);
+                 }
+                 while (!pq.empty())
+                    doNotOptimize(pq.pop());
+              });
+
+   runner.run("PriorityQueue/lazy_update_pop", descr, 1,
+              [&]()
+              {
+                 std::vector<int> current = prios;
+                 PriorityQueue<std::pair<int, std::size_t>> pq;
+                 for (std::size_t h = 0; h < numElems; ++h)
+                    pq.insert({prios[h], h});
+                 for (int val : handles)
+                 {
+                    const std::size_t h = static_cast<std::size_t>(val) % numElems;
+                    pq.insert({--current[h], h});
+                 }
+                 while (!pq.empty())
+                 {
+                    const auto [prio, h] = pq.pop();
+                    if (prio == current[h])
+                       doNotOptimize(h);
+                 }
+              });
+}
+
+
+// Runs threads that each push their share of the values and pop after each push, like
+// scheduler workers that add and take tasks.
+template <typename Push, typename Pop>
+void runWorkers(std::size_t numThreads, const std::vector<int>& vals, Push push, Pop pop)
+{
+   const std::size_t numPerThread = vals.size() / numThreads;
+
+   std::vector<std::thread> threads;
+   for (std::size_t t = 0; t < numThreads; ++t)
+   {
+      threads.emplace_back(
+         [&, t]()
+         {
+            for (std::size_t i = t * numPerThread; i < (t + 1) * numPerThread; ++i)
+            {
+               push(vals[i]);
+               if (i % 2 == 1)
+               {
+                  doNotOptimize(pop());
+                  doNotOptimize(pop());
+               }
+            }
+         });
+   }
+   for (auto& thread : threads)
+      thread.join();
+}
+
+
+void benchConcurrentPriorityQueue(Runner& runner, std::size_t numThreads)
+{
+   static constexpr std::size_t NumValues = 400000;
+   const std::vector<int> vals = makeRandomValues<int>(NumValues);
+   const std::string descr =
+      params({param("size", NumValues), param("threads", numThreads)});
+
+   runner.run("PriorityQueue+mutex/push_pop", descr, 1,
+              [&]()
+              {
+                 std::mutex mutex;
+                 PriorityQueue<int> pq;
+                 runWorkers(
+                    numThreads, vals,
+                    [&](int val)
+                    {
+                       std::lock_guard lock{mutex};
+                       pq.insert(val);
+                    },
+                    [&]()
+                    {
+                       std::lock_guard lock{mutex};
+                       return pq.pop();
+                    });
+              });
+
+   runner.run("ConcurrentPriorityQueue<relaxed>/push_pop", descr, 1,
+              [&]()
+              {
+                 ConcurrentPriorityQueue<int> pq{numThreads};
+                 runWorkers(
+                    numThreads, vals, [&](int val) { pq.push(val); },
+                    [&]() { return pq.pop(); });
+              });
+
+   runner.run("ConcurrentPriorityQueue<strict>/push_pop", descr, 1,
+              [&]()
+              {
+                 ConcurrentPriorityQueue<int, std::less<int>, PopOrdering::Strict> pq{
+                    numThreads, 1};
+                 runWorkers(
+                    numThreads, vals, [&](int val) { pq.push(val); },
+                    [&]() { return pq.pop(); });
+              });
+}
+
+
+template <typename T, std::size_t Arity>
+void benchHeapsWithArity(Runner& runner, std::size_t numElems)
+{
+   benchBuildHeap<T, Arity>(runner, numElems);
+   benchPopAll<T, Arity>(runner, numElems);
+   benchPriorityQueue<T, Arity>(runner, numElems);
+}
+
+
+template <typename T> void benchHeaps(Runner& runner, std::size_t numElems)
+{
+   benchHeapsWithArity<T, 2>(runner, numElems);
+   benchHeapsWithArity<T, 4>(runner, numElems);
+   benchHeapsWithArity<T, 8>(runner, numElems);
+}
+
+} // namespace
+
+
+///////////////////
+
+void benchmarkHeap(Runner& runner)
+{
+   for (std::size_t numElems : {100, 10000, 1000000})
+   {
+      benchHeaps<int>(runner, numElems);
+      benchHeaps<double>(runner, numElems);
+   }
+   for (std::size_t numElems : {100, 10000})
+      benchHeaps<std::string>(runner, numElems);
+   for (std::size_t numElems : {10000, 1000000})
+      benchDecreaseKey(runner, numElems);
+   for (std::size_t numThreads : {1, 4})
+      benchConcurrentPriorityQueue(runner, numThreads);
+}
@@ -0,0 +1,81 @@
+#include "LinearAlgebraBenchmarks.h"
+#include "BenchmarkUtil.h"
+#include "LinearAlgebra.h"
+#include "MatrixView.h"
+#include <string>
+#include <vector>
+
+using namespace ds;
+using namespace bench;
+
+
+namespace
+{
+
+///////////////////
+
+// Square matrices with row-major storage.
+template <typename Val> struct SquareMatrices
+{
+   explicit SquareMatrices(std::size_t dim)
+   : n{dim}, a{makeRandomValues<Val>(dim * dim, 1)},
+     b{makeRandomValues<Val>(dim * dim, 2)}, c(dim * dim)
+   {
+   }
+
+   MatrixView<Val> view(std::vector<Val>& m) { return {m.data(), n, 0, n - 1, 0, n - 1}; }
+
+   std::size_t n = 0;
+   std::vector<Val> a;
+   std::vector<Val> b;
+   std::vector<Val> c;
+};
+
+
+template <typename Val, typename MultiplyFn>
+void benchMultiply(Runner& runner, const std::string& name, std::size_t dim,
+                   MultiplyFn multiplyFn)
+{
+   SquareMatrices<Val> mats{dim};
+   const MatrixView<Val> a = mats.view(mats.a);
+   const MatrixView<Val> b = mats.view(mats.b);
+   MatrixView<Val> c = mats.view(mats.c);
+
+   runner.run(name, params({param("dim", dim), param("elem", TypeName_v<Val>)}), 1,
+              [&]()
+              {
+                 // The recursive algorithms accumulate into the result.
+                 c.clear();
+                 multiplyFn(a, b, c);
+                 doNotOptimize(mats.c.front());
+              });
+}
+
+
+template <typename Val> void benchMultiplyAlgorithms(Runner& runner)
+{
+   // The recursive algorithms require dimensions that are powers of two.
+   for (std::size_t dim : {16, 64, 128})
+   {
+      benchMultiply<Val>(runner, "LinearAlgebra/multiplyIterative", dim,
+                         [](const auto& a, const auto& b, auto& c)
+                         { multiplyIterative(a, b, c); });
+      benchMultiply<Val>(runner, "LinearAlgebra/multiplyRecursive", dim,
+                         [](const auto& a, const auto& b, auto& c)
+                         { multiplyRecursive(a, b, c); });
+      benchMultiply<Val>(runner, "LinearAlgebra/multiplyStrassen", dim,
+                         [](const auto& a, const auto& b, auto& c)
+                         { multiplyStrassen(a, b, c); });
+   }
+}
+
+} // namespace
+
+
+///////////////////
+
+void benchmarkLinearAlgebra(Runner& runner)
+{
+   benchMultiplyAlgorithms<int>(runner);
+   benchMultiplyAlgorithms<double>(runner);
+}
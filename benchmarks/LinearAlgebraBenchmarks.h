@@ -0,0 +1,9 @@
+#pragma once
+
+namespace bench
+{
+class Runner;
+}
+
+
+void benchmarkLinearAlgebra(bench::Runner& runner);
@@ -0,0 +1,57 @@
+#include "MathAlgBenchmarks.h"
+#include "BenchmarkUtil.h"
+#include "MathAlg.h"
+#include <string>
+#include <vector>
+
+using namespace ds;
+using namespace bench;
+
+
+namespace
+{
+
+///////////////////
+
+template <typename T> void benchFindMaxSubsequence(Runner& runner, std::size_t numElems)
+{
+   const std::vector<T> vals = makeRandomValues<T>(numElems);
+   const std::string descr =
+      params({param("size", numElems), param("elem", TypeName_v<T>)});
+
+   runner.run("MathAlg/findMaxSubsequenceIterative", descr, 1,
+              [&vals]() { doNotOptimize(findMaxSubsequenceIterative(vals).max); });
+   runner.run("MathAlg/findMaxSubsequenceRecursive", descr, 1,
+              [&vals]() { doNotOptimize(findMaxSubsequenceRecursive(vals).max); });
+}
+
+
+void benchIsPow2(Runner& runner)
+{
+   constexpr std::size_t NumValues = 1000;
+   const std::vector<int64_t> vals = makeRandomValues<int64_t>(NumValues);
+
+   runner.run("MathAlg/isPow2", param("size", NumValues), 1,
+              [&vals]()
+              {
+                 std::size_t count = 0;
+                 for (int64_t val : vals)
+                    count += isPow2(val) ? 1 : 0;
+                 doNotOptimize(count);
+              });
+}
+
+} // namespace
+
+
+///////////////////
+
+void benchmarkMathAlg(Runner& runner)
+{
+   for (std::size_t numElems : {100, 10000, 1000000})
+   {
+      benchFindMaxSubsequence<int>(runner, numElems);
+      benchFindMaxSubsequence<double>(runner, numElems);
+   }
+   benchIsPow2(runner);
+}
@@ -0,0 +1,9 @@
+#pragma once
+
+namespace bench
+{
+class Runner;
+}
+
+
+void benchmarkMathAlg(bench::Runner& runner);
@@ -0,0 +1,255 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+
+namespace bench
+{
+
+///////////////////
+
+// Events counted by the performance counters.
+enum class Counter
+{
+   Cycles,
+   Instructions,
+   CacheMisses,
+   BranchMisses,
+   PageFaults
+};
+
+inline constexpr std::size_t NumCounters = 5;
+
+inline constexpr std::array<Counter, NumCounters> AllCounters{
+   Counter::Cycles, Counter::Instructions, Counter::CacheMisses, Counter::BranchMisses,
+   Counter::PageFaults};
+
+
+inline constexpr const char* counterName(Counter counter)
+{
+   switch (counter)
+   {
+   case Counter::Cycles:
+      return "cycles";
+   case Counter::Instructions:
+      return "instructions";
+   case Counter::CacheMisses:
+      return "cache_misses";
+   case Counter::BranchMisses:
+      return "branch_misses";
+   case Counter::PageFaults:
+      return "page_faults";
+   }
+   return "";
+}
+
+
+// Counted values of one measurement.
+struct CounterValues
+{
+   std::array<double, NumCounters> values{};
+   // Counters that could not be read are invalid.
+   std::array<bool, NumCounters> valid{};
+
+   double operator[](Counter counter) const
+   {
+      return values[static_cast<std::size_t>(counter)];
+   }
+   bool isValid(Counter counter) const
+   {
+      return valid[static_cast<std::size_t>(counter)];
+   }
+};
+
+
+///////////////////
+
+// Counts hardware and software events of the calling thread between calls to start()
+// and stop(). Uses perf_event_open on Linux. Only events in user space are counted.
+// The events are opened as one group, so that they are started, stopped and read
+// together and all values cover the same instructions. The kernel schedules the group
+// as a whole, i.e. when it multiplexes the hardware counters, all events are scaled by
+// the same factor.
+// Counters are unavailable on other platforms, in many containers, and when the kernel
+// restricts access (see /proc/sys/kernel/perf_event_paranoid). Values of unavailable
+// counters are marked as invalid and the measurement itself continues to work.
+class PerfCounters
+{
+ public:
+   PerfCounters();
+   ~PerfCounters();
+   PerfCounters(const PerfCounters&) = delete;
+   PerfCounters& operator=(const PerfCounters&) = delete;
+
+   // Checks if at least one counter is available.
+   bool available() const noexcept;
+   void start() noexcept;
+   CounterValues stop() noexcept;
+
+ private:
+#ifdef __linux__
+   // File descriptors of the opened events. -1 for unavailable counters.
+   std::array<int, NumCounters> m_fds;
+   // Event that leads the group. -1 if no counter is available.
+   int m_leader = -1;
+#endif
+};
+
+
+///////////////////
+
+#ifdef __linux__
+
+namespace internals
+{
+
+// Opens an event as member of the group of the given leader. Opens the leader itself
+// if no leader is given.
+inline int openPerfEvent(std::uint32_t type, std::uint64_t config, int leader) noexcept
+{
+   perf_event_attr attr{};
+   attr.size = sizeof(attr);
+   attr.type = type;
+   attr.config = config;
+   // Members count whenever the leader counts, so only the leader starts disabled.
+   attr.disabled = (leader < 0) ? 1 : 0;
+   // Excluding the kernel allows counting with the default access restrictions.
+   attr.exclude_kernel = 1;
+   attr.exclude_hv = 1;
+   // Reading the leader returns the values of all events in the group. The times allow
+   // to scale the values if the kernel multiplexes the hardware counters.
+   attr.read_format =
+      PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+   // Count for the calling thread on any CPU.
+   return static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, leader, 0));
+}
+
+
+inline int openPerfEvent(Counter counter, int leader) noexcept
+{
+   switch (counter)
+   {
+   case Counter::Cycles:
+      return openPerfEvent(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES, leader);
+   case Counter::Instructions:
+      return openPerfEvent(PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS, leader);
+   case Counter::CacheMisses:
+      return openPerfEvent(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES, leader);
+   case Counter::BranchMisses:
+      return openPerfEvent(PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES, leader);
+   case Counter::PageFaults:
+      return openPerfEvent(PERF_TYPE_SOFTWARE, PERF_COUNT_SW_PAGE_FAULTS, leader);
+   }
+   return -1;
+}
+
+} // namespace internals
+
+
+inline PerfCounters::PerfCounters()
+{
+   // The first available event leads the group.
+   for (Counter counter : AllCounters)
+   {
+      const int fd = internals::openPerfEvent(counter, m_leader);
+      m_fds[static_cast<std::size_t>(counter)] = fd;
+      if (m_leader < 0)
+         m_leader = fd;
+   }
+}
+
+
+inline PerfCounters::~PerfCounters()
+{
+   // Close the members before the leader.
+   for (std::size_t i = NumCounters; i > 0; --i)
+      if (m_fds[i - 1] >= 0)
+         close(m_fds[i - 1]);
+}
+
+
+inline bool PerfCounters::available() const noexcept
+{
+   return m_leader >= 0;
+}
+
+
+inline void PerfCounters::start() noexcept
+{
+   if (m_leader < 0)
+      return;
+   ioctl(m_leader, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+   ioctl(m_leader, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+}
+
+
+inline CounterValues PerfCounters::stop() noexcept
+{
+   CounterValues counted;
+   if (m_leader < 0)
+      return counted;
+
+   ioctl(m_leader, PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+
+   // Layout for the chosen read format. The values are in the order in which the
+   // events joined the group.
+   struct
+   {
+      std::uint64_t numEvents;
+      std::uint64_t timeEnabled;
+      std::uint64_t timeRunning;
+      std::uint64_t values[NumCounters];
+   } data{};
+
+   const auto numRead = read(m_leader, &data, sizeof(data));
+   if (numRead < static_cast<ssize_t>(3 * sizeof(std::uint64_t)) ||
+       data.timeRunning == 0)
+   {
+      return counted;
+   }
+
+   const double scale =
+      static_cast<double>(data.timeEnabled) / static_cast<double>(data.timeRunning);
+   std::size_t groupIdx = 0;
+   for (std::size_t i = 0; i < NumCounters && groupIdx < data.numEvents; ++i)
+   {
+      if (m_fds[i] < 0)
+         continue;
+
+      counted.values[i] = static_cast<double>(data.values[groupIdx]) * scale;
+      counted.valid[i] = true;
+      ++groupIdx;
+   }
+   return counted;
+}
+
+#else // !__linux__
+
+inline PerfCounters::PerfCounters() = default;
+inline PerfCounters::~PerfCounters() = default;
+
+inline bool PerfCounters::available() const noexcept
+{
+   return false;
+}
+
+inline void PerfCounters::start() noexcept
+{
+}
+
+inline CounterValues PerfCounters::stop() noexcept
+{
+   return {};
+}
+
+#endif // __linux__
+
+} // namespace bench
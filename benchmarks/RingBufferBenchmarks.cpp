@@ -0,0 +1,522 @@
+#include "RingBufferBenchmarks.h"
+#include "BenchmarkUtil.h"
+#include "DynamicRingBuffer.h"
+#include "MirroredRingBuffer.h"
+#include "MpmcRingBuffer.h"
+#include "RingBuffer.h"
+#include "SlidingWindow.h"
+#include "SpscRingBuffer.h"
+#include <algorithm>
+#include <array>
+#include <mutex>
+#include <numeric>
+#include <span>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+using namespace ds;
+using namespace bench;
+
+
+namespace
+{
+
+///////////////////
+
+// Number of values pushed per repetition. Larger than the capacities, so that the
+// benchmarks include wrapping around and overwriting.
+constexpr std::size_t NumValues = 10000;
+
+
+template <typename T, std::size_t N> void benchPush(Runner& runner)
+{
+   const std::vector<T> vals = makeRandomValues<T>(NumValues);
+   RingBuffer<T, N> rb;
+
+   runner.run("RingBuffer/push",
+              params({param("capacity", N), param("elem", TypeName_v<T>)}), 1,
+              [&vals, &rb]()
+              {
+                 for (const T& val : vals)
+                    rb.push(val);
+                 doNotOptimize(rb);
+              });
+}
+
+
+// Same as benchPush for the heap-backed buffer with a runtime capacity.
+template <typename T, std::size_t N> void benchDynamicPush(Runner& runner)
+{
+   const std::vector<T> vals = makeRandomValues<T>(NumValues);
+   DynamicRingBuffer<T> rb(N);
+
+   runner.run("DynamicRingBuffer/push",
+              params({param("capacity", N), param("elem", TypeName_v<T>)}), 1,
+              [&vals, &rb]()
+              {
+                 for (const T& val : vals)
+                    rb.push(val);
+                 doNotOptimize(rb);
+              });
+}
+
+
+template <typename T, std::size_t N> void benchPushPop(Runner& runner)
+{
+   const std::vector<T> vals = makeRandomValues<T>(NumValues);
+   RingBuffer<T, N> rb;
+
+   runner.run("RingBuffer/push_pop",
+              params({param("capacity", N), param("elem", TypeName_v<T>)}), 1,
+              [&vals, &rb]()
+              {
+                 for (const T& val : vals)
+                 {
+                    rb.push(val);
+                    if (rb.full())
+                    {
+                       while (!rb.empty())
+                          doNotOptimize(rb.pop());
+                    }
+                 }
+              });
+}
+
+
+// Streams the values through the buffer in chunks of half the capacity.
+template <typename T, std::size_t N> void benchWriteRead(Runner& runner)
+{
+   const std::vector<T> vals = makeRandomValues<T>(NumValues);
+   std::vector<T> out(N / 2);
+   RingBuffer<T, N> rb;
+
+   runner.run("RingBuffer/write_read",
+              params({param("capacity", N), param("elem", TypeName_v<T>)}), 1,
+              [&vals, &out, &rb]()
+              {
+                 const std::span<const T> src{vals};
+                 for (std::size_t i = 0; i + out.size() <= src.size(); i += out.size())
+                 {
+                    rb.write(src.subspan(i, out.size()));
+                    rb.read(out);
+                 }
+                 doNotOptimize(out.front());
+              });
+}
+
+
+#ifdef __linux__
+// Same as benchWriteRead for the buffer with mirrored storage. Its capacity is rounded
+// up to whole pages.
+template <typename T, std::size_t N> void benchMirroredWriteRead(Runner& runner)
+{
+   const std::vector<T> vals = makeRandomValues<T>(NumValues);
+   std::vector<T> out(N / 2);
+   MirroredRingBuffer<T> rb(N);
+
+   runner.run("MirroredRingBuffer/write_read",
+              params({param("capacity", rb.capacity()), param("elem", TypeName_v<T>)}), 1,
+              [&vals, &out, &rb]()
+              {
+                 const std::span<const T> src{vals};
+                 for (std::size_t i = 0; i + out.size() <= src.size(); i += out.size())
+                 {
+                    rb.write(src.subspan(i, out.size()));
+                    rb.read(out);
+                 }
+                 doNotOptimize(out.front());
+              });
+}
+#endif
+
+
+template <typename T, std::size_t N> void benchIterate(Runner& runner)
+{
+   const std::vector<T> vals = makeRandomValues<T>(NumValues);
+   // Fill the buffer and wrap around, so that iterating crosses the end of the storage.
+   RingBuffer<T, N> rb(vals.begin(), vals.begin() + N + N / 2);
+
+   runner.run("RingBuffer/iterate",
+              params({param("capacity", N), param("elem", TypeName_v<T>)}), 10,
+              [&rb]()
+              {
+                 T sum{};
+                 for (const T& val : rb)
+                    sum += val;
+                 doNotOptimize(sum);
+              });
+}
+
+
+#ifdef __linux__
+// Same as benchIterate for the buffer with mirrored storage, whose iterators are plain
+// pointers.
+template <typename T, std::size_t N> void benchMirroredIterate(Runner& runner)
+{
+   const std::vector<T> vals = makeRandomValues<T>(NumValues);
+   MirroredRingBuffer<T> rb(N);
+   rb.write(std::span<const T>{vals.data(), rb.capacity() + rb.capacity() / 2});
+
+   runner.run("MirroredRingBuffer/iterate",
+              params({param("capacity", rb.capacity()), param("elem", TypeName_v<T>)}),
+              10,
+              [&rb]()
+              {
+                 T sum{};
+                 for (const T& val : rb)
+                    sum += val;
+                 doNotOptimize(sum);
+              });
+}
+#endif
+
+
+template <typename T, std::size_t N> void benchIndexAccess(Runner& runner)
+{
+   const std::vector<T> vals = makeRandomValues<T>(NumValues);
+   RingBuffer<T, N> rb(vals.begin(), vals.begin() + N + N / 2);
+
+   runner.run("RingBuffer/index_access",
+              params({param("capacity", N), param("elem", TypeName_v<T>)}), 10,
+              [&rb]()
+              {
+                 T sum{};
+                 for (std::size_t i = 0; i < rb.size(); ++i)
+                    sum += rb[i];
+                 doNotOptimize(sum);
+              });
+}
+
+
+// Queries sum, min and max of a window over the values after each push by iterating
+// the window. Baseline for the incrementally updated window statistics.
+template <typename T, std::size_t N> void benchRecomputeWindowStats(Runner& runner)
+{
+   const std::vector<T> vals = makeRandomValues<T>(NumValues);
+   RingBuffer<T, N> rb;
+
+   runner.run("RingBuffer/recompute_window_stats",
+              params({param("capacity", N), param("elem", TypeName_v<T>)}), 1,
+              [&vals, &rb]()
+              {
+                 for (const T& val : vals)
+                 {
+                    rb.push(val);
+                    doNotOptimize(std::accumulate(rb.begin(), rb.end(), T{}));
+                    const auto [minIt, maxIt] = std::minmax_element(rb.begin(), rb.end());
+                    doNotOptimize(*minIt);
+                    doNotOptimize(*maxIt);
+                 }
+              });
+}
+
+
+template <typename T, std::size_t N> void benchSlidingWindowStats(Runner& runner)
+{
+   const std::vector<T> vals = makeRandomValues<T>(NumValues);
+   SlidingWindowStats<T, N> stats;
+
+   runner.run("SlidingWindowStats/push_query",
+              params({param("capacity", N), param("elem", TypeName_v<T>)}), 1,
+              [&vals, &stats]()
+              {
+                 for (const T& val : vals)
+                 {
+                    stats.push(val);
+                    doNotOptimize(stats.sum());
+                    doNotOptimize(stats.min());
+                    doNotOptimize(stats.max());
+                 }
+              });
+}
+
+
+template <typename T, std::size_t N> void benchRingBuffers(Runner& runner)
+{
+   benchPush<T, N>(runner);
+   benchDynamicPush<T, N>(runner);
+   benchPushPop<T, N>(runner);
+   benchWriteRead<T, N>(runner);
+   if constexpr (std::is_arithmetic_v<T>)
+   {
+#ifdef __linux__
+      benchMirroredWriteRead<T, N>(runner);
+#endif
+      benchIterate<T, N>(runner);
+#ifdef __linux__
+      benchMirroredIterate<T, N>(runner);
+#endif
+      benchIndexAccess<T, N>(runner);
+      benchRecomputeWindowStats<T, N>(runner);
+      benchSlidingWindowStats<T, N>(runner);
+   }
+}
+
+// Number of values transferred between threads per repetition.
+constexpr std::size_t NumTransferred = 100000;
+// Number of values pushed and popped at once for batched transfers.
+constexpr std::size_t TransferBatchSize = 32;
+
+
+// Transfers values from a producer thread to the calling thread through a ring buffer
+// that is protected by a mutex. Baseline for the lock-free ring buffer.
+template <std::size_t N> void benchMutexTransfer(Runner& runner)
+{
+   runner.run("RingBuffer/mutex_transfer",
+              params({param("capacity", N), param("elem", TypeName_v<int>)}), 1,
+              []()
+              {
+                 RingBuffer<int, N> rb;
+                 std::mutex mutex;
+
+                 std::thread producer(
+                    [&rb, &mutex]()
+                    {
+                       for (std::size_t i = 0; i < NumTransferred;)
+                       {
+                          std::unique_lock lock{mutex};
+                          // The ring buffer would overwrite unconsumed values.
+                          if (rb.full())
+                          {
+                             lock.unlock();
+                             std::this_thread::yield();
+                             continue;
+                          }
+                          rb.push(static_cast<int>(i++));
+                       }
+                    });
+
+                 int sum = 0;
+                 for (std::size_t numReceived = 0; numReceived < NumTransferred;)
+                 {
+                    std::unique_lock lock{mutex};
+                    if (rb.empty())
+                    {
+                       lock.unlock();
+                       std::this_thread::yield();
+                       continue;
+                    }
+                    // The ring buffer pops its newest element. Drain it to receive
+                    // all values.
+                    while (!rb.empty())
+                    {
+                       sum += rb.pop();
+                       ++numReceived;
+                    }
+                 }
+                 producer.join();
+                 doNotOptimize(sum);
+              });
+}
+
+
+template <std::size_t N> void benchSpscTransfer(Runner& runner)
+{
+   runner.run("RingBuffer/spsc_transfer",
+              params({param("capacity", N), param("elem", TypeName_v<int>)}), 1,
+              []()
+              {
+                 SpscRingBuffer<int, N> rb;
+
+                 std::thread producer(
+                    [&rb]()
+                    {
+                       for (std::size_t i = 0; i < NumTransferred;)
+                       {
+                          if (rb.try_push(static_cast<int>(i)))
+                             ++i;
+                          else
+                             std::this_thread::yield();
+                       }
+                    });
+
+                 int sum = 0;
+                 for (std::size_t numReceived = 0; numReceived < NumTransferred;)
+                 {
+                    int val = 0;
+                    if (rb.try_pop(val))
+                    {
+                       sum += val;
+                       ++numReceived;
+                    }
+                    else
+                    {
+                       std::this_thread::yield();
+                    }
+                 }
+                 producer.join();
+                 doNotOptimize(sum);
+              });
+}
+
+
+template <std::size_t N> void benchSpscBatchTransfer(Runner& runner)
+{
+   runner.run("RingBuffer/spsc_batch_transfer",
+              params({param("capacity", N), param("elem", TypeName_v<int>),
+                      param("batch", TransferBatchSize)}),
+              1,
+              []()
+              {
+                 SpscRingBuffer<int, N> rb;
+
+                 std::thread producer(
+                    [&rb]()
+                    {
+                       std::array<int, TransferBatchSize> batch{};
+                       for (std::size_t i = 0; i < NumTransferred;)
+                       {
+                          const std::size_t count =
+                             std::min(TransferBatchSize, NumTransferred - i);
+                          for (std::size_t j = 0; j < count; ++j)
+                             batch[j] = static_cast<int>(i + j);
+                          const std::size_t numPushed =
+                             rb.try_push_n(batch.begin(), count);
+                          if (numPushed == 0)
+                             std::this_thread::yield();
+                          i += numPushed;
+                       }
+                    });
+
+                 int sum = 0;
+                 std::array<int, TransferBatchSize> batch{};
+                 for (std::size_t numReceived = 0; numReceived < NumTransferred;)
+                 {
+                    const std::size_t count =
+                       rb.try_pop_n(batch.begin(), TransferBatchSize);
+                    if (count == 0)
+                       std::this_thread::yield();
+                    for (std::size_t j = 0; j < count; ++j)
+                       sum += batch[j];
+                    numReceived += count;
+                 }
+                 producer.join();
+                 doNotOptimize(sum);
+              });
+}
+
+
+// Transfers values from multiple producer threads to the calling thread through a
+// mutex-protected ring buffer.
+template <std::size_t N> void benchMutexFanIn(Runner& runner, std::size_t numProducers)
+{
+   runner.run("RingBuffer/mutex_fan_in",
+              params({param("capacity", N), param("elem", TypeName_v<int>),
+                      param("producers", numProducers)}),
+              1,
+              [numProducers]()
+              {
+                 RingBuffer<int, N> rb;
+                 std::mutex mutex;
+                 const std::size_t numPerProducer = NumTransferred / numProducers;
+
+                 std::vector<std::thread> producers;
+                 for (std::size_t p = 0; p < numProducers; ++p)
+                 {
+                    producers.emplace_back(
+                       [&rb, &mutex, numPerProducer]()
+                       {
+                          for (std::size_t i = 0; i < numPerProducer;)
+                          {
+                             std::unique_lock lock{mutex};
+                             if (rb.full())
+                             {
+                                lock.unlock();
+                                std::this_thread::yield();
+                                continue;
+                             }
+                             rb.push(static_cast<int>(i++));
+                          }
+                       });
+                 }
+
+                 int sum = 0;
+                 const std::size_t numTotal = numPerProducer * numProducers;
+                 for (std::size_t numReceived = 0; numReceived < numTotal;)
+                 {
+                    std::unique_lock lock{mutex};
+                    if (rb.empty())
+                    {
+                       lock.unlock();
+                       std::this_thread::yield();
+                       continue;
+                    }
+                    while (!rb.empty())
+                    {
+                       sum += rb.pop();
+                       ++numReceived;
+                    }
+                 }
+                 for (auto& producer : producers)
+                    producer.join();
+                 doNotOptimize(sum);
+              });
+}
+
+
+template <std::size_t N> void benchMpmcFanIn(Runner& runner, std::size_t numProducers)
+{
+   runner.run("RingBuffer/mpmc_fan_in",
+              params({param("capacity", N), param("elem", TypeName_v<int>),
+                      param("producers", numProducers)}),
+              1,
+              [numProducers]()
+              {
+                 MpmcRingBuffer<int, N> rb;
+                 const std::size_t numPerProducer = NumTransferred / numProducers;
+
+                 std::vector<std::thread> producers;
+                 for (std::size_t p = 0; p < numProducers; ++p)
+                 {
+                    producers.emplace_back(
+                       [&rb, numPerProducer]()
+                       {
+                          for (std::size_t i = 0; i < numPerProducer; ++i)
+                             rb.push(static_cast<int>(i));
+                       });
+                 }
+
+                 int sum = 0;
+                 const std::size_t numTotal = numPerProducer * numProducers;
+                 for (std::size_t numReceived = 0; numReceived < numTotal; ++numReceived)
+                    sum += rb.pop();
+                 for (auto& producer : producers)
+                    producer.join();
+                 doNotOptimize(sum);
+              });
+}
+
+
+template <std::size_t N> void benchTransfers(Runner& runner)
+{
+   benchMutexTransfer<N>(runner);
+   benchSpscTransfer<N>(runner);
+   benchSpscBatchTransfer<N>(runner);
+
+   for (std::size_t numProducers : {4, 32})
+   {
+      benchMutexFanIn<N>(runner, numProducers);
+      benchMpmcFanIn<N>(runner, numProducers);
+   }
+}
+
+} // namespace
+
+
+///////////////////
+
+void benchmarkRingBuffer(Runner& runner)
+{
+   // Capacities that are and are not powers of two.
+   benchRingBuffers<int, 64>(runner);
+   benchRingBuffers<int, 1000>(runner);
+   benchRingBuffers<int, 1024>(runner);
+   benchRingBuffers<double, 1024>(runner);
+   benchRingBuffers<std::string, 64>(runner);
+   benchRingBuffers<std::string, 1024>(runner);
+
+   // Handing values from one thread to another.
+   benchTransfers<1024>(runner);
+}
@@ -0,0 +1,172 @@
+#include "SboVectorBenchmarks.h"
+#include "BenchmarkUtil.h"
+#include "CompactSboVector.h"
+#include "SboVector.h"
+#include <list>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+using namespace ds;
+using namespace bench;
+
+
+namespace
+{
+
+///////////////////
+
+// Number of vectors processed per repetition. Keeps the measured durations well above
+// the clock resolution.
+constexpr std::size_t NumVectors = 100;
+
+
+template <typename Vec>
+void benchPushBack(Runner& runner, const std::string& container, std::size_t numElems)
+{
+   using T = typename Vec::value_type;
+   const std::vector<T> vals = makeRandomValues<T>(numElems);
+
+   runner.run("SboVector/push_back",
+              params({param("container", container), param("size", numElems),
+                      param("elem", TypeName_v<T>)}),
+              NumVectors,
+              [&vals]()
+              {
+                 Vec v;
+                 for (const T& val : vals)
+                    v.push_back(val);
+                 doNotOptimize(v);
+              });
+}
+
+
+template <typename Vec>
+void benchCopy(Runner& runner, const std::string& container, std::size_t numElems)
+{
+   using T = typename Vec::value_type;
+   const std::vector<T> vals = makeRandomValues<T>(numElems);
+   const Vec src(vals.begin(), vals.end());
+
+   runner.run("SboVector/copy",
+              params({param("container", container), param("size", numElems),
+                      param("elem", TypeName_v<T>)}),
+              NumVectors,
+              [&src]()
+              {
+                 Vec copy{src};
+                 doNotOptimize(copy);
+              });
+}
+
+
+template <typename Vec>
+void benchCopyFromList(Runner& runner, const std::string& container,
+                       std::size_t numElems)
+{
+   using T = typename Vec::value_type;
+   const std::vector<T> vals = makeRandomValues<T>(numElems);
+   const std::list<T> src(vals.begin(), vals.end());
+
+   runner.run("SboVector/copy_from_list",
+              params({param("container", container), param("size", numElems),
+                      param("elem", TypeName_v<T>)}),
+              NumVectors,
+              [&src]()
+              {
+                 Vec v(src.begin(), src.end());
+                 doNotOptimize(v);
+              });
+}
+
+
+template <typename Vec>
+void benchIndexAccess(Runner& runner, const std::string& container, std::size_t numElems)
+{
+   using T = typename Vec::value_type;
+   const std::vector<T> vals = makeRandomValues<T>(numElems);
+   const Vec v(vals.begin(), vals.end());
+
+   runner.run("SboVector/index_access",
+              params({param("container", container), param("size", numElems),
+                      param("elem", TypeName_v<T>)}),
+              NumVectors,
+              [&v]()
+              {
+                 T sum{};
+                 for (std::size_t i = 0; i < v.size(); ++i)
+                    sum += v[i];
+                 doNotOptimize(sum);
+              });
+}
+
+
+template <typename Vec>
+void benchInsertFront(Runner& runner, const std::string& container, std::size_t numElems)
+{
+   using T = typename Vec::value_type;
+   const std::vector<T> vals = makeRandomValues<T>(numElems);
+
+   // Quadratic cost. Use fewer vectors.
+   runner.run("SboVector/insert_front",
+              params({param("container", container), param("size", numElems),
+                      param("elem", TypeName_v<T>)}),
+              NumVectors / 10,
+              [&vals]()
+              {
+                 Vec v;
+                 for (const T& val : vals)
+                    v.insert(v.begin(), val);
+                 doNotOptimize(v);
+              });
+}
+
+
+// Runs all benchmarks for vector types with a given element type, buffer capacity and
+// number of elements. The number of elements determines whether the vectors stay in
+// their buffers.
+template <typename T, std::size_t BufCap>
+void benchVectors(Runner& runner, std::size_t numElems)
+{
+   const std::string sboName = "SboVector<" + std::to_string(BufCap) + ">";
+   const std::string compactName = "CompactSboVector<" + std::to_string(BufCap) + ">";
+
+   benchPushBack<std::vector<T>>(runner, "std::vector", numElems);
+   benchPushBack<SboVector<T, BufCap>>(runner, sboName, numElems);
+   benchPushBack<CompactSboVector<T, BufCap>>(runner, compactName, numElems);
+
+   benchCopy<std::vector<T>>(runner, "std::vector", numElems);
+   benchCopy<SboVector<T, BufCap>>(runner, sboName, numElems);
+   benchCopy<CompactSboVector<T, BufCap>>(runner, compactName, numElems);
+
+   benchCopyFromList<std::vector<T>>(runner, "std::vector", numElems);
+   benchCopyFromList<SboVector<T, BufCap>>(runner, sboName, numElems);
+
+   benchInsertFront<std::vector<T>>(runner, "std::vector", numElems);
+   benchInsertFront<SboVector<T, BufCap>>(runner, sboName, numElems);
+
+   if constexpr (std::is_arithmetic_v<T>)
+   {
+      benchIndexAccess<std::vector<T>>(runner, "std::vector", numElems);
+      benchIndexAccess<SboVector<T, BufCap>>(runner, sboName, numElems);
+      benchIndexAccess<CompactSboVector<T, BufCap>>(runner, compactName, numElems);
+   }
+}
+
+} // namespace
+
+
+///////////////////
+
+void benchmarkSboVector(Runner& runner)
+{
+   constexpr std::size_t BufCap = 64;
+
+   // Sizes in buffer, at buffer capacity, and on heap.
+   for (std::size_t numElems : {8, 64, 512})
+   {
+      benchVectors<int, BufCap>(runner, numElems);
+      benchVectors<double, BufCap>(runner, numElems);
+      benchVectors<std::string, BufCap>(runner, numElems);
+   }
+}
@@ -0,0 +1,104 @@
+#include "SortBenchmarks.h"
+#include "BenchmarkUtil.h"
+#include "Sort.h"
+#include <algorithm>
+#include <string>
+#include <vector>
+
+using namespace ds;
+using namespace bench;
+
+
+namespace
+{
+
+///////////////////
+
+// Order of the input data.
+enum class Order
+{
+   Random,
+   Sorted,
+   Reversed
+};
+
+
+inline const char* orderName(Order order)
+{
+   switch (order)
+   {
+   case Order::Sorted:
+      return "sorted";
+   case Order::Reversed:
+      return "reversed";
+   default:
+      return "random";
+   }
+}
+
+
+template <typename T> std::vector<T> makeInput(std::size_t numElems, Order order)
+{
+   std::vector<T> vals = makeRandomValues<T>(numElems);
+   if (order == Order::Sorted)
+      std::sort(vals.begin(), vals.end());
+   else if (order == Order::Reversed)
+      std::sort(vals.begin(), vals.end(), std::greater<T>());
+   return vals;
+}
+
+
+template <typename T, typename SortFn>
+void benchSort(Runner& runner, const std::string& name, std::size_t numElems,
+               Order order, SortFn sortFn)
+{
+   const std::vector<T> input = makeInput<T>(numElems, order);
+
+   runner.runWithSetup(name,
+                       params({param("size", numElems), param("elem", TypeName_v<T>),
+                               param("order", orderName(order))}),
+                       [&input]() { return input; },
+                       [&sortFn](std::vector<T>& data)
+                       {
+                          sortFn(data);
+                          doNotOptimize(data.front());
+                       });
+}
+
+
+template <typename T> void benchSortAlgorithms(Runner& runner, Order order)
+{
+   // Quadratic algorithms only for smaller sizes.
+   for (std::size_t numElems : {100, 1000})
+   {
+      benchSort<T>(runner, "Sort/insertionSort", numElems, order,
+                   [](std::vector<T>& data) { insertionSort(data.begin(), data.end()); });
+      benchSort<T>(runner, "Sort/bubbleSort", numElems, order,
+                   [](std::vector<T>& data) { bubbleSort(data.begin(), data.end()); });
+   }
+
+   for (std::size_t numElems : {100, 10000, 100000})
+   {
+      benchSort<T>(runner, "Sort/mergeSort", numElems, order,
+                   [](std::vector<T>& data) { mergeSort(data.begin(), data.end()); });
+      benchSort<T>(runner, "Sort/heapSort", numElems, order,
+                   [](std::vector<T>& data) { heapSort(data); });
+      benchSort<T>(runner, "Sort/std::sort", numElems, order,
+                   [](std::vector<T>& data) { std::sort(data.begin(), data.end()); });
+   }
+}
+
+} // namespace
+
+
+///////////////////
+
+void benchmarkSort(Runner& runner)
+{
+   for (Order order : {Order::Random, Order::Sorted, Order::Reversed})
+   {
+      benchSortAlgorithms<int>(runner, order);
+      benchSortAlgorithms<double>(runner, order);
+   }
+   benchSortAlgorithms<std::string>(runner, Order::Random);
+}
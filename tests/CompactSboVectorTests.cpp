@@ -0,0 +1,374 @@
+#include "CompactSboVectorTests.h"
+#include "CompactSboVector.h"
+#include "TestUtil.h"
+#include <memory_resource>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace ds;
+
+
+///////////////////
+
+namespace
+{
+
+// Element type that counts its live instances.
+struct Counted
+{
+   Counted(int v = 0) : val{v} { ++numAlive; }
+   Counted(const Counted& other) : val{other.val} { ++numAlive; }
+   Counted(Counted&& other) noexcept : val{other.val} { ++numAlive; }
+   ~Counted() { --numAlive; }
+   Counted& operator=(const Counted&) = default;
+   Counted& operator=(Counted&&) noexcept = default;
+   friend bool operator==(const Counted& a, const Counted& b) { return a.val == b.val; }
+
+   int val = 0;
+   inline static int numAlive = 0;
+};
+
+
+template <typename CSV, typename Value>
+bool equals(const CSV& csv, const std::vector<Value>& expected)
+{
+   return csv.size() == expected.size() &&
+          std::equal(csv.begin(), csv.end(), expected.begin());
+}
+
+
+void testCompactSboVectorSize()
+{
+   {
+      const std::string caseLabel{"CompactSboVector footprint"};
+
+      // Buffer, data pointer, size and capacity for SboVector.
+      VERIFY(sizeof(SboVector<int, 4>) >= 4 * sizeof(int) + 3 * sizeof(std::size_t),
+             caseLabel);
+      // Buffer and size for CompactSboVector.
+      VERIFY(sizeof(CompactSboVector<int, 4>) == 4 * sizeof(int) + sizeof(std::size_t),
+             caseLabel);
+   }
+   {
+      const std::string caseLabel{"CompactSboVector footprint with buffer smaller than "
+                                  "heap data"};
+
+      // The buffer needs to be large enough to hold the heap pointer and capacity.
+      VERIFY(sizeof(CompactSboVector<char, 2>) == 3 * sizeof(std::size_t), caseLabel);
+   }
+}
+
+
+void testCompactSboVectorCtors()
+{
+   {
+      const std::string caseLabel{"CompactSboVector default ctor"};
+
+      CompactSboVector<int, 4> csv;
+      VERIFY(csv.empty(), caseLabel);
+      VERIFY(csv.inBuffer(), caseLabel);
+      VERIFY(csv.capacity() == 4, caseLabel);
+   }
+   {
+      const std::string caseLabel{"CompactSboVector ctor for element count and value"};
+
+      CompactSboVector<int, 4> inBuf(3, 7);
+      VERIFY(equals(inBuf, std::vector<int>{7, 7, 7}), caseLabel);
+      VERIFY(inBuf.inBuffer(), caseLabel);
+
+      CompactSboVector<int, 4> onHeap(6, 7);
+      VERIFY(equals(onHeap, std::vector<int>(6, 7)), caseLabel);
+      VERIFY(onHeap.onHeap(), caseLabel);
+      VERIFY(onHeap.capacity() >= 6, caseLabel);
+   }
+   {
+      const std::string caseLabel{"CompactSboVector iterator ctor"};
+
+      const std::vector<std::string> src{"a", "b", "c", "d", "e"};
+      CompactSboVector<std::string, 2> csv(src.begin(), src.end());
+      VERIFY(equals(csv, src), caseLabel);
+      VERIFY(csv.onHeap(), caseLabel);
+   }
+   {
+      const std::string caseLabel{"CompactSboVector copy ctor"};
+
+      CompactSboVector<std::string, 2> inBuf{"a", "b"};
+      CompactSboVector<std::string, 2> inBufCopy{inBuf};
+      VERIFY(inBufCopy == inBuf, caseLabel);
+      VERIFY(inBufCopy.inBuffer(), caseLabel);
+
+      CompactSboVector<std::string, 2> onHeap{"a", "b", "c"};
+      CompactSboVector<std::string, 2> onHeapCopy{onHeap};
+      VERIFY(onHeapCopy == onHeap, caseLabel);
+      VERIFY(onHeapCopy.onHeap(), caseLabel);
+   }
+   {
+      const std::string caseLabel{"CompactSboVector move ctor"};
+
+      CompactSboVector<std::string, 2> inBuf{"a", "b"};
+      CompactSboVector<std::string, 2> inBufMoved{std::move(inBuf)};
+      VERIFY(equals(inBufMoved, std::vector<std::string>{"a", "b"}), caseLabel);
+      VERIFY(inBuf.empty(), caseLabel);
+
+      CompactSboVector<std::string, 2> onHeap{"a", "b", "c"};
+      const std::string* heapData = onHeap.data();
+      CompactSboVector<std::string, 2> onHeapMoved{std::move(onHeap)};
+      VERIFY(equals(onHeapMoved, std::vector<std::string>{"a", "b", "c"}), caseLabel);
+      // Heap memory is stolen.
+      VERIFY(onHeapMoved.data() == heapData, caseLabel);
+      VERIFY(onHeap.empty(), caseLabel);
+      VERIFY(onHeap.inBuffer(), caseLabel);
+   }
+}
+
+
+void testCompactSboVectorAssignment()
+{
+   {
+      const std::string caseLabel{"CompactSboVector copy assignment"};
+
+      CompactSboVector<int, 3> csv{1, 2, 3, 4, 5};
+      const CompactSboVector<int, 3> src{6, 7};
+      csv = src;
+      VERIFY(equals(csv, std::vector<int>{6, 7}), caseLabel);
+   }
+   {
+      const std::string caseLabel{"CompactSboVector move assignment"};
+
+      CompactSboVector<std::string, 3> csv{"a"};
+      CompactSboVector<std::string, 3> src{"b", "c", "d", "e"};
+      csv = std::move(src);
+      VERIFY(equals(csv, std::vector<std::string>{"b", "c", "d", "e"}), caseLabel);
+      VERIFY(src.empty(), caseLabel);
+   }
+   {
+      const std::string caseLabel{"CompactSboVector initializer list assignment"};
+
+      CompactSboVector<int, 3> csv{1, 2};
+      csv = {3, 4, 5, 6};
+      VERIFY(equals(csv, std::vector<int>{3, 4, 5, 6}), caseLabel);
+   }
+}
+
+
+void testCompactSboVectorAccess()
+{
+   {
+      const std::string caseLabel{"CompactSboVector element access"};
+
+      CompactSboVector<int, 3> csv{1, 2, 3, 4};
+      VERIFY(csv[1] == 2, caseLabel);
+      VERIFY(csv.at(2) == 3, caseLabel);
+      VERIFY(csv.front() == 1, caseLabel);
+      VERIFY(csv.back() == 4, caseLabel);
+      VERIFY_THROW([&csv]() { csv.at(4); }, std::out_of_range, caseLabel);
+   }
+   {
+      const std::string caseLabel{"CompactSboVector iteration"};
+
+      const CompactSboVector<int, 3> csv{1, 2, 3, 4};
+      std::vector<int> reversed(csv.rbegin(), csv.rend());
+      VERIFY((reversed == std::vector<int>{4, 3, 2, 1}), caseLabel);
+   }
+}
+
+
+void testCompactSboVectorCapacity()
+{
+   {
+      const std::string caseLabel{"CompactSboVector reserve"};
+
+      CompactSboVector<int, 3> csv{1, 2};
+      csv.reserve(2);
+      VERIFY(csv.inBuffer(), caseLabel);
+      csv.reserve(10);
+      VERIFY(csv.onHeap(), caseLabel);
+      VERIFY(csv.capacity() == 10, caseLabel);
+      VERIFY(equals(csv, std::vector<int>{1, 2}), caseLabel);
+   }
+   {
+      const std::string caseLabel{"CompactSboVector shrink_to_fit back into buffer"};
+
+      CompactSboVector<std::string, 3> csv{"a", "b", "c", "d"};
+      csv.pop_back();
+      csv.shrink_to_fit();
+      VERIFY(csv.inBuffer(), caseLabel);
+      VERIFY(equals(csv, std::vector<std::string>{"a", "b", "c"}), caseLabel);
+   }
+   {
+      const std::string caseLabel{"CompactSboVector shrink_to_fit on heap"};
+
+      CompactSboVector<std::string, 3> csv{"a", "b", "c", "d"};
+      csv.reserve(20);
+      csv.shrink_to_fit();
+      VERIFY(csv.onHeap(), caseLabel);
+      VERIFY(csv.capacity() == 4, caseLabel);
+      VERIFY(equals(csv, std::vector<std::string>{"a", "b", "c", "d"}), caseLabel);
+   }
+   {
+      const std::string caseLabel{"CompactSboVector max size"};
+
+      CompactSboVector<int, 3> csv;
+      VERIFY_THROW([&csv]() { csv.reserve(csv.max_size() + 1); }, std::length_error,
+                   caseLabel);
+   }
+}
+
+
+void testCompactSboVectorModifiers()
+{
+   {
+      const std::string caseLabel{"CompactSboVector push_back across buffer boundary"};
+
+      CompactSboVector<std::string, 2> csv;
+      csv.push_back("a");
+      csv.push_back("b");
+      VERIFY(csv.inBuffer(), caseLabel);
+      csv.push_back("c");
+      VERIFY(csv.onHeap(), caseLabel);
+      VERIFY(equals(csv, std::vector<std::string>{"a", "b", "c"}), caseLabel);
+   }
+   {
+      const std::string caseLabel{"CompactSboVector insert in buffer and on heap"};
+
+      CompactSboVector<std::string, 4> csv{"a", "d"};
+      csv.insert(csv.begin() + 1, {"b", "c"});
+      VERIFY(csv.inBuffer(), caseLabel);
+      VERIFY(equals(csv, std::vector<std::string>{"a", "b", "c", "d"}), caseLabel);
+
+      csv.insert(csv.begin(), 2, "x");
+      VERIFY(csv.onHeap(), caseLabel);
+      VERIFY(equals(csv, std::vector<std::string>{"x", "x", "a", "b", "c", "d"}),
+             caseLabel);
+
+      csv.insert(csv.end(), "e");
+      VERIFY(equals(csv, std::vector<std::string>{"x", "x", "a", "b", "c", "d", "e"}),
+             caseLabel);
+   }
+   {
+      const std::string caseLabel{"CompactSboVector insert element of same vector"};
+
+      CompactSboVector<std::string, 2> csv{"a", "b"};
+      csv.insert(csv.begin(), csv[1]);
+      VERIFY(equals(csv, std::vector<std::string>{"b", "a", "b"}), caseLabel);
+   }
+   {
+      const std::string caseLabel{"CompactSboVector erase"};
+
+      CompactSboVector<std::string, 3> csv{"a", "b", "c", "d", "e"};
+      auto pos = csv.erase(csv.begin() + 1, csv.begin() + 3);
+      VERIFY(*pos == "d", caseLabel);
+      VERIFY(equals(csv, std::vector<std::string>{"a", "d", "e"}), caseLabel);
+
+      pos = csv.erase(csv.begin());
+      VERIFY(*pos == "d", caseLabel);
+      VERIFY(equals(csv, std::vector<std::string>{"d", "e"}), caseLabel);
+   }
+   {
+      const std::string caseLabel{"CompactSboVector emplace"};
+
+      CompactSboVector<std::string, 3> csv{"a", "c"};
+      csv.emplace(csv.begin() + 1, 1, 'b');
+      csv.emplace_back(2, 'd');
+      VERIFY(equals(csv, std::vector<std::string>{"a", "b", "c", "dd"}), caseLabel);
+   }
+   {
+      const std::string caseLabel{"CompactSboVector resize"};
+
+      CompactSboVector<int, 3> csv{1, 2};
+      csv.resize(5);
+      VERIFY(equals(csv, std::vector<int>{1, 2, 0, 0, 0}), caseLabel);
+      csv.resize(6, 9);
+      VERIFY(equals(csv, std::vector<int>{1, 2, 0, 0, 0, 9}), caseLabel);
+      csv.resize(1);
+      VERIFY(equals(csv, std::vector<int>{1}), caseLabel);
+   }
+   {
+      const std::string caseLabel{"CompactSboVector swap"};
+
+      CompactSboVector<std::string, 2> a{"a"};
+      CompactSboVector<std::string, 2> b{"b", "c", "d"};
+      swap(a, b);
+      VERIFY(equals(a, std::vector<std::string>{"b", "c", "d"}), caseLabel);
+      VERIFY(equals(b, std::vector<std::string>{"a"}), caseLabel);
+
+      CompactSboVector<std::string, 2> c{"e", "f", "g"};
+      a.swap(c);
+      VERIFY(equals(a, std::vector<std::string>{"e", "f", "g"}), caseLabel);
+      VERIFY(equals(c, std::vector<std::string>{"b", "c", "d"}), caseLabel);
+   }
+}
+
+
+void testCompactSboVectorElementLifetime()
+{
+   {
+      const std::string caseLabel{"CompactSboVector destroys all elements"};
+
+      Counted::numAlive = 0;
+      {
+         CompactSboVector<Counted, 3> csv{1, 2};
+         for (int i = 3; i < 10; ++i)
+            csv.push_back(i);
+         csv.insert(csv.begin() + 2, {20, 21, 22});
+         csv.erase(csv.begin(), csv.begin() + 4);
+         csv.insert(csv.begin() + 1, Counted{30});
+         VERIFY(Counted::numAlive == static_cast<int>(csv.size()), caseLabel);
+
+         csv.resize(2);
+         csv.shrink_to_fit();
+         VERIFY(csv.inBuffer(), caseLabel);
+         VERIFY(Counted::numAlive == 2, caseLabel);
+      }
+      VERIFY(Counted::numAlive == 0, caseLabel);
+   }
+}
+
+
+void testCompactSboVectorAllocator()
+{
+   {
+      const std::string caseLabel{"CompactSboVector with pmr allocator"};
+
+      std::pmr::monotonic_buffer_resource resource;
+      using Alloc = std::pmr::polymorphic_allocator<int>;
+      CompactSboVector<int, 2, Alloc> csv{Alloc{&resource}};
+      csv.assign({1, 2, 3});
+      VERIFY(csv.get_allocator().resource() == &resource, caseLabel);
+      VERIFY(equals(csv, std::vector<int>{1, 2, 3}), caseLabel);
+   }
+}
+
+
+void testCompactSboVectorComparison()
+{
+   {
+      const std::string caseLabel{"CompactSboVector comparison"};
+
+      const CompactSboVector<int, 2> a{1, 2, 3};
+      const CompactSboVector<int, 2> b{1, 2, 3};
+      const CompactSboVector<int, 2> c{1, 2};
+      VERIFY(a == b, caseLabel);
+      VERIFY(a != c, caseLabel);
+      VERIFY(c < a, caseLabel);
+   }
+}
+
+} // namespace
+
+
+///////////////////
+
+void testCompactSboVector()
+{
+   testCompactSboVectorSize();
+   testCompactSboVectorCtors();
+   testCompactSboVectorAssignment();
+   testCompactSboVectorAccess();
+   testCompactSboVectorCapacity();
+   testCompactSboVectorModifiers();
+   testCompactSboVectorElementLifetime();
+   testCompactSboVectorAllocator();
+   testCompactSboVectorComparison();
+}
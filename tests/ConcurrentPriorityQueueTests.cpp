@@ -0,0 +1,286 @@
+#include "ConcurrentPriorityQueueTests.h"
+#include "ConcurrentPriorityQueue.h"
+#include "TestUtil.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace ds;
+
+
+///////////////////
+
+namespace
+{
+
+template <PopOrdering Ordering>
+using IntQueue = ConcurrentPriorityQueue<int, std::less<int>, Ordering>;
+
+
+// Values 0 to n-1 in scrambled order.
+std::vector<int> scrambledValues(int n)
+{
+   std::vector<int> vals;
+   for (int i = 0; i < n; ++i)
+      vals.push_back((i * 7919) % n);
+   return vals;
+}
+
+
+void testConcurrentPriorityQueueCtor()
+{
+   {
+      const std::string caseLabel{"ConcurrentPriorityQueue ctor"};
+      const IntQueue<PopOrdering::Relaxed> q{4};
+      VERIFY(q.num_queues() == 8, caseLabel);
+      VERIFY(q.empty(), caseLabel);
+      VERIFY(q.size() == 0, caseLabel);
+   }
+   {
+      const std::string caseLabel{"ConcurrentPriorityQueue ctor with queues per thread"};
+      const IntQueue<PopOrdering::Strict> q{3, 1};
+      VERIFY(q.num_queues() == 3, caseLabel);
+   }
+   {
+      const std::string caseLabel{"ConcurrentPriorityQueue ctor for no threads"};
+      const IntQueue<PopOrdering::Relaxed> q{0};
+      VERIFY(q.num_queues() == 1, caseLabel);
+   }
+   {
+      const std::string caseLabel{"ConcurrentPriorityQueue ctor with criterium"};
+      ConcurrentPriorityQueue<int, std::greater<int>, PopOrdering::Strict> q{
+         2, 2, std::greater<int>{}};
+      q.push(1);
+      q.push(3);
+      q.push(2);
+      VERIFY(q.pop() == 3, caseLabel);
+   }
+}
+
+
+void testConcurrentPriorityQueueStrictOrder()
+{
+   {
+      const std::string caseLabel{"ConcurrentPriorityQueue strict pops in order"};
+      IntQueue<PopOrdering::Strict> q{4};
+      for (int val : scrambledValues(1000))
+         q.push(val);
+      VERIFY(q.size() == 1000, caseLabel);
+
+      bool inOrder = true;
+      for (int i = 0; i < 1000; ++i)
+         inOrder = inOrder && q.pop() == i;
+      VERIFY(inOrder, caseLabel);
+      VERIFY(q.empty(), caseLabel);
+   }
+   {
+      const std::string caseLabel{"ConcurrentPriorityQueue strict try_pop for empty queue"};
+      IntQueue<PopOrdering::Strict> q{2};
+      int val = -1;
+      VERIFY(!q.try_pop(val), caseLabel);
+      VERIFY(val == -1, caseLabel);
+      q.push(5);
+      VERIFY(q.try_pop(val) && val == 5, caseLabel);
+      VERIFY(!q.try_pop(val), caseLabel);
+   }
+}
+
+
+void testConcurrentPriorityQueueRelaxedOrder()
+{
+   {
+      const std::string caseLabel{"ConcurrentPriorityQueue relaxed pops all elements"};
+      IntQueue<PopOrdering::Relaxed> q{4};
+      for (int val : scrambledValues(1000))
+         q.push(val);
+      VERIFY(q.size() == 1000, caseLabel);
+
+      std::vector<int> popped;
+      int val = 0;
+      while (q.try_pop(val))
+         popped.push_back(val);
+      std::sort(popped.begin(), popped.end());
+
+      std::vector<int> expected(1000);
+      for (int i = 0; i < 1000; ++i)
+         expected[i] = i;
+      VERIFY(popped == expected, caseLabel);
+      VERIFY(q.empty(), caseLabel);
+   }
+   {
+      const std::string caseLabel{"ConcurrentPriorityQueue relaxed with single queue"};
+      IntQueue<PopOrdering::Relaxed> q{1, 1};
+      for (int val : scrambledValues(100))
+         q.push(val);
+
+      bool inOrder = true;
+      for (int i = 0; i < 100; ++i)
+         inOrder = inOrder && q.pop() == i;
+      VERIFY(inOrder, caseLabel);
+   }
+   {
+      const std::string caseLabel{"ConcurrentPriorityQueue relaxed pops elements near top"};
+      IntQueue<PopOrdering::Relaxed> q{2};
+      for (int val : scrambledValues(1000))
+         q.push(val);
+
+      // Each queue holds elements spread over the whole range. Popping from the
+      // better of two queues never pops elements from the bottom of the range early.
+      int maxOfFirst = 0;
+      for (int i = 0; i < 100; ++i)
+         maxOfFirst = std::max(maxOfFirst, q.pop());
+      VERIFY(maxOfFirst < 500, caseLabel);
+   }
+   {
+      const std::string caseLabel{"ConcurrentPriorityQueue::emplace"};
+      ConcurrentPriorityQueue<std::string> q{2};
+      q.emplace(3, 'b');
+      q.emplace("a");
+
+      std::vector<std::string> popped{q.pop(), q.pop()};
+      std::sort(popped.begin(), popped.end());
+      VERIFY((popped == std::vector<std::string>{"a", "bbb"}), caseLabel);
+   }
+}
+
+
+void testConcurrentPriorityQueueBlockingPop()
+{
+   {
+      const std::string caseLabel{"ConcurrentPriorityQueue::pop waits for element"};
+      IntQueue<PopOrdering::Relaxed> q{2};
+
+      std::thread producer(
+         [&q]()
+         {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            q.push(7);
+         });
+      const int val = q.pop();
+      producer.join();
+
+      VERIFY(val == 7, caseLabel);
+   }
+}
+
+
+template <PopOrdering Ordering> void verifyConcurrentTransfer(const std::string& caseLabel)
+{
+   static constexpr int NumProducers = 4;
+   static constexpr int NumConsumers = 4;
+   static constexpr int NumPerProducer = 10000;
+   static constexpr int NumValues = NumProducers * NumPerProducer;
+   IntQueue<Ordering> q{NumProducers + NumConsumers};
+
+   std::vector<std::thread> threads;
+   for (int p = 0; p < NumProducers; ++p)
+   {
+      threads.emplace_back(
+         [&q, p]()
+         {
+            for (int i = 0; i < NumPerProducer; ++i)
+               q.push(p * NumPerProducer + i);
+         });
+   }
+
+   std::vector<std::vector<int>> received(NumConsumers);
+   std::atomic<int> numPopped = 0;
+   for (int c = 0; c < NumConsumers; ++c)
+   {
+      threads.emplace_back(
+         [&q, &received, &numPopped, c]()
+         {
+            int val = 0;
+            while (numPopped.load() < NumValues)
+            {
+               if (q.try_pop(val))
+               {
+                  received[c].push_back(val);
+                  ++numPopped;
+               }
+               else
+               {
+                  std::this_thread::yield();
+               }
+            }
+         });
+   }
+
+   for (auto& thread : threads)
+      thread.join();
+
+   std::vector<int> seen(NumValues, 0);
+   for (const auto& vals : received)
+      for (int val : vals)
+         ++seen[val];
+   VERIFY(std::all_of(seen.begin(), seen.end(), [](int n) { return n == 1; }),
+          caseLabel);
+   VERIFY(q.empty(), caseLabel);
+}
+
+
+void testConcurrentPriorityQueueConcurrentTransfer()
+{
+   verifyConcurrentTransfer<PopOrdering::Relaxed>(
+      "ConcurrentPriorityQueue relaxed with many producers and consumers");
+   verifyConcurrentTransfer<PopOrdering::Strict>(
+      "ConcurrentPriorityQueue strict with many producers and consumers");
+}
+
+
+void testConcurrentPriorityQueueConcurrentStrictPops()
+{
+   {
+      const std::string caseLabel{"ConcurrentPriorityQueue strict concurrent pops"};
+      static constexpr int NumConsumers = 4;
+      static constexpr int NumValues = 20000;
+      IntQueue<PopOrdering::Strict> q{NumConsumers};
+      for (int val : scrambledValues(NumValues))
+         q.push(val);
+
+      // Without concurrent pushes each consumer has to receive increasing values.
+      std::vector<std::vector<int>> received(NumConsumers);
+      std::vector<std::thread> threads;
+      for (int c = 0; c < NumConsumers; ++c)
+      {
+         threads.emplace_back(
+            [&q, &received, c]()
+            {
+               int val = 0;
+               while (q.try_pop(val))
+                  received[c].push_back(val);
+            });
+      }
+      for (auto& thread : threads)
+         thread.join();
+
+      std::size_t numReceived = 0;
+      bool inOrder = true;
+      for (const auto& vals : received)
+      {
+         numReceived += vals.size();
+         inOrder = inOrder && std::is_sorted(vals.begin(), vals.end());
+      }
+      VERIFY(numReceived == NumValues, caseLabel);
+      VERIFY(inOrder, caseLabel);
+   }
+}
+
+} // namespace
+
+
+///////////////////
+
+void testConcurrentPriorityQueue()
+{
+   testConcurrentPriorityQueueCtor();
+   testConcurrentPriorityQueueStrictOrder();
+   testConcurrentPriorityQueueRelaxedOrder();
+   testConcurrentPriorityQueueBlockingPop();
+   testConcurrentPriorityQueueConcurrentTransfer();
+   testConcurrentPriorityQueueConcurrentStrictPops();
+}
@@ -2,32 +2,50 @@
 // Michael Lindner
 // MIT license
 //
+#include "CompactSboVectorTests.h"
+#include "ConcurrentPriorityQueueTests.h"
+#include "DynamicRingBufferTests.h"
 #include "HeapTests.h"
+#include "IndexedPriorityQueueTests.h"
 #include "LinearAlgebraTests.h"
+#include "MappedRingBufferTests.h"
 #include "MathAlgTests.h"
 #include "MatrixViewTests.h"
+#include "MirroredRingBufferTests.h"
+#include "MpmcRingBufferTests.h"
 #include "PriorityQueueTests.h"
 #include "RandomTests.h"
 #include "RingBufferTests.h"
 #include "SboVectorPerformanceTests.h"
 #include "SboVectorTests.h"
+#include "SlidingWindowTests.h"
 #include "SortTests.h"
+#include "SpscRingBufferTests.h"
 #include <iostream>
 #include <stdlib.h>
 
 
 int main()
 {
+   testCompactSboVector();
+   testConcurrentPriorityQueue();
+   testDynamicRingBuffer();
    testHeapView();
+   testIndexedPriorityQueue();
    testLinearAlgebra();
+   testMappedRingBuffer();
    testMathAlg();
    testMatrixView();
+   testMirroredRingBuffer();
+   testMpmcRingBuffer();
    testPriorityQueue();
    testRandom();
    testRingBuffer();
    testSboVector();
    testSboVectorPerformance();
+   testSlidingWindow();
    testSort();
+   testSpscRingBuffer();
    std::cout << "DsCpp tests finished.\n";
    return EXIT_SUCCESS;
 }
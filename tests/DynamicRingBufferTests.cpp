@@ -0,0 +1,609 @@
+#include "DynamicRingBufferTests.h"
+#include "DynamicRingBuffer.h"
+#include "TestUtil.h"
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <memory_resource>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace ds;
+
+
+///////////////////
+
+namespace
+{
+
+template <typename RB, typename Value>
+bool equals(const RB& rb, const std::vector<Value>& expected)
+{
+   return rb.size() == expected.size() &&
+          std::equal(rb.begin(), rb.end(), expected.begin());
+}
+
+
+// Element type without default ctor that counts its live instances.
+struct Counted
+{
+   explicit Counted(int v) : val{v} { ++numAlive; }
+   Counted(const Counted& other) : val{other.val} { ++numAlive; }
+   Counted(Counted&& other) noexcept : val{other.val} { ++numAlive; }
+   ~Counted() { --numAlive; }
+   Counted& operator=(const Counted&) = default;
+   Counted& operator=(Counted&&) noexcept = default;
+
+   int val = 0;
+   inline static int numAlive = 0;
+};
+
+
+// Memory resource that tracks the bytes allocated through it.
+class CountingResource : public std::pmr::memory_resource
+{
+ public:
+   std::size_t numAllocs = 0;
+   std::size_t numAllocatedBytes = 0;
+
+ private:
+   void* do_allocate(std::size_t bytes, std::size_t alignment) override
+   {
+      ++numAllocs;
+      numAllocatedBytes += bytes;
+      return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+   }
+
+   void do_deallocate(void* p, std::size_t bytes, std::size_t alignment) override
+   {
+      numAllocatedBytes -= bytes;
+      std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+   }
+
+   bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override
+   {
+      return this == &other;
+   }
+};
+
+
+void testDynamicRingBufferCtors()
+{
+   {
+      const std::string caseLabel{"DynamicRingBuffer default ctor"};
+      DynamicRingBuffer<int> rb;
+      VERIFY(rb.empty(), caseLabel);
+      VERIFY(rb.capacity() == 0, caseLabel);
+   }
+   {
+      const std::string caseLabel{"DynamicRingBuffer capacity ctor"};
+      DynamicRingBuffer<int> rb(10);
+      VERIFY(rb.empty(), caseLabel);
+      VERIFY(rb.capacity() == 10, caseLabel);
+   }
+   {
+      const std::string caseLabel{"DynamicRingBuffer iterator ctor"};
+      const std::vector<int> seq{1, 2, 3};
+      DynamicRingBuffer<int> rb(10, seq.begin(), seq.end());
+      VERIFY(equals(rb, seq), caseLabel);
+   }
+   {
+      const std::string caseLabel{"DynamicRingBuffer iterator ctor for wrapped buffer"};
+      const std::vector<int> seq{1, 2, 3, 4, 5};
+      DynamicRingBuffer<int> rb(4, seq.begin(), seq.end());
+      VERIFY(equals(rb, std::vector<int>{2, 3, 4, 5}), caseLabel);
+   }
+   {
+      const std::string caseLabel{"DynamicRingBuffer initializer list ctor"};
+      DynamicRingBuffer<std::string> rb(3, {"a", "b", "c", "d"});
+      VERIFY(equals(rb, std::vector<std::string>{"b", "c", "d"}), caseLabel);
+   }
+}
+
+
+void testDynamicRingBufferCopyAndMove()
+{
+   {
+      const std::string caseLabel{"DynamicRingBuffer copy ctor"};
+      const DynamicRingBuffer<std::string> rb(3, {"a", "b", "c", "d"});
+      DynamicRingBuffer<std::string> copy{rb};
+      VERIFY(copy.capacity() == 3, caseLabel);
+      VERIFY(equals(copy, std::vector<std::string>{"b", "c", "d"}), caseLabel);
+      VERIFY(equals(rb, std::vector<std::string>{"b", "c", "d"}), caseLabel);
+   }
+   {
+      const std::string caseLabel{"DynamicRingBuffer copy assignment"};
+      const DynamicRingBuffer<int> rb(3, {1, 2, 3, 4});
+      DynamicRingBuffer<int> other(10, {7});
+      other = rb;
+      VERIFY(other.capacity() == 3, caseLabel);
+      VERIFY(equals(other, std::vector<int>{2, 3, 4}), caseLabel);
+   }
+   {
+      const std::string caseLabel{"DynamicRingBuffer move ctor"};
+      DynamicRingBuffer<int> rb(3, {1, 2, 3, 4});
+      DynamicRingBuffer<int> moved{std::move(rb)};
+      VERIFY(moved.capacity() == 3, caseLabel);
+      VERIFY(equals(moved, std::vector<int>{2, 3, 4}), caseLabel);
+      VERIFY(rb.capacity() == 0 && rb.empty(), caseLabel);
+   }
+   {
+      const std::string caseLabel{"DynamicRingBuffer move assignment"};
+      DynamicRingBuffer<int> rb(3, {1, 2, 3, 4});
+      DynamicRingBuffer<int> other(10, {7});
+      other = std::move(rb);
+      VERIFY(other.capacity() == 3, caseLabel);
+      VERIFY(equals(other, std::vector<int>{2, 3, 4}), caseLabel);
+   }
+   {
+      const std::string caseLabel{"DynamicRingBuffer swap"};
+      DynamicRingBuffer<int> rb(3, {1, 2, 3, 4});
+      DynamicRingBuffer<int> other(10, {7});
+      rb.swap(other);
+      VERIFY(rb.capacity() == 10, caseLabel);
+      VERIFY(equals(rb, std::vector<int>{7}), caseLabel);
+      VERIFY(other.capacity() == 3, caseLabel);
+      VERIFY(equals(other, std::vector<int>{2, 3, 4}), caseLabel);
+   }
+}
+
+
+void testDynamicRingBufferAccess()
+{
+   {
+      const std::string caseLabel{"DynamicRingBuffer index operator for wrapped buffer"};
+      DynamicRingBuffer<int> rb(3, {1, 2, 3, 4, 5});
+      VERIFY(rb[0] == 3 && rb[1] == 4 && rb[2] == 5, caseLabel);
+      rb[1] = 40;
+      VERIFY(rb[1] == 40, caseLabel);
+   }
+   {
+      const std::string caseLabel{"DynamicRingBuffer::at()"};
+      const DynamicRingBuffer<int> rb(3, {1, 2});
+      VERIFY(rb.at(1) == 2, caseLabel);
+      VERIFY_THROW([&rb]() { rb.at(2); }, std::out_of_range, caseLabel);
+   }
+   {
+      const std::string caseLabel{"DynamicRingBuffer iterators"};
+      DynamicRingBuffer<int> rb(4, {1, 2, 3, 4, 5, 6});
+      std::vector<int> reversed(rb.rbegin(), rb.rend());
+      VERIFY(reversed == std::vector<int>({6, 5, 4, 3}), caseLabel);
+      for (int& val : rb)
+         val *= 2;
+      VERIFY(equals(rb, std::vector<int>{6, 8, 10, 12}), caseLabel);
+   }
+}
+
+
+void testDynamicRingBufferPushPop()
+{
+   {
+      const std::string caseLabel{"DynamicRingBuffer::push() into full buffer"};
+      DynamicRingBuffer<int> rb(3, {1, 2, 3});
+      rb.push(4);
+      VERIFY(rb.full(), caseLabel);
+      VERIFY(equals(rb, std::vector<int>{2, 3, 4}), caseLabel);
+   }
+   {
+      const std::string caseLabel{"DynamicRingBuffer::push() for zero capacity"};
+      DynamicRingBuffer<int> rb;
+      rb.push(1);
+      VERIFY(rb.empty(), caseLabel);
+   }
+   {
+      const std::string caseLabel{"DynamicRingBuffer::push() for move-only type"};
+      DynamicRingBuffer<std::unique_ptr<int>> rb(2);
+      rb.push(std::make_unique<int>(1));
+      rb.push(std::make_unique<int>(2));
+      rb.push(std::make_unique<int>(3));
+      VERIFY(*rb[0] == 2 && *rb[1] == 3, caseLabel);
+      VERIFY(*rb.pop() == 3, caseLabel);
+      VERIFY(*rb.pop_front() == 2, caseLabel);
+      VERIFY(rb.empty(), caseLabel);
+   }
+   {
+      const std::string caseLabel{"DynamicRingBuffer::emplace()"};
+      DynamicRingBuffer<std::string> rb(2);
+      rb.emplace(2, 'a');
+      rb.emplace(2, 'b');
+      std::string& added = rb.emplace(2, 'c');
+      VERIFY(equals(rb, std::vector<std::string>{"bb", "cc"}), caseLabel);
+      VERIFY(&added == &rb[1], caseLabel);
+   }
+   {
+      const std::string caseLabel{"DynamicRingBuffer::pop()"};
+      DynamicRingBuffer<int> rb(3, {1, 2, 3, 4});
+      VERIFY(rb.pop() == 4, caseLabel);
+      VERIFY(equals(rb, std::vector<int>{2, 3}), caseLabel);
+   }
+   {
+      const std::string caseLabel{"DynamicRingBuffer::pop() for empty buffer"};
+      DynamicRingBuffer<int> rb(3);
+      VERIFY_THROW([&rb]() { rb.pop(); }, std::runtime_error, caseLabel);
+   }
+   {
+      const std::string caseLabel{"DynamicRingBuffer::pop_front() as FIFO queue"};
+      DynamicRingBuffer<int> rb(3);
+      bool ok = true;
+      for (int i = 0; i < 20; ++i)
+      {
+         rb.push(i);
+         rb.push(i + 100);
+         ok = ok && rb.pop_front() == i && rb.pop_front() == i + 100;
+      }
+      VERIFY(ok, caseLabel);
+      VERIFY(rb.empty(), caseLabel);
+   }
+   {
+      const std::string caseLabel{"DynamicRingBuffer::clear()"};
+      DynamicRingBuffer<int> rb(3, {1, 2, 3, 4});
+      rb.clear();
+      VERIFY(rb.empty(), caseLabel);
+      VERIFY(rb.capacity() == 3, caseLabel);
+   }
+}
+
+
+void testDynamicRingBufferBulkOperations()
+{
+   {
+      const std::string caseLabel{"DynamicRingBuffer::push_n() wrapping around"};
+      DynamicRingBuffer<int> rb(5, {1, 2, 3, 4});
+      const std::vector<int> vals{5, 6, 7};
+      rb.push_n(vals.begin(), vals.size());
+      VERIFY(equals(rb, std::vector<int>{3, 4, 5, 6, 7}), caseLabel);
+   }
+   {
+      const std::string caseLabel{"DynamicRingBuffer::push_n() for more than capacity"};
+      DynamicRingBuffer<int> rb(3, {1});
+      const std::vector<int> vals{2, 3, 4, 5, 6};
+      rb.push_n(vals.begin(), vals.size());
+
+      DynamicRingBuffer<int> pushed(3, {1});
+      for (int val : vals)
+         pushed.push(val);
+      VERIFY(equals(rb, std::vector<int>(pushed.begin(), pushed.end())), caseLabel);
+   }
+   {
+      const std::string caseLabel{"DynamicRingBuffer::pop_n()"};
+      DynamicRingBuffer<int> rb(4, {1, 2, 3, 4, 5, 6});
+      std::vector<int> popped;
+      VERIFY(rb.pop_n(std::back_inserter(popped), 3) == 3, caseLabel);
+      VERIFY(popped == std::vector<int>({6, 5, 4}), caseLabel);
+      VERIFY(equals(rb, std::vector<int>{3}), caseLabel);
+   }
+   {
+      const std::string caseLabel{"DynamicRingBuffer::write() and read()"};
+      DynamicRingBuffer<int> rb(4);
+      bool ok = true;
+      for (int i = 0; i < 10; ++i)
+      {
+         const std::array<int, 3> vals{i, i + 1, i + 2};
+         rb.write(vals);
+         std::array<int, 3> dest{};
+         ok = ok && rb.read(dest) == 3 && dest == vals;
+      }
+      VERIFY(ok, caseLabel);
+      VERIFY(rb.empty(), caseLabel);
+   }
+}
+
+
+void testDynamicRingBufferSpans()
+{
+   {
+      const std::string caseLabel{"DynamicRingBuffer readable spans for wrapped buffer"};
+      DynamicRingBuffer<int> rb(4, {1, 2, 3, 4, 5, 6});
+      const auto spans = rb.readable_spans();
+      VERIFY(spans.first.size() == 2, caseLabel);
+      VERIFY(spans.first[0] == 3 && spans.first[1] == 4, caseLabel);
+      VERIFY(spans.second.size() == 2, caseLabel);
+      VERIFY(spans.second[0] == 5 && spans.second[1] == 6, caseLabel);
+   }
+   {
+      const std::string caseLabel{"DynamicRingBuffer writable spans with commit"};
+      DynamicRingBuffer<int> rb(4, {1, 2, 3});
+      rb.consume(2);
+
+      auto spans = rb.writable_spans();
+      VERIFY(spans.size() == 3, caseLabel);
+      VERIFY(spans.first.size() == 1, caseLabel);
+      spans.first[0] = 4;
+      spans.second[0] = 5;
+      rb.commit(2);
+      VERIFY(equals(rb, std::vector<int>{3, 4, 5}), caseLabel);
+   }
+   {
+      const std::string caseLabel{"DynamicRingBuffer::commit() and consume() limits"};
+      DynamicRingBuffer<int> rb(4, {1, 2, 3});
+      VERIFY_THROW([&rb]() { rb.commit(2); }, std::out_of_range, caseLabel);
+      VERIFY_THROW([&rb]() { rb.consume(4); }, std::out_of_range, caseLabel);
+      VERIFY(rb.size() == 3, caseLabel);
+   }
+}
+
+
+void testDynamicRingBufferOverflowPolicy()
+{
+   {
+      const std::string caseLabel{"DynamicRingBuffer counts overwritten elements"};
+      DynamicRingBuffer<int> rb(3, {1, 2, 3});
+      VERIFY(rb.push(4), caseLabel);
+      rb.emplace(5);
+      VERIFY(rb.num_overwritten() == 2, caseLabel);
+      VERIFY(rb.num_dropped() == 0, caseLabel);
+
+      const std::vector<int> vals{6, 7, 8, 9, 10};
+      VERIFY(rb.write(vals) == 5, caseLabel);
+      VERIFY(rb.num_overwritten() == 7, caseLabel);
+      VERIFY(equals(rb, std::vector<int>{8, 9, 10}), caseLabel);
+
+      rb.reset_counters();
+      VERIFY(rb.num_overwritten() == 0, caseLabel);
+   }
+   {
+      const std::string caseLabel{"DynamicRingBuffer with reject policy"};
+      DynamicRingBuffer<int, OverflowPolicy::Reject> rb(3, {1, 2});
+      VERIFY(rb.push(3), caseLabel);
+      VERIFY(!rb.push(4), caseLabel);
+      VERIFY(equals(rb, std::vector<int>{1, 2, 3}), caseLabel);
+      VERIFY_THROW([&rb]() { rb.emplace(5); }, std::runtime_error, caseLabel);
+      VERIFY(rb.num_dropped() == 2, caseLabel);
+      VERIFY(rb.num_overwritten() == 0, caseLabel);
+   }
+   {
+      const std::string caseLabel{"DynamicRingBuffer::push_n() with reject policy"};
+      DynamicRingBuffer<int, OverflowPolicy::Reject> rb(4, {1});
+      const std::vector<int> vals{2, 3, 4, 5, 6};
+      VERIFY(rb.push_n(vals.begin(), vals.size()) == 3, caseLabel);
+      VERIFY(equals(rb, std::vector<int>{1, 2, 3, 4}), caseLabel);
+      VERIFY(rb.num_dropped() == 2, caseLabel);
+
+      rb.pop_front();
+      VERIFY(rb.write(vals) == 1, caseLabel);
+      VERIFY(equals(rb, std::vector<int>{2, 3, 4, 2}), caseLabel);
+      VERIFY(rb.num_dropped() == 6, caseLabel);
+   }
+   {
+      const std::string caseLabel{"DynamicRingBuffer with reject policy keeps oldest"};
+      const std::vector<int> vals{1, 2, 3, 4, 5};
+      DynamicRingBuffer<int, OverflowPolicy::Reject> rb(3, vals.begin(), vals.end());
+      VERIFY(equals(rb, std::vector<int>{1, 2, 3}), caseLabel);
+      VERIFY(rb.num_dropped() == 2, caseLabel);
+   }
+   {
+      const std::string caseLabel{"DynamicRingBuffer with zero capacity drops elements"};
+      DynamicRingBuffer<int> rb;
+      VERIFY(!rb.push(1), caseLabel);
+      const std::vector<int> vals{2, 3};
+      VERIFY(rb.write(vals) == 0, caseLabel);
+      VERIFY_THROW([&rb]() { rb.emplace(4); }, std::runtime_error, caseLabel);
+      VERIFY(rb.num_dropped() == 4, caseLabel);
+   }
+   {
+      const std::string caseLabel{"DynamicRingBuffer copies and moves counters"};
+      DynamicRingBuffer<int> rb(2, {1, 2, 3});
+      DynamicRingBuffer<int> copy{rb};
+      VERIFY(copy.num_overwritten() == 1, caseLabel);
+      DynamicRingBuffer<int> moved{std::move(rb)};
+      VERIFY(moved.num_overwritten() == 1, caseLabel);
+      VERIFY(rb.num_overwritten() == 0, caseLabel);
+   }
+}
+
+
+void testDynamicRingBufferSetCapacity()
+{
+   {
+      const std::string caseLabel{"DynamicRingBuffer::set_capacity() to larger capacity"};
+      DynamicRingBuffer<std::string> rb(3, {"a", "b", "c", "d"});
+      rb.set_capacity(5);
+      VERIFY(rb.capacity() == 5, caseLabel);
+      VERIFY(equals(rb, std::vector<std::string>{"b", "c", "d"}), caseLabel);
+
+      rb.push("e");
+      rb.push("f");
+      rb.push("g");
+      VERIFY(equals(rb, std::vector<std::string>{"c", "d", "e", "f", "g"}), caseLabel);
+   }
+   {
+      const std::string caseLabel{"DynamicRingBuffer::set_capacity() keeps newest"};
+      DynamicRingBuffer<int> rb(5, {1, 2, 3, 4, 5, 6, 7});
+      rb.set_capacity(2);
+      VERIFY(rb.capacity() == 2, caseLabel);
+      VERIFY(equals(rb, std::vector<int>{6, 7}), caseLabel);
+   }
+   {
+      const std::string caseLabel{"DynamicRingBuffer::set_capacity() to zero"};
+      DynamicRingBuffer<int> rb(5, {1, 2});
+      rb.set_capacity(0);
+      VERIFY(rb.capacity() == 0, caseLabel);
+      VERIFY(rb.empty(), caseLabel);
+   }
+   {
+      const std::string caseLabel{"DynamicRingBuffer::set_capacity() from zero"};
+      DynamicRingBuffer<int> rb;
+      rb.set_capacity(2);
+      rb.push(1);
+      VERIFY(equals(rb, std::vector<int>{1}), caseLabel);
+   }
+}
+
+
+void testDynamicRingBufferElementLifetime()
+{
+   {
+      const std::string caseLabel{"DynamicRingBuffer does not construct unused slots"};
+      Counted::numAlive = 0;
+      {
+         DynamicRingBuffer<Counted> rb(100);
+         VERIFY(Counted::numAlive == 0, caseLabel);
+         for (int i = 0; i < 150; ++i)
+            rb.emplace(i);
+         VERIFY(Counted::numAlive == 100, caseLabel);
+
+         rb.pop();
+         rb.pop_front();
+         rb.consume(8);
+         VERIFY(Counted::numAlive == 90, caseLabel);
+         VERIFY(rb[0].val == 59, caseLabel);
+      }
+      VERIFY(Counted::numAlive == 0, caseLabel);
+   }
+   {
+      const std::string caseLabel{"DynamicRingBuffer copies and reallocations"};
+      Counted::numAlive = 0;
+      {
+         DynamicRingBuffer<Counted> rb(4);
+         for (int i = 0; i < 6; ++i)
+            rb.emplace(i);
+
+         DynamicRingBuffer<Counted> copy{rb};
+         VERIFY(Counted::numAlive == 8, caseLabel);
+         VERIFY(copy[0].val == 2 && copy[3].val == 5, caseLabel);
+
+         rb.set_capacity(2);
+         VERIFY(Counted::numAlive == 6, caseLabel);
+         VERIFY(rb[0].val == 4 && rb[1].val == 5, caseLabel);
+
+         copy.clear();
+         VERIFY(Counted::numAlive == 2, caseLabel);
+      }
+      VERIFY(Counted::numAlive == 0, caseLabel);
+   }
+}
+
+
+void testDynamicRingBufferAllocators()
+{
+   {
+      const std::string caseLabel{"DynamicRingBuffer with cache line aligned storage"};
+      DynamicRingBuffer<int, OverflowPolicy::Overwrite, AlignedAllocator<int, 64>> rb(
+         10, {1, 2, 3});
+      const auto addr = reinterpret_cast<std::uintptr_t>(&rb.readable_spans().first[0]);
+      VERIFY(addr % 64 == 0, caseLabel);
+      VERIFY(equals(rb, std::vector<int>{1, 2, 3}), caseLabel);
+   }
+   {
+      const std::string caseLabel{"DynamicRingBuffer with huge page allocator"};
+      DynamicRingBuffer<double, OverflowPolicy::Overwrite, HugePageAllocator<double>> rb(
+         100000);
+      for (int i = 0; i < 200000; ++i)
+         rb.push(i);
+      VERIFY(rb.full(), caseLabel);
+      VERIFY(rb[0] == 100000 && rb[rb.size() - 1] == 199999, caseLabel);
+      // Pushing exactly twice the capacity leaves the oldest element in the first slot.
+      const auto* first = rb.readable_spans().first.data();
+      const auto addr = reinterpret_cast<std::uintptr_t>(first);
+      VERIFY(addr % HugePageSize == 0, caseLabel);
+   }
+   {
+      const std::string caseLabel{"pmr::DynamicRingBuffer allocates from resource"};
+      CountingResource res;
+      {
+         pmr::DynamicRingBuffer<std::string> rb(3, {"a", "b", "c", "d"}, &res);
+         VERIFY(rb.get_allocator().resource() == &res, caseLabel);
+         VERIFY(res.numAllocs == 1, caseLabel);
+         VERIFY(equals(rb, std::vector<std::string>{"b", "c", "d"}), caseLabel);
+      }
+      VERIFY(res.numAllocatedBytes == 0, caseLabel);
+   }
+   {
+      const std::string caseLabel{
+         "pmr::DynamicRingBuffer copy assignment keeps resource"};
+      CountingResource resA;
+      CountingResource resB;
+      {
+         const pmr::DynamicRingBuffer<int> a(3, {1, 2, 3, 4}, &resA);
+         pmr::DynamicRingBuffer<int> b(10, {7}, &resB);
+         b = a;
+         VERIFY(b.get_allocator().resource() == &resB, caseLabel);
+         VERIFY(equals(b, std::vector<int>{2, 3, 4}), caseLabel);
+         VERIFY(resA.numAllocs == 1 && resB.numAllocs == 2, caseLabel);
+      }
+      VERIFY(resA.numAllocatedBytes == 0, caseLabel);
+      VERIFY(resB.numAllocatedBytes == 0, caseLabel);
+   }
+   {
+      const std::string caseLabel{
+         "pmr::DynamicRingBuffer move assignment with different resources"};
+      CountingResource resA;
+      CountingResource resB;
+      {
+         pmr::DynamicRingBuffer<std::string> a(3, {"a", "b", "c", "d"}, &resA);
+         pmr::DynamicRingBuffer<std::string> b(10, &resB);
+         b = std::move(a);
+         // Allocators of pmr containers don't propagate, so the elements get moved into
+         // storage allocated from b's resource.
+         VERIFY(b.get_allocator().resource() == &resB, caseLabel);
+         VERIFY(b.capacity() == 3, caseLabel);
+         VERIFY(equals(b, std::vector<std::string>{"b", "c", "d"}), caseLabel);
+         VERIFY(b.num_overwritten() == 1, caseLabel);
+         VERIFY(a.empty() && a.num_overwritten() == 0, caseLabel);
+         VERIFY(resB.numAllocs == 2, caseLabel);
+      }
+      VERIFY(resA.numAllocatedBytes == 0, caseLabel);
+      VERIFY(resB.numAllocatedBytes == 0, caseLabel);
+   }
+   {
+      const std::string caseLabel{
+         "pmr::DynamicRingBuffer move assignment with same resource"};
+      CountingResource res;
+      {
+         pmr::DynamicRingBuffer<int> a(3, {1, 2, 3}, &res);
+         pmr::DynamicRingBuffer<int> b(10, &res);
+         b = std::move(a);
+         VERIFY(equals(b, std::vector<int>{1, 2, 3}), caseLabel);
+         VERIFY(a.capacity() == 0, caseLabel);
+         VERIFY(res.numAllocs == 2, caseLabel);
+      }
+      VERIFY(res.numAllocatedBytes == 0, caseLabel);
+   }
+   {
+      const std::string caseLabel{"pmr::DynamicRingBuffer swap with same resource"};
+      CountingResource res;
+      {
+         pmr::DynamicRingBuffer<int> a(3, {1, 2, 3}, &res);
+         pmr::DynamicRingBuffer<int> b(10, {7}, &res);
+         a.swap(b);
+         VERIFY(equals(a, std::vector<int>{7}), caseLabel);
+         VERIFY(equals(b, std::vector<int>{1, 2, 3}), caseLabel);
+      }
+      VERIFY(res.numAllocatedBytes == 0, caseLabel);
+   }
+   {
+      const std::string caseLabel{
+         "pmr::DynamicRingBuffer copy ctor uses default resource"};
+      CountingResource res;
+      pmr::DynamicRingBuffer<int> rb(3, {1, 2}, &res);
+      pmr::DynamicRingBuffer<int> copy{rb};
+      VERIFY(copy.get_allocator().resource() == std::pmr::get_default_resource(),
+             caseLabel);
+      VERIFY(equals(copy, std::vector<int>{1, 2}), caseLabel);
+      pmr::DynamicRingBuffer<int> copyWithAlloc{rb, &res};
+      VERIFY(copyWithAlloc.get_allocator().resource() == &res, caseLabel);
+   }
+}
+
+} // namespace
+
+
+///////////////////
+
+void testDynamicRingBuffer()
+{
+   testDynamicRingBufferCtors();
+   testDynamicRingBufferCopyAndMove();
+   testDynamicRingBufferAccess();
+   testDynamicRingBufferPushPop();
+   testDynamicRingBufferBulkOperations();
+   testDynamicRingBufferSpans();
+   testDynamicRingBufferOverflowPolicy();
+   testDynamicRingBufferSetCapacity();
+   testDynamicRingBufferElementLifetime();
+   testDynamicRingBufferAllocators();
+}
@@ -5,6 +5,9 @@
 #include "HeapTests.h"
 #include "Heap.h"
 #include "TestUtil.h"
+#include <algorithm>
+#include <functional>
+#include <string>
 #include <vector>
 
 using namespace ds;
@@ -176,6 +179,269 @@ void testHeapViewPop()
          
       VERIFY(h.empty(), caseLabel);
    }
+   {
+      const std::string caseLabel{"HeapView::pop() for heap with duplicate elements"};
+
+      std::vector<int> v;
+      for (int i = 0; i < 200; ++i)
+         v.push_back((i * 37) % 11);
+      std::vector<int> expected = v;
+      std::sort(expected.begin(), expected.end(), std::greater<int>{});
+
+      MaxHeap<int> h{v};
+      for (size_t i = 0; i < expected.size(); ++i)
+         VERIFY(h.pop() == expected[i], caseLabel);
+      VERIFY(h.empty(), caseLabel);
+   }
+   {
+      const std::string caseLabel{"HeapView::pop() sorts underlying storage"};
+
+      std::vector<std::string> v;
+      for (int i = 0; i < 100; ++i)
+         v.push_back("s" + std::to_string((i * 53) % 97));
+      std::vector<std::string> expected = v;
+      std::sort(expected.begin(), expected.end(), std::greater<std::string>{});
+
+      MinHeap<std::string> h{v};
+      while (!h.empty())
+         h.pop();
+
+      VERIFY(v == expected, caseLabel);
+   }
+}
+
+void testHeapViewHeapify()
+{
+   {
+      const std::string caseLabel{"HeapView::heapify() for root that sinks to leaf"};
+
+      std::vector<int> v{800, 444, 34, 6, 3, 2};
+      MaxHeap<int> h{v};
+      v[0] = 1;
+      h.heapify(1);
+
+      const std::vector<int> expected{444, 34, 6, 3, 2, 1};
+      for (size_t i = 0; i < expected.size(); ++i)
+         VERIFY(h.pop() == expected[i], caseLabel);
+   }
+   {
+      const std::string caseLabel{"HeapView::heapify() for root that stays in place"};
+
+      std::vector<int> v{800, 444, 34, 6, 3, 2};
+      MaxHeap<int> h{v};
+      v[0] = 900;
+      h.heapify(1);
+
+      VERIFY(v[0] == 900, caseLabel);
+      const std::vector<int> expected{900, 444, 34, 6, 3, 2};
+      for (size_t i = 0; i < expected.size(); ++i)
+         VERIFY(h.pop() == expected[i], caseLabel);
+   }
+   {
+      const std::string caseLabel{"HeapView::heapify() for inner node"};
+
+      std::vector<int> v{1, 2, 3, 4, 5, 6, 7, 8, 9, 10};
+      MinHeap<int> h{v};
+      // Node 2 has the subtree with elements 2, 4, 5, 8, 9, 10.
+      v[1] = 7;
+      h.heapify(2);
+
+      const std::vector<int> expected{1, 3, 4, 5, 6, 7, 7, 8, 9, 10};
+      for (size_t i = 0; i < expected.size(); ++i)
+         VERIFY(h.pop() == expected[i], caseLabel);
+   }
+}
+
+void testHeapViewHeapifyBottomUp()
+{
+   {
+      const std::string caseLabel{
+         "HeapView::heapifyBottomUp() for root that sinks to leaf"};
+
+      std::vector<int> v{800, 444, 34, 6, 3, 2};
+      MaxHeap<int> h{v};
+      v[0] = 1;
+      h.heapifyBottomUp(1);
+
+      const std::vector<int> expected{444, 34, 6, 3, 2, 1};
+      for (size_t i = 0; i < expected.size(); ++i)
+         VERIFY(h.pop() == expected[i], caseLabel);
+   }
+   {
+      const std::string caseLabel{
+         "HeapView::heapifyBottomUp() for root that stays in place"};
+
+      std::vector<int> v{800, 444, 34, 6, 3, 2};
+      MaxHeap<int> h{v};
+      v[0] = 900;
+      h.heapifyBottomUp(1);
+
+      VERIFY(v[0] == 900, caseLabel);
+      const std::vector<int> expected{900, 444, 34, 6, 3, 2};
+      for (size_t i = 0; i < expected.size(); ++i)
+         VERIFY(h.pop() == expected[i], caseLabel);
+   }
+   {
+      const std::string caseLabel{"HeapView::heapifyBottomUp() for inner node"};
+
+      std::vector<int> v{1, 2, 3, 4, 5, 6, 7, 8, 9, 10};
+      MinHeap<int> h{v};
+      v[1] = 7;
+      h.heapifyBottomUp(2);
+
+      const std::vector<int> expected{1, 3, 4, 5, 6, 7, 7, 8, 9, 10};
+      for (size_t i = 0; i < expected.size(); ++i)
+         VERIFY(h.pop() == expected[i], caseLabel);
+   }
+   {
+      const std::string caseLabel{
+         "HeapView::heapifyBottomUp() for node with single child"};
+
+      std::vector<int> v{1, 2, 3, 4};
+      MinHeap<int> h{v};
+      v[1] = 5;
+      h.heapifyBottomUp(2);
+
+      VERIFY(v[1] == 4 && v[3] == 5, caseLabel);
+   }
+}
+
+void testHeapViewRemoveTop()
+{
+   {
+      const std::string caseLabel{"HeapView::removeTop() throws for empty heap"};
+
+      MaxHeap<int> h;
+      VERIFY_THROW([&h]() { h.removeTop(); }, std::runtime_error, caseLabel);
+   }
+   {
+      const std::string caseLabel{"HeapView::removeTop() moves top behind heap"};
+
+      std::vector<int> v{3, 6, 800, 34, 444, 2};
+      MaxHeap<int> h{v};
+      h.removeTop();
+
+      VERIFY(h.size() == 5, caseLabel);
+      VERIFY(v[5] == 800, caseLabel);
+      VERIFY(h.top() == 444, caseLabel);
+   }
+}
+
+void testHeapViewHeapifyUp()
+{
+   {
+      const std::string caseLabel{"HeapView::heapifyUp() for added element"};
+
+      std::vector<int> v{3, 6, 800, 34, 444, 2};
+      MinHeap<int> h{v};
+      v.push_back(1);
+      h.set(v.data(), v.size());
+      h.heapifyUp(v.size());
+
+      const std::vector<int> expected{1, 2, 3, 6, 34, 444, 800};
+      for (size_t i = 0; i < expected.size(); ++i)
+         VERIFY(h.pop() == expected[i], caseLabel);
+   }
+   {
+      const std::string caseLabel{"HeapView::heapifyUp() for element that stays"};
+
+      std::vector<int> v{3, 6, 800, 34, 444, 2};
+      MinHeap<int> h{v};
+      v.push_back(1000);
+      h.set(v.data(), v.size());
+      h.heapifyUp(v.size());
+
+      VERIFY(v.back() == 1000, caseLabel);
+      VERIFY(h.top() == 2, caseLabel);
+   }
+}
+
+template <std::size_t Arity> void verifyHeapViewSortsWithArity()
+{
+   const std::string caseLabel{"HeapView with arity " + std::to_string(Arity)};
+
+   for (size_t n = 0; n < 70; ++n)
+   {
+      std::vector<int> v;
+      for (size_t i = 0; i < n; ++i)
+         v.push_back(static_cast<int>((i * 37) % 23));
+      std::vector<int> expected = v;
+      std::sort(expected.begin(), expected.end());
+
+      MinHeap<int, Arity> h{v};
+      VERIFY(h.size() == n, caseLabel);
+      for (size_t i = 0; i < n; ++i)
+         VERIFY(h.pop() == expected[i], caseLabel);
+      VERIFY(h.empty(), caseLabel);
+   }
+}
+
+void testHeapViewNavigation()
+{
+   {
+      const std::string caseLabel{"HeapView navigation for binary heap"};
+
+      using Heap = MaxHeap<int>;
+      VERIFY(Heap::parent(1) == 0, caseLabel);
+      VERIFY(Heap::parent(2) == 1, caseLabel);
+      VERIFY(Heap::parent(3) == 1, caseLabel);
+      VERIFY(Heap::parent(7) == 3, caseLabel);
+      VERIFY(Heap::firstChild(1) == 2, caseLabel);
+      VERIFY(Heap::lastChild(1) == 3, caseLabel);
+      VERIFY(Heap::firstChild(3) == 6, caseLabel);
+      VERIFY(Heap::lastChild(3) == 7, caseLabel);
+   }
+   {
+      const std::string caseLabel{"HeapView navigation for 4-ary heap"};
+
+      using Heap = MaxHeap<int, 4>;
+      VERIFY(Heap::parent(1) == 0, caseLabel);
+      VERIFY(Heap::parent(2) == 1, caseLabel);
+      VERIFY(Heap::parent(5) == 1, caseLabel);
+      VERIFY(Heap::parent(6) == 2, caseLabel);
+      VERIFY(Heap::parent(9) == 2, caseLabel);
+      VERIFY(Heap::parent(10) == 3, caseLabel);
+      VERIFY(Heap::firstChild(1) == 2, caseLabel);
+      VERIFY(Heap::lastChild(1) == 5, caseLabel);
+      VERIFY(Heap::firstChild(2) == 6, caseLabel);
+      VERIFY(Heap::lastChild(2) == 9, caseLabel);
+   }
+   {
+      const std::string caseLabel{"HeapView navigation for 8-ary heap"};
+
+      using Heap = MaxHeap<int, 8>;
+      VERIFY(Heap::parent(9) == 1, caseLabel);
+      VERIFY(Heap::parent(10) == 2, caseLabel);
+      VERIFY(Heap::firstChild(2) == 10, caseLabel);
+      VERIFY(Heap::lastChild(2) == 17, caseLabel);
+      for (size_t i = 1; i < 100; ++i)
+      {
+         for (size_t c = Heap::firstChild(i); c <= Heap::lastChild(i); ++c)
+            VERIFY(Heap::parent(c) == i, caseLabel);
+      }
+   }
+}
+
+void testHeapViewArity()
+{
+   verifyHeapViewSortsWithArity<2>();
+   verifyHeapViewSortsWithArity<3>();
+   verifyHeapViewSortsWithArity<4>();
+   verifyHeapViewSortsWithArity<8>();
+
+   {
+      const std::string caseLabel{"HeapView::heapify() for 4-ary heap"};
+
+      std::vector<int> v{1, 2, 3, 4, 5, 6, 7, 8, 9, 10};
+      MinHeap<int, 4> h{v};
+      // Node 2 has the children 6 to 9.
+      v[1] = 8;
+      h.heapify(2);
+
+      const std::vector<int> expected{1, 3, 4, 5, 6, 7, 8, 8, 9, 10};
+      for (size_t i = 0; i < expected.size(); ++i)
+         VERIFY(h.pop() == expected[i], caseLabel);
+   }
 }
 
 } // namespace
@@ -191,4 +457,10 @@ void testHeapView()
    testHeapViewSize();
    testHeapViewEmpty();
    testHeapViewPop();
+   testHeapViewHeapify();
+   testHeapViewHeapifyBottomUp();
+   testHeapViewRemoveTop();
+   testHeapViewHeapifyUp();
+   testHeapViewNavigation();
+   testHeapViewArity();
 }
@@ -0,0 +1,342 @@
+#include "IndexedPriorityQueueTests.h"
+#include "IndexedPriorityQueue.h"
+#include "TestUtil.h"
+#include <functional>
+#include <limits>
+#include <map>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace ds;
+
+
+///////////////////
+
+namespace
+{
+
+// Pops all entries and returns their handles in pop order.
+template <typename Queue> std::vector<std::size_t> popHandles(Queue& q)
+{
+   std::vector<std::size_t> handles;
+   while (!q.empty())
+      handles.push_back(q.pop().handle);
+   return handles;
+}
+
+
+void testIndexedPriorityQueueCtor()
+{
+   {
+      const std::string caseLabel{"IndexedPriorityQueue default ctor"};
+      const IndexedPriorityQueue<int> q;
+      VERIFY(q.empty(), caseLabel);
+      VERIFY(q.size() == 0, caseLabel);
+      VERIFY(!q.contains(0), caseLabel);
+   }
+   {
+      const std::string caseLabel{"IndexedPriorityQueue ctor with criterium"};
+      IndexedPriorityQueue<int, std::greater<int>> q{std::greater<int>{}};
+      q.insert(0, 5);
+      q.insert(1, 9);
+      VERIFY(q.top().handle == 1, caseLabel);
+   }
+}
+
+
+void testIndexedPriorityQueueInsert()
+{
+   {
+      const std::string caseLabel{"IndexedPriorityQueue::insert"};
+      IndexedPriorityQueue<int> q;
+      q.insert(3, 30);
+      q.insert(0, 10);
+      q.insert(7, 5);
+      VERIFY(q.size() == 3, caseLabel);
+      VERIFY(q.contains(0) && q.contains(3) && q.contains(7), caseLabel);
+      VERIFY(!q.contains(1) && !q.contains(8), caseLabel);
+      VERIFY(q.top().handle == 7 && q.top().prio == 5, caseLabel);
+      VERIFY(q.priority(3) == 30, caseLabel);
+   }
+   {
+      const std::string caseLabel{"IndexedPriorityQueue::insert for queued handle"};
+      IndexedPriorityQueue<int> q;
+      q.insert(2, 1);
+      VERIFY_THROW([&]() { q.insert(2, 5); }, std::runtime_error, caseLabel);
+      VERIFY(q.size() == 1 && q.priority(2) == 1, caseLabel);
+   }
+   {
+      const std::string caseLabel{"IndexedPriorityQueue::insert after pop"};
+      IndexedPriorityQueue<int> q;
+      q.insert(2, 1);
+      q.pop();
+      q.insert(2, 4);
+      VERIFY(q.contains(2) && q.priority(2) == 4, caseLabel);
+   }
+}
+
+
+void testIndexedPriorityQueuePop()
+{
+   {
+      const std::string caseLabel{"IndexedPriorityQueue::pop for empty queue"};
+      IndexedPriorityQueue<int> q;
+      VERIFY_THROW([&]() { q.pop(); }, std::runtime_error, caseLabel);
+      VERIFY_THROW([&]() { q.top(); }, std::runtime_error, caseLabel);
+   }
+   {
+      const std::string caseLabel{"IndexedPriorityQueue::pop"};
+      IndexedPriorityQueue<std::string> q;
+      q.insert(0, "d");
+      q.insert(1, "b");
+      q.insert(2, "e");
+      q.insert(3, "a");
+      q.insert(4, "c");
+
+      const auto entry = q.pop();
+      VERIFY(entry.handle == 3 && entry.prio == "a", caseLabel);
+      VERIFY(!q.contains(3), caseLabel);
+      VERIFY((popHandles(q) == std::vector<std::size_t>{1, 4, 0, 2}), caseLabel);
+   }
+}
+
+
+void testIndexedPriorityQueueUpdate()
+{
+   {
+      const std::string caseLabel{"IndexedPriorityQueue::update to higher priority"};
+      IndexedPriorityQueue<int> q;
+      for (std::size_t h = 0; h < 10; ++h)
+         q.insert(h, static_cast<int>(h) * 10);
+      q.update(8, -1);
+      VERIFY(q.top().handle == 8 && q.priority(8) == -1, caseLabel);
+      VERIFY((popHandles(q) == std::vector<std::size_t>{8, 0, 1, 2, 3, 4, 5, 6, 7, 9}),
+             caseLabel);
+   }
+   {
+      const std::string caseLabel{"IndexedPriorityQueue::update to lower priority"};
+      IndexedPriorityQueue<int> q;
+      for (std::size_t h = 0; h < 10; ++h)
+         q.insert(h, static_cast<int>(h) * 10);
+      q.update(0, 55);
+      VERIFY(q.top().handle == 1, caseLabel);
+      VERIFY((popHandles(q) == std::vector<std::size_t>{1, 2, 3, 4, 5, 0, 6, 7, 8, 9}),
+             caseLabel);
+   }
+   {
+      const std::string caseLabel{"IndexedPriorityQueue::update for unknown handle"};
+      IndexedPriorityQueue<int> q;
+      q.insert(1, 1);
+      VERIFY_THROW([&]() { q.update(0, 5); }, std::out_of_range, caseLabel);
+      VERIFY_THROW([&]() { q.update(2, 5); }, std::out_of_range, caseLabel);
+      VERIFY_THROW([&]() { q.priority(2); }, std::out_of_range, caseLabel);
+   }
+}
+
+
+void testIndexedPriorityQueueErase()
+{
+   {
+      const std::string caseLabel{"IndexedPriorityQueue::erase top"};
+      IndexedPriorityQueue<int> q;
+      for (std::size_t h = 0; h < 6; ++h)
+         q.insert(h, static_cast<int>(h));
+      q.erase(0);
+      VERIFY(!q.contains(0) && q.size() == 5, caseLabel);
+      VERIFY((popHandles(q) == std::vector<std::size_t>{1, 2, 3, 4, 5}), caseLabel);
+   }
+   {
+      const std::string caseLabel{"IndexedPriorityQueue::erase inner entry"};
+      IndexedPriorityQueue<int> q;
+      for (std::size_t h = 0; h < 9; ++h)
+         q.insert(h, static_cast<int>(h));
+      q.erase(1);
+      q.erase(6);
+      VERIFY((popHandles(q) == std::vector<std::size_t>{0, 2, 3, 4, 5, 7, 8}), caseLabel);
+   }
+   {
+      const std::string caseLabel{"IndexedPriorityQueue::erase last entry"};
+      IndexedPriorityQueue<int> q;
+      q.insert(0, 1);
+      q.insert(1, 2);
+      q.erase(1);
+      q.erase(0);
+      VERIFY(q.empty(), caseLabel);
+   }
+   {
+      const std::string caseLabel{"IndexedPriorityQueue::erase for unknown handle"};
+      IndexedPriorityQueue<int> q;
+      q.insert(1, 1);
+      VERIFY_THROW([&]() { q.erase(0); }, std::out_of_range, caseLabel);
+      VERIFY_THROW([&]() { q.erase(5); }, std::out_of_range, caseLabel);
+      VERIFY(q.size() == 1, caseLabel);
+   }
+}
+
+
+void testIndexedPriorityQueueCopyAndMove()
+{
+   {
+      const std::string caseLabel{"IndexedPriorityQueue copy ctor"};
+      IndexedPriorityQueue<int> q;
+      q.insert(0, 3);
+      q.insert(1, 1);
+      IndexedPriorityQueue<int> copy{q};
+      q.update(0, 0);
+      VERIFY(copy.top().handle == 1, caseLabel);
+      VERIFY((popHandles(copy) == std::vector<std::size_t>{1, 0}), caseLabel);
+      VERIFY(q.size() == 2 && q.top().handle == 0, caseLabel);
+   }
+   {
+      const std::string caseLabel{"IndexedPriorityQueue move ctor"};
+      IndexedPriorityQueue<int> q;
+      q.insert(0, 3);
+      q.insert(1, 1);
+      IndexedPriorityQueue<int> moved{std::move(q)};
+      VERIFY(q.empty() && !q.contains(0), caseLabel);
+      VERIFY((popHandles(moved) == std::vector<std::size_t>{1, 0}), caseLabel);
+   }
+   {
+      const std::string caseLabel{"IndexedPriorityQueue copy and move assignment"};
+      IndexedPriorityQueue<int> q;
+      q.insert(0, 3);
+      q.insert(1, 1);
+      IndexedPriorityQueue<int> copy;
+      copy = q;
+      IndexedPriorityQueue<int> moved;
+      moved = std::move(q);
+      VERIFY(q.empty(), caseLabel);
+      VERIFY((popHandles(copy) == std::vector<std::size_t>{1, 0}), caseLabel);
+      VERIFY((popHandles(moved) == std::vector<std::size_t>{1, 0}), caseLabel);
+   }
+}
+
+
+template <std::size_t Arity> void verifyIndexedPriorityQueueRandomOps()
+{
+   const std::string caseLabel{"IndexedPriorityQueue random operations with arity " +
+                               std::to_string(Arity)};
+
+   std::mt19937 gen{42};
+   std::uniform_int_distribution<std::size_t> handleDist{0, 63};
+   std::uniform_int_distribution<int> prioDist{0, 1000};
+   std::uniform_int_distribution<int> opDist{0, 3};
+
+   IndexedPriorityQueue<int, std::less<int>, Arity> q;
+   // Reference with the priority of each queued handle.
+   std::map<std::size_t, int> expected;
+
+   for (int i = 0; i < 5000; ++i)
+   {
+      const std::size_t h = handleDist(gen);
+      const int prio = prioDist(gen);
+      switch (opDist(gen))
+      {
+      case 0:
+         if (!q.contains(h))
+         {
+            q.insert(h, prio);
+            expected[h] = prio;
+         }
+         break;
+      case 1:
+         if (q.contains(h))
+         {
+            q.update(h, prio);
+            expected[h] = prio;
+         }
+         break;
+      case 2:
+         if (q.contains(h))
+         {
+            q.erase(h);
+            expected.erase(h);
+         }
+         break;
+      default:
+         if (!q.empty())
+         {
+            const auto entry = q.pop();
+            VERIFY(expected.at(entry.handle) == entry.prio, caseLabel);
+            for (const auto& [handle, p] : expected)
+               VERIFY(entry.prio <= p, caseLabel);
+            expected.erase(entry.handle);
+         }
+         break;
+      }
+
+      VERIFY(q.size() == expected.size(), caseLabel);
+      VERIFY(q.contains(h) == (expected.count(h) > 0), caseLabel);
+   }
+}
+
+
+void testIndexedPriorityQueueRandomOps()
+{
+   verifyIndexedPriorityQueueRandomOps<2>();
+   verifyIndexedPriorityQueueRandomOps<4>();
+   verifyIndexedPriorityQueueRandomOps<8>();
+}
+
+
+void testIndexedPriorityQueueDijkstra()
+{
+   {
+      const std::string caseLabel{"IndexedPriorityQueue for shortest paths"};
+
+      // Weighted edges of a directed graph.
+      struct Edge
+      {
+         std::size_t to;
+         int weight;
+      };
+      const std::vector<std::vector<Edge>> graph{
+         {{1, 7}, {2, 9}, {5, 14}}, {{2, 10}, {3, 15}}, {{3, 11}, {5, 2}},
+         {{4, 6}},                  {},                 {{4, 9}}};
+
+      constexpr int Inf = std::numeric_limits<int>::max();
+      std::vector<int> dist(graph.size(), Inf);
+      dist[0] = 0;
+
+      IndexedPriorityQueue<int> q;
+      q.insert(0, 0);
+      while (!q.empty())
+      {
+         const auto [d, v] = q.pop();
+         for (const Edge& e : graph[v])
+         {
+            if (d + e.weight < dist[e.to])
+            {
+               const bool queued = dist[e.to] != Inf;
+               dist[e.to] = d + e.weight;
+               if (queued)
+                  q.update(e.to, dist[e.to]);
+               else
+                  q.insert(e.to, dist[e.to]);
+            }
+         }
+      }
+
+      VERIFY((dist == std::vector<int>{0, 7, 9, 20, 20, 11}), caseLabel);
+   }
+}
+
+} // namespace
+
+
+///////////////////
+
+void testIndexedPriorityQueue()
+{
+   testIndexedPriorityQueueCtor();
+   testIndexedPriorityQueueInsert();
+   testIndexedPriorityQueuePop();
+   testIndexedPriorityQueueUpdate();
+   testIndexedPriorityQueueErase();
+   testIndexedPriorityQueueCopyAndMove();
+   testIndexedPriorityQueueRandomOps();
+   testIndexedPriorityQueueDijkstra();
+}
@@ -0,0 +1,241 @@
+#include "MappedRingBufferTests.h"
+#include "MappedRingBuffer.h"
+#include "TestUtil.h"
+#include <algorithm>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace ds;
+
+
+///////////////////
+
+namespace
+{
+
+struct Event
+{
+   uint32_t id = 0;
+   double time = 0.;
+};
+
+
+// Path of a file in the temp directory that gets removed when going out of scope.
+class TempFile
+{
+ public:
+   explicit TempFile(const std::string& name)
+   : m_path{std::filesystem::temp_directory_path() / name}
+   {
+      std::filesystem::remove(m_path);
+   }
+   ~TempFile() { std::filesystem::remove(m_path); }
+
+   const std::filesystem::path& path() const { return m_path; }
+
+ private:
+   std::filesystem::path m_path;
+};
+
+
+template <typename RB, typename Value>
+bool equals(const RB& rb, const std::vector<Value>& expected)
+{
+   return rb.size() == expected.size() &&
+          std::equal(rb.begin(), rb.end(), expected.begin());
+}
+
+
+void testMappedRingBufferCreate()
+{
+   {
+      const std::string caseLabel{"MappedRingBuffer creates file"};
+      TempFile file{"dscpp_mapped_rb_create.bin"};
+      MappedRingBuffer<int> rb(file.path(), 10);
+      VERIFY(std::filesystem::exists(file.path()), caseLabel);
+      VERIFY(rb.empty(), caseLabel);
+      VERIFY(!rb.full(), caseLabel);
+      VERIFY(rb.capacity() == 10, caseLabel);
+   }
+   {
+      const std::string caseLabel{"MappedRingBuffer with zero capacity"};
+      TempFile file{"dscpp_mapped_rb_zero.bin"};
+      VERIFY_THROW([&file]() { MappedRingBuffer<int> rb(file.path(), 0); },
+                   std::runtime_error, caseLabel);
+   }
+}
+
+
+void testMappedRingBufferPush()
+{
+   {
+      const std::string caseLabel{"MappedRingBuffer::push()"};
+      TempFile file{"dscpp_mapped_rb_push.bin"};
+      MappedRingBuffer<int> rb(file.path(), 3);
+      rb.push(1);
+      rb.push(2);
+      VERIFY(equals(rb, std::vector<int>{1, 2}), caseLabel);
+      VERIFY(rb.at(1) == 2, caseLabel);
+      VERIFY_THROW([&rb]() { rb.at(2); }, std::out_of_range, caseLabel);
+   }
+   {
+      const std::string caseLabel{"MappedRingBuffer::push() overwrites oldest"};
+      TempFile file{"dscpp_mapped_rb_overwrite.bin"};
+      MappedRingBuffer<int> rb(file.path(), 3);
+      for (int i = 1; i <= 7; ++i)
+         rb.push(i);
+      VERIFY(rb.full(), caseLabel);
+      VERIFY(equals(rb, std::vector<int>{5, 6, 7}), caseLabel);
+
+      const auto spans = rb.readable_spans();
+      VERIFY(spans.first.size() == 2 && spans.second.size() == 1, caseLabel);
+      VERIFY(spans.first[0] == 5 && spans.second[0] == 7, caseLabel);
+   }
+   {
+      const std::string caseLabel{"MappedRingBuffer::write()"};
+      TempFile file{"dscpp_mapped_rb_write.bin"};
+      MappedRingBuffer<int> rb(file.path(), 4);
+      const std::vector<int> vals{1, 2, 3, 4, 5, 6};
+      rb.push(0);
+      rb.write(std::span<const int>{vals.data(), 2});
+      VERIFY(equals(rb, std::vector<int>{0, 1, 2}), caseLabel);
+      VERIFY(rb.num_overwritten() == 0, caseLabel);
+      rb.write(vals);
+      VERIFY(equals(rb, std::vector<int>{3, 4, 5, 6}), caseLabel);
+      VERIFY(rb.num_overwritten() == 5, caseLabel);
+      rb.write(std::span<const int>{vals.data(), 3});
+      VERIFY(equals(rb, std::vector<int>{6, 1, 2, 3}), caseLabel);
+      VERIFY(rb.num_overwritten() == 8, caseLabel);
+      rb.reset_counters();
+      VERIFY(rb.num_overwritten() == 0, caseLabel);
+   }
+   {
+      const std::string caseLabel{"MappedRingBuffer::clear()"};
+      TempFile file{"dscpp_mapped_rb_clear.bin"};
+      MappedRingBuffer<int> rb(file.path(), 3);
+      rb.push(1);
+      rb.push(2);
+      rb.clear();
+      VERIFY(rb.empty(), caseLabel);
+      rb.push(3);
+      VERIFY(equals(rb, std::vector<int>{3}), caseLabel);
+   }
+}
+
+
+void testMappedRingBufferReopen()
+{
+   {
+      const std::string caseLabel{"MappedRingBuffer reopen for writing"};
+      TempFile file{"dscpp_mapped_rb_reopen.bin"};
+      {
+         MappedRingBuffer<int> rb(file.path(), 3);
+         for (int i = 1; i <= 4; ++i)
+            rb.push(i);
+      }
+      MappedRingBuffer<int> rb(file.path(), 3);
+      VERIFY(equals(rb, std::vector<int>{2, 3, 4}), caseLabel);
+      rb.push(5);
+      VERIFY(equals(rb, std::vector<int>{3, 4, 5}), caseLabel);
+   }
+   {
+      const std::string caseLabel{"MappedRingBuffer read surviving elements"};
+      TempFile file{"dscpp_mapped_rb_survive.bin"};
+      MappedRingBuffer<Event> writer(file.path(), 100);
+      for (uint32_t i = 0; i < 250; ++i)
+         writer.push(Event{i, i * .5});
+      writer.flush();
+
+      // Open the file while the writer is still alive, as if it had crashed.
+      const MappedRingBuffer<Event> reader(file.path());
+      VERIFY(reader.capacity() == 100, caseLabel);
+      VERIFY(reader.size() == 100, caseLabel);
+      uint32_t expectedId = 150;
+      bool inOrder = true;
+      for (const Event& ev : reader)
+         inOrder = inOrder && ev.id == expectedId++ && ev.time == ev.id * .5;
+      VERIFY(inOrder, caseLabel);
+   }
+   {
+      const std::string caseLabel{"MappedRingBuffer reopen with different capacity"};
+      TempFile file{"dscpp_mapped_rb_capacity.bin"};
+      {
+         MappedRingBuffer<int> rb(file.path(), 3);
+      }
+      VERIFY_THROW([&file]() { MappedRingBuffer<int> rb(file.path(), 4); },
+                   std::runtime_error, caseLabel);
+   }
+   {
+      const std::string caseLabel{"MappedRingBuffer reopen with different element type"};
+      TempFile file{"dscpp_mapped_rb_type.bin"};
+      {
+         MappedRingBuffer<int> rb(file.path(), 3);
+      }
+      VERIFY_THROW([&file]() { MappedRingBuffer<Event> rb(file.path()); },
+                   std::runtime_error, caseLabel);
+   }
+   {
+      const std::string caseLabel{"MappedRingBuffer open file with corrupted capacity"};
+      TempFile file{"dscpp_mapped_rb_corrupted.bin"};
+      {
+         MappedRingBuffer<int> rb(file.path(), 3);
+      }
+      {
+         // Capacity whose file size overflows. The capacity follows the magic number
+         // and the version in the header.
+         std::fstream f{file.path(), std::ios::in | std::ios::out | std::ios::binary};
+         const uint64_t capacity = std::numeric_limits<uint64_t>::max() / sizeof(int) + 1;
+         f.seekp(8);
+         f.write(reinterpret_cast<const char*>(&capacity), sizeof(capacity));
+      }
+      VERIFY_THROW([&file]() { MappedRingBuffer<int> rb(file.path()); },
+                   std::runtime_error, caseLabel);
+   }
+   {
+      const std::string caseLabel{"MappedRingBuffer with too large capacity"};
+      TempFile file{"dscpp_mapped_rb_too_large.bin"};
+      const std::size_t capacity = std::numeric_limits<std::size_t>::max() / 2;
+      VERIFY_THROW([&]() { MappedRingBuffer<int> rb(file.path(), capacity); },
+                   std::runtime_error, caseLabel);
+      VERIFY(!std::filesystem::exists(file.path()), caseLabel);
+   }
+   {
+      const std::string caseLabel{"MappedRingBuffer open missing file"};
+      TempFile file{"dscpp_mapped_rb_missing.bin"};
+      VERIFY_THROW([&file]() { MappedRingBuffer<int> rb(file.path()); },
+                   std::runtime_error, caseLabel);
+   }
+}
+
+
+void testMappedRingBufferMove()
+{
+   {
+      const std::string caseLabel{"MappedRingBuffer move ctor"};
+      TempFile file{"dscpp_mapped_rb_move.bin"};
+      MappedRingBuffer<int> rb(file.path(), 3);
+      rb.push(1);
+      MappedRingBuffer<int> moved{std::move(rb)};
+      moved.push(2);
+      VERIFY(equals(moved, std::vector<int>{1, 2}), caseLabel);
+   }
+}
+
+} // namespace
+
+
+///////////////////
+
+void testMappedRingBuffer()
+{
+   testMappedRingBufferCreate();
+   testMappedRingBufferPush();
+   testMappedRingBufferReopen();
+   testMappedRingBufferMove();
+}
@@ -0,0 +1,165 @@
+#include "MirroredRingBufferTests.h"
+#include "MirroredRingBuffer.h"
+#include "TestUtil.h"
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+// The mirrored ring buffer is only available on Linux.
+#ifdef __linux__
+
+using namespace ds;
+
+
+///////////////////
+
+namespace
+{
+
+template <typename RB, typename Value>
+bool equals(const RB& rb, const std::vector<Value>& expected)
+{
+   return rb.size() == expected.size() &&
+          std::equal(rb.begin(), rb.end(), expected.begin());
+}
+
+
+void testMirroredRingBufferCtors()
+{
+   {
+      const std::string caseLabel{"MirroredRingBuffer default ctor"};
+      MirroredRingBuffer<int> rb;
+      VERIFY(rb.empty(), caseLabel);
+      VERIFY(rb.full(), caseLabel);
+      VERIFY(rb.capacity() == 0, caseLabel);
+   }
+   {
+      const std::string caseLabel{"MirroredRingBuffer rounds capacity to pages"};
+      MirroredRingBuffer<int> rb(10);
+      VERIFY(rb.capacity() >= 10, caseLabel);
+      VERIFY((rb.capacity() * sizeof(int)) % 4096 == 0, caseLabel);
+      VERIFY(rb.empty(), caseLabel);
+   }
+   {
+      const std::string caseLabel{"MirroredRingBuffer for element size not dividing pages"};
+      struct Triple
+      {
+         int a, b, c;
+      };
+      MirroredRingBuffer<Triple> rb(1);
+      VERIFY((rb.capacity() * sizeof(Triple)) % 4096 == 0, caseLabel);
+   }
+   {
+      const std::string caseLabel{"MirroredRingBuffer move ctor"};
+      MirroredRingBuffer<int> rb(10);
+      rb.push(1);
+      MirroredRingBuffer<int> moved{std::move(rb)};
+      VERIFY(equals(moved, std::vector<int>{1}), caseLabel);
+      VERIFY(rb.capacity() == 0, caseLabel);
+   }
+}
+
+
+void testMirroredRingBufferPushPop()
+{
+   {
+      const std::string caseLabel{"MirroredRingBuffer::push() overwrites oldest"};
+      MirroredRingBuffer<int> rb(10);
+      const int cap = static_cast<int>(rb.capacity());
+      for (int i = 0; i < cap + 5; ++i)
+         rb.push(i);
+      VERIFY(rb.full(), caseLabel);
+      VERIFY(rb[0] == 5 && rb[rb.size() - 1] == cap + 4, caseLabel);
+      VERIFY(rb.at(rb.size() - 1) == cap + 4, caseLabel);
+      VERIFY_THROW([&rb]() { rb.at(rb.size()); }, std::out_of_range, caseLabel);
+      VERIFY(rb.num_overwritten() == 5, caseLabel);
+      rb.reset_counters();
+      VERIFY(rb.num_overwritten() == 0, caseLabel);
+   }
+   {
+      const std::string caseLabel{"MirroredRingBuffer::pop() and pop_front()"};
+      MirroredRingBuffer<int> rb(10);
+      rb.push(1);
+      rb.push(2);
+      rb.push(3);
+      VERIFY(rb.pop() == 3, caseLabel);
+      VERIFY(rb.pop_front() == 1, caseLabel);
+      VERIFY(equals(rb, std::vector<int>{2}), caseLabel);
+      rb.clear();
+      VERIFY_THROW([&rb]() { rb.pop(); }, std::runtime_error, caseLabel);
+      VERIFY_THROW([&rb]() { rb.pop_front(); }, std::runtime_error, caseLabel);
+   }
+}
+
+
+void testMirroredRingBufferContiguousAccess()
+{
+   {
+      const std::string caseLabel{"MirroredRingBuffer readable span across wrap"};
+      MirroredRingBuffer<int> rb(10);
+      const std::size_t cap = rb.capacity();
+      std::vector<int> vals(cap);
+      for (std::size_t i = 0; i < cap; ++i)
+         vals[i] = static_cast<int>(i);
+
+      // Move the start close to the end of the storage and wrap around.
+      rb.write(vals);
+      rb.consume(cap - 3);
+      rb.write(std::span<const int>{vals.data(), 5});
+
+      const std::span<const int> readable = rb.readable_span();
+      VERIFY(readable.size() == 8, caseLabel);
+      const std::vector<int> expected{static_cast<int>(cap) - 3, static_cast<int>(cap) - 2,
+                                      static_cast<int>(cap) - 1, 0, 1, 2, 3, 4};
+      VERIFY(std::equal(readable.begin(), readable.end(), expected.begin()), caseLabel);
+      VERIFY(equals(rb, expected), caseLabel);
+   }
+   {
+      const std::string caseLabel{"MirroredRingBuffer writable span across wrap"};
+      MirroredRingBuffer<char> rb(1);
+      const std::size_t cap = rb.capacity();
+      const std::string msg{"Hello, mirror!"};
+
+      rb.write(std::vector<char>(cap - 4, 'x'));
+      rb.consume(cap - 4);
+      std::span<char> writable = rb.writable_span();
+      VERIFY(writable.size() == cap, caseLabel);
+      std::memcpy(writable.data(), msg.data(), msg.size());
+      rb.commit(msg.size());
+
+      VERIFY(std::string(rb.readable_span().data(), rb.size()) == msg, caseLabel);
+      VERIFY_THROW([&]() { rb.commit(cap); }, std::out_of_range, caseLabel);
+   }
+   {
+      const std::string caseLabel{"MirroredRingBuffer::read()"};
+      MirroredRingBuffer<int> rb(10);
+      const std::size_t cap = rb.capacity();
+      for (std::size_t i = 0; i < cap + 2; ++i)
+         rb.push(static_cast<int>(i));
+
+      std::vector<int> out(4);
+      VERIFY(rb.read(out) == 4, caseLabel);
+      VERIFY(out == std::vector<int>({2, 3, 4, 5}), caseLabel);
+      VERIFY(rb.size() == cap - 4, caseLabel);
+   }
+}
+
+} // namespace
+
+#endif // __linux__
+
+
+///////////////////
+
+void testMirroredRingBuffer()
+{
+#ifdef __linux__
+   testMirroredRingBufferCtors();
+   testMirroredRingBufferPushPop();
+   testMirroredRingBufferContiguousAccess();
+#endif
+}
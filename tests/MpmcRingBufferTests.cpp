@@ -0,0 +1,300 @@
+#include "MpmcRingBufferTests.h"
+#include "MpmcRingBuffer.h"
+#include "TestUtil.h"
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace ds;
+
+
+///////////////////
+
+namespace
+{
+
+void testMpmcRingBufferDefaultCtor()
+{
+   {
+      const std::string caseLabel{"MpmcRingBuffer default ctor"};
+      MpmcRingBuffer<int, 10> rb;
+      VERIFY(rb.empty(), caseLabel);
+      VERIFY(!rb.full(), caseLabel);
+      VERIFY(rb.size() == 0, caseLabel);
+      VERIFY(rb.capacity() == 10, caseLabel);
+   }
+}
+
+
+void testMpmcRingBufferTryPush()
+{
+   {
+      const std::string caseLabel{"MpmcRingBuffer try_push into empty buffer"};
+      MpmcRingBuffer<int, 3> rb;
+      VERIFY(rb.try_push(1), caseLabel);
+      VERIFY(rb.size() == 1, caseLabel);
+   }
+   {
+      const std::string caseLabel{"MpmcRingBuffer try_push into full buffer"};
+      MpmcRingBuffer<int, 3> rb;
+      VERIFY(rb.try_push(1), caseLabel);
+      VERIFY(rb.try_push(2), caseLabel);
+      VERIFY(rb.try_push(3), caseLabel);
+      VERIFY(rb.full(), caseLabel);
+      VERIFY(!rb.try_push(4), caseLabel);
+      VERIFY(rb.size() == 3, caseLabel);
+
+      int val = 0;
+      VERIFY(rb.try_pop(val), caseLabel);
+      VERIFY(val == 1, caseLabel);
+   }
+   {
+      const std::string caseLabel{"MpmcRingBuffer try_push for move-only type"};
+      MpmcRingBuffer<std::unique_ptr<int>, 2> rb;
+      auto p = std::make_unique<int>(5);
+      VERIFY(rb.try_push(std::move(p)), caseLabel);
+      VERIFY(!p, caseLabel);
+
+      std::unique_ptr<int> popped;
+      VERIFY(rb.try_pop(popped), caseLabel);
+      VERIFY(popped && *popped == 5, caseLabel);
+   }
+   {
+      const std::string caseLabel{"MpmcRingBuffer failed try_push does not move value"};
+      MpmcRingBuffer<std::unique_ptr<int>, 1> rb;
+      rb.try_push(std::make_unique<int>(1));
+      auto p = std::make_unique<int>(2);
+      VERIFY(!rb.try_push(std::move(p)), caseLabel);
+      VERIFY(p && *p == 2, caseLabel);
+   }
+}
+
+
+void testMpmcRingBufferTryPop()
+{
+   {
+      const std::string caseLabel{"MpmcRingBuffer try_pop from empty buffer"};
+      MpmcRingBuffer<int, 3> rb;
+      int val = 7;
+      VERIFY(!rb.try_pop(val), caseLabel);
+      VERIFY(val == 7, caseLabel);
+   }
+   {
+      const std::string caseLabel{"MpmcRingBuffer try_pop when wrapping around"};
+      MpmcRingBuffer<std::string, 3> rb;
+      bool ok = true;
+      for (int i = 0; i < 20; ++i)
+      {
+         ok = ok && rb.try_push(std::to_string(i));
+         ok = ok && rb.try_push(std::to_string(i + 100));
+         std::string first;
+         std::string second;
+         ok = ok && rb.try_pop(first) && rb.try_pop(second);
+         ok = ok && first == std::to_string(i) && second == std::to_string(i + 100);
+      }
+      VERIFY(ok, caseLabel);
+      VERIFY(rb.empty(), caseLabel);
+   }
+}
+
+
+void testMpmcRingBufferBlockingPushPop()
+{
+   {
+      const std::string caseLabel{"MpmcRingBuffer push and pop without waiting"};
+      MpmcRingBuffer<int, 3> rb;
+      rb.push(1);
+      rb.push(2);
+      VERIFY(rb.pop() == 1, caseLabel);
+      VERIFY(rb.pop() == 2, caseLabel);
+      VERIFY(rb.empty(), caseLabel);
+   }
+   {
+      const std::string caseLabel{"MpmcRingBuffer pop waits for element"};
+      MpmcRingBuffer<int, 3> rb;
+
+      std::thread producer(
+         [&rb]()
+         {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            rb.push(42);
+         });
+
+      VERIFY(rb.pop() == 42, caseLabel);
+      producer.join();
+   }
+   {
+      const std::string caseLabel{"MpmcRingBuffer push waits for space"};
+      MpmcRingBuffer<int, 1> rb;
+      rb.push(1);
+
+      std::thread producer([&rb]() { rb.push(2); });
+
+      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+      VERIFY(rb.pop() == 1, caseLabel);
+      VERIFY(rb.pop() == 2, caseLabel);
+      producer.join();
+   }
+}
+
+
+void testMpmcRingBufferNumDropped()
+{
+   {
+      const std::string caseLabel{"MpmcRingBuffer counts rejected elements"};
+      MpmcRingBuffer<int, 2> rb;
+      VERIFY(rb.try_push(1), caseLabel);
+      VERIFY(rb.try_push(2), caseLabel);
+      VERIFY(!rb.try_push(3), caseLabel);
+      VERIFY(!rb.try_push_for(4, std::chrono::milliseconds(1)), caseLabel);
+      VERIFY(rb.num_dropped() == 2, caseLabel);
+
+      rb.pop();
+      VERIFY(rb.try_push(5), caseLabel);
+      VERIFY(rb.num_dropped() == 2, caseLabel);
+   }
+}
+
+
+void testMpmcRingBufferTimedPushPop()
+{
+   {
+      const std::string caseLabel{"MpmcRingBuffer try_push_for into full buffer"};
+      MpmcRingBuffer<int, 1> rb;
+      rb.push(1);
+
+      const auto start = std::chrono::steady_clock::now();
+      VERIFY(!rb.try_push_for(2, std::chrono::milliseconds(5)), caseLabel);
+      VERIFY(std::chrono::steady_clock::now() - start >= std::chrono::milliseconds(5),
+             caseLabel);
+      VERIFY(rb.size() == 1, caseLabel);
+   }
+   {
+      const std::string caseLabel{"MpmcRingBuffer try_push_for with space"};
+      MpmcRingBuffer<int, 1> rb;
+      VERIFY(rb.try_push_for(2, std::chrono::milliseconds(5)), caseLabel);
+      VERIFY(rb.pop() == 2, caseLabel);
+   }
+   {
+      const std::string caseLabel{"MpmcRingBuffer try_pop_for from empty buffer"};
+      MpmcRingBuffer<int, 1> rb;
+      int val = 0;
+
+      const auto start = std::chrono::steady_clock::now();
+      VERIFY(!rb.try_pop_for(val, std::chrono::milliseconds(5)), caseLabel);
+      VERIFY(std::chrono::steady_clock::now() - start >= std::chrono::milliseconds(5),
+             caseLabel);
+   }
+   {
+      const std::string caseLabel{"MpmcRingBuffer try_pop_for receives late element"};
+      MpmcRingBuffer<int, 1> rb;
+
+      std::thread producer(
+         [&rb]()
+         {
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+            rb.push(3);
+         });
+
+      int val = 0;
+      VERIFY(rb.try_pop_for(val, std::chrono::seconds(10)), caseLabel);
+      VERIFY(val == 3, caseLabel);
+      producer.join();
+   }
+}
+
+
+void testMpmcRingBufferConcurrentTransfer()
+{
+   {
+      const std::string caseLabel{"MpmcRingBuffer many producers and consumers"};
+      static constexpr int NumProducers = 4;
+      static constexpr int NumConsumers = 4;
+      static constexpr int NumPerProducer = 20000;
+      static constexpr int NumValues = NumProducers * NumPerProducer;
+      MpmcRingBuffer<int, 64> rb;
+
+      std::vector<std::thread> threads;
+      for (int p = 0; p < NumProducers; ++p)
+      {
+         threads.emplace_back(
+            [&rb, p]()
+            {
+               // Mix blocking and non-blocking pushes.
+               for (int i = 0; i < NumPerProducer; ++i)
+               {
+                  const int val = p * NumPerProducer + i;
+                  if (i % 2 == 0)
+                     rb.push(val);
+                  else
+                     while (!rb.try_push(val))
+                        std::this_thread::yield();
+               }
+            });
+      }
+
+      // Each consumer records which values it received. Values of one producer must
+      // arrive at each consumer in increasing order.
+      std::vector<std::vector<int>> received(NumConsumers);
+      std::atomic<int> numPopped = 0;
+      for (int c = 0; c < NumConsumers; ++c)
+      {
+         threads.emplace_back(
+            [&rb, &received, &numPopped, c]()
+            {
+               int val = 0;
+               while (numPopped.load() < NumValues)
+               {
+                  if (rb.try_pop_for(val, std::chrono::milliseconds(1)))
+                  {
+                     received[c].push_back(val);
+                     ++numPopped;
+                  }
+               }
+            });
+      }
+
+      for (auto& thread : threads)
+         thread.join();
+
+      std::vector<int> seen(NumValues, 0);
+      bool inOrder = true;
+      for (const auto& vals : received)
+      {
+         std::vector<int> lastOfProducer(NumProducers, -1);
+         for (int val : vals)
+         {
+            ++seen[val];
+            const int p = val / NumPerProducer;
+            inOrder = inOrder && val > lastOfProducer[p];
+            lastOfProducer[p] = val;
+         }
+      }
+
+      bool allOnce = true;
+      for (int count : seen)
+         allOnce = allOnce && count == 1;
+      VERIFY(allOnce, caseLabel);
+      VERIFY(inOrder, caseLabel);
+      VERIFY(rb.empty(), caseLabel);
+   }
+}
+
+} // namespace
+
+
+///////////////////
+
+void testMpmcRingBuffer()
+{
+   testMpmcRingBufferDefaultCtor();
+   testMpmcRingBufferTryPush();
+   testMpmcRingBufferTryPop();
+   testMpmcRingBufferBlockingPushPop();
+   testMpmcRingBufferTimedPushPop();
+   testMpmcRingBufferNumDropped();
+   testMpmcRingBufferConcurrentTransfer();
+}
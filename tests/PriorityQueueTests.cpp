@@ -5,6 +5,11 @@
 #include "PriorityQueueTests.h"
 #include "PriorityQueue.h"
 #include "TestUtil.h"
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
 
 using namespace ds;
 
@@ -283,6 +288,205 @@ void testPriorityQueueInsert()
    }
 }
 
+// Orders pointers by the values they point to.
+struct PointeeLess
+{
+   bool operator()(const std::unique_ptr<int>& a, const std::unique_ptr<int>& b) const
+   {
+      return *a < *b;
+   }
+};
+
+void testPriorityQueueInsertRvalue()
+{
+   {
+      const std::string caseLabel{"PriorityQueue::insert(T&&) for move-only elements"};
+
+      PriorityQueue<std::unique_ptr<int>, PointeeLess> q;
+      q.insert(std::make_unique<int>(30));
+      q.insert(std::make_unique<int>(10));
+      q.insert(std::make_unique<int>(20));
+
+      VERIFY(q.size() == 3, caseLabel);
+      VERIFY(*q.top() == 10, caseLabel);
+      for (int expected : {10, 20, 30})
+      {
+         const std::unique_ptr<int> popped = q.pop();
+         VERIFY(popped && *popped == expected, caseLabel);
+      }
+      VERIFY(q.empty(), caseLabel);
+   }
+   {
+      const std::string caseLabel{"PriorityQueue::insert(T&&) moves the element"};
+
+      PriorityQueue<std::string> q;
+      std::string val(40, 'x');
+      q.insert(std::move(val));
+
+      VERIFY(val.empty(), caseLabel);
+      VERIFY(q.top() == std::string(40, 'x'), caseLabel);
+   }
+}
+
+void testPriorityQueueEmplace()
+{
+   {
+      const std::string caseLabel{"PriorityQueue::emplace()"};
+
+      PriorityQueue<std::string> q;
+      q.emplace(3, 'c');
+      q.emplace("aa");
+      q.emplace(2, 'b');
+
+      VERIFY(q.size() == 3, caseLabel);
+      VERIFY(q.pop() == "aa", caseLabel);
+      VERIFY(q.pop() == "bb", caseLabel);
+      VERIFY(q.pop() == "ccc", caseLabel);
+   }
+   {
+      const std::string caseLabel{"PriorityQueue::emplace() for pairs"};
+
+      PriorityQueue<std::pair<int, std::string>> q;
+      q.emplace(2, "two");
+      q.emplace(1, "one");
+
+      VERIFY(q.pop().second == "one", caseLabel);
+      VERIFY(q.pop().second == "two", caseLabel);
+   }
+}
+
+void testPriorityQueueInsertRange()
+{
+   {
+      const std::string caseLabel{"PriorityQueue::insert_range() with empty range"};
+
+      PriorityQueue<int> q{{3, 1, 2}};
+      const std::vector<int> vals;
+      q.insert_range(vals.begin(), vals.end());
+
+      VERIFY(q.size() == 3, caseLabel);
+      VERIFY(q.top() == 1, caseLabel);
+   }
+   {
+      const std::string caseLabel{"PriorityQueue::insert_range() with small range"};
+
+      std::vector<int> initial;
+      for (int i = 0; i < 100; ++i)
+         initial.push_back((i * 37) % 101);
+      PriorityQueue<int> q{initial.begin(), initial.end()};
+      const std::vector<int> vals{-5, 200, 50};
+      q.insert_range(vals.begin(), vals.end());
+
+      std::vector<int> expected = initial;
+      expected.insert(expected.end(), vals.begin(), vals.end());
+      std::sort(expected.begin(), expected.end());
+
+      VERIFY(q.size() == expected.size(), caseLabel);
+      for (size_t i = 0; i < expected.size(); ++i)
+         VERIFY(q.pop() == expected[i], caseLabel);
+   }
+   {
+      const std::string caseLabel{"PriorityQueue::insert_range() with large range"};
+
+      PriorityQueue<int, std::greater<int>> q{{7, 3}, {}};
+      std::vector<int> vals;
+      for (int i = 0; i < 500; ++i)
+         vals.push_back((i * 53) % 499);
+      q.insert_range(vals.begin(), vals.end());
+
+      std::vector<int> expected = vals;
+      expected.push_back(7);
+      expected.push_back(3);
+      std::sort(expected.begin(), expected.end(), std::greater<int>{});
+
+      VERIFY(q.size() == expected.size(), caseLabel);
+      for (size_t i = 0; i < expected.size(); ++i)
+         VERIFY(q.pop() == expected[i], caseLabel);
+   }
+   {
+      const std::string caseLabel{"PriorityQueue::insert_range() into empty queue"};
+
+      PriorityQueue<std::string, std::less<std::string>, 4> q;
+      const std::vector<std::string> vals{"d", "a", "c", "b"};
+      q.insert_range(vals.begin(), vals.end());
+
+      for (const char* expected : {"a", "b", "c", "d"})
+         VERIFY(q.pop() == expected, caseLabel);
+      VERIFY(q.empty(), caseLabel);
+   }
+}
+
+void testPriorityQueueCopyAndMove()
+{
+   {
+      const std::string caseLabel{"PriorityQueue copy ctor"};
+
+      PriorityQueue<int> q{{5, 1, 3}};
+      PriorityQueue<int> copy{q};
+      q.pop();
+      q.insert(0);
+
+      VERIFY(copy.size() == 3, caseLabel);
+      for (int expected : {1, 3, 5})
+         VERIFY(copy.pop() == expected, caseLabel);
+      VERIFY(q.top() == 0, caseLabel);
+   }
+   {
+      const std::string caseLabel{"PriorityQueue move ctor"};
+
+      PriorityQueue<int> q{{5, 1, 3}};
+      PriorityQueue<int> moved{std::move(q)};
+
+      VERIFY(q.empty(), caseLabel);
+      for (int expected : {1, 3, 5})
+         VERIFY(moved.pop() == expected, caseLabel);
+   }
+   {
+      const std::string caseLabel{"PriorityQueue copy and move assignment"};
+
+      PriorityQueue<int> q{{5, 1, 3}};
+      PriorityQueue<int> copy;
+      copy = q;
+      PriorityQueue<int> moved{{9}};
+      moved = std::move(q);
+
+      VERIFY(q.empty(), caseLabel);
+      for (int expected : {1, 3, 5})
+      {
+         VERIFY(copy.pop() == expected, caseLabel);
+         VERIFY(moved.pop() == expected, caseLabel);
+      }
+   }
+}
+
+void testPriorityQueueArity()
+{
+   {
+      const std::string caseLabel{"PriorityQueue with 4-ary heap"};
+
+      PriorityQueue<int, std::less<int>, 4> q{{30, 2, 17, 99, 46, 5}};
+      q.insert(1);
+      q.insert(60);
+      q.insert(17);
+
+      const std::vector<int> expected{1, 2, 5, 17, 17, 30, 46, 60, 99};
+      for (size_t i = 0; i < expected.size(); ++i)
+         VERIFY(q.pop() == expected[i], caseLabel);
+      VERIFY(q.empty(), caseLabel);
+   }
+   {
+      const std::string caseLabel{"PriorityQueue with 8-ary heap and inserts"};
+
+      PriorityQueue<int, std::greater<int>, 8> q;
+      for (int i = 0; i < 100; ++i)
+         q.insert((i * 41) % 100);
+
+      for (int i = 99; i >= 0; --i)
+         VERIFY(q.pop() == i, caseLabel);
+      VERIFY(q.empty(), caseLabel);
+   }
+}
+
 } // namespace
 
 
@@ -301,4 +505,9 @@ void testPriorityQueue()
    testPriorityQueuePop();
    testPriorityQueueTop();
    testPriorityQueueInsert();
+   testPriorityQueueInsertRvalue();
+   testPriorityQueueEmplace();
+   testPriorityQueueInsertRange();
+   testPriorityQueueCopyAndMove();
+   testPriorityQueueArity();
 }
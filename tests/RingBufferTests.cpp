@@ -1,7 +1,14 @@
 #include "RingBuffer.h"
 #include "TestUtil.h"
+#include <algorithm>
+#include <array>
 #include <iostream>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
 #include <string>
+#include <utility>
+#include <vector>
 
 using namespace ds;
 
@@ -11,6 +18,21 @@ using namespace ds;
 namespace
 {
 
+// Element type without default ctor that counts its live instances.
+struct Counted
+{
+   explicit Counted(int v) : val{v} { ++numAlive; }
+   Counted(const Counted& other) : val{other.val} { ++numAlive; }
+   Counted(Counted&& other) noexcept : val{other.val} { ++numAlive; }
+   ~Counted() { --numAlive; }
+   Counted& operator=(const Counted&) = default;
+   Counted& operator=(Counted&&) noexcept = default;
+
+   int val = 0;
+   inline static int numAlive = 0;
+};
+
+
 void testRingBufferDefaultCtor()
 {
    {
@@ -386,6 +408,47 @@ void testRingBufferPush()
       VERIFY(rb[0] == 3, caseLabel);
       VERIFY(rb[2] == 5, caseLabel);
    }
+   {
+      const std::string caseLabel{"RingBuffer::push() for rvalue"};
+      RingBuffer<std::string, 3> rb;
+      std::string val(100, 'a');
+      rb.push(std::move(val));
+      VERIFY(rb.size() == 1, caseLabel);
+      VERIFY(rb[0] == std::string(100, 'a'), caseLabel);
+      VERIFY(val.empty(), caseLabel);
+   }
+   {
+      const std::string caseLabel{"RingBuffer::push() for move-only type"};
+      RingBuffer<std::unique_ptr<int>, 2> rb;
+      rb.push(std::make_unique<int>(1));
+      rb.push(std::make_unique<int>(2));
+      rb.push(std::make_unique<int>(3));
+      VERIFY(rb.size() == 2, caseLabel);
+      VERIFY(*rb[0] == 2 && *rb[1] == 3, caseLabel);
+   }
+}
+
+
+void testRingBufferEmplace()
+{
+   {
+      const std::string caseLabel{"RingBuffer::emplace()"};
+      RingBuffer<std::string, 3> rb;
+      std::string& added = rb.emplace(5, 'x');
+      VERIFY(rb.size() == 1, caseLabel);
+      VERIFY(rb[0] == "xxxxx", caseLabel);
+      VERIFY(&added == &rb[0], caseLabel);
+   }
+   {
+      const std::string caseLabel{"RingBuffer::emplace() for full buffer"};
+      RingBuffer<std::pair<int, std::string>, 2> rb;
+      rb.emplace(1, "a");
+      rb.emplace(2, "b");
+      auto& added = rb.emplace(3, "c");
+      VERIFY(rb.size() == 2, caseLabel);
+      VERIFY(rb[0].first == 2, caseLabel);
+      VERIFY(added.first == 3 && added.second == "c", caseLabel);
+   }
 }
 
 
@@ -426,6 +489,63 @@ void testRingBufferPop()
       VERIFY(val == 4, caseLabel);
       VERIFY(rb.size() == 2, caseLabel);
    }
+   {
+      const std::string caseLabel{"RingBuffer::pop() for move-only type"};
+      RingBuffer<std::unique_ptr<int>, 3> rb;
+      rb.push(std::make_unique<int>(1));
+      rb.push(std::make_unique<int>(2));
+      std::unique_ptr<int> val = rb.pop();
+      VERIFY(val && *val == 2, caseLabel);
+      VERIFY(rb.size() == 1, caseLabel);
+   }
+}
+
+
+void testRingBufferPopFront()
+{
+   {
+      const std::string caseLabel{"RingBuffer::pop_front()"};
+      RingBuffer<int, 10> rb{1, 2, 3};
+      VERIFY(rb.pop_front() == 1, caseLabel);
+      VERIFY(rb.size() == 2, caseLabel);
+      VERIFY(rb[0] == 2, caseLabel);
+   }
+   {
+      const std::string caseLabel{"RingBuffer::pop_front() for empty buffer"};
+      RingBuffer<int, 10> rb;
+      VERIFY_THROW([&rb]() { rb.pop_front(); }, std::runtime_error, caseLabel);
+   }
+   {
+      const std::string caseLabel{"RingBuffer::pop_front() for wrapped buffer"};
+      RingBuffer<int, 3> rb{1, 2, 3, 4, 5};
+      VERIFY(rb.pop_front() == 3, caseLabel);
+      VERIFY(rb.pop_front() == 4, caseLabel);
+      VERIFY(rb.pop_front() == 5, caseLabel);
+      VERIFY(rb.empty(), caseLabel);
+   }
+   {
+      const std::string caseLabel{"RingBuffer::pop_front() as FIFO queue"};
+      RingBuffer<std::string, 4> rb;
+      bool ok = true;
+      for (int i = 0; i < 20; ++i)
+      {
+         rb.push(std::to_string(i));
+         rb.push(std::to_string(i + 100));
+         ok = ok && rb.pop_front() == std::to_string(i);
+         ok = ok && rb.pop_front() == std::to_string(i + 100);
+      }
+      VERIFY(ok, caseLabel);
+      VERIFY(rb.empty(), caseLabel);
+   }
+   {
+      const std::string caseLabel{"RingBuffer::pop_front() for move-only type"};
+      RingBuffer<std::unique_ptr<int>, 3> rb;
+      rb.push(std::make_unique<int>(1));
+      rb.push(std::make_unique<int>(2));
+      std::unique_ptr<int> val = rb.pop_front();
+      VERIFY(val && *val == 1, caseLabel);
+      VERIFY(rb.size() == 1, caseLabel);
+   }
 }
 
 
@@ -493,6 +613,444 @@ void testRingBufferSwap()
 }
 
 
+void testRingBufferPowerOfTwoCapacity()
+{
+   {
+      const std::string caseLabel{"RingBuffer with power of two capacity when wrapping"};
+      RingBuffer<int, 8> rb;
+      for (int i = 0; i < 21; ++i)
+         rb.push(i);
+      VERIFY(rb.size() == 8, caseLabel);
+      VERIFY(rb.full(), caseLabel);
+      VERIFY(rb[0] == 13, caseLabel);
+      VERIFY(rb[7] == 20, caseLabel);
+      VERIFY(rb.pop() == 20, caseLabel);
+      VERIFY(rb.size() == 7, caseLabel);
+   }
+   {
+      const std::string caseLabel{"RingBuffer with power of two capacity for N=1"};
+      RingBuffer<int, 1> rb;
+      rb.push(1);
+      rb.push(2);
+      VERIFY(rb.size() == 1, caseLabel);
+      VERIFY(rb[0] == 2, caseLabel);
+   }
+   {
+      const std::string caseLabel{
+         "RingBuffer iterator ctor matches pushing for power of two capacity"};
+      std::vector<int> seq;
+      for (int i = 0; i < 13; ++i)
+         seq.push_back(i);
+
+      RingBuffer<int, 4> pushed;
+      for (int val : seq)
+         pushed.push(val);
+      const RingBuffer<int, 4> constructed{seq.begin(), seq.end()};
+
+      VERIFY(constructed.size() == pushed.size(), caseLabel);
+      VERIFY(std::equal(constructed.begin(), constructed.end(), pushed.begin()),
+             caseLabel);
+   }
+   {
+      const std::string caseLabel{"RingBuffer pushing after popping to empty"};
+      RingBuffer<int, 4> rb{1, 2, 3, 4, 5, 6};
+      while (!rb.empty())
+         rb.pop();
+      rb.push(7);
+      rb.push(8);
+      VERIFY(rb.size() == 2, caseLabel);
+      VERIFY(rb[0] == 7 && rb[1] == 8, caseLabel);
+   }
+}
+
+
+void testRingBufferElementLifetime()
+{
+   {
+      const std::string caseLabel{"RingBuffer does not construct unused slots"};
+      Counted::numAlive = 0;
+      {
+         RingBuffer<Counted, 100> rb;
+         VERIFY(Counted::numAlive == 0, caseLabel);
+         rb.emplace(1);
+         rb.push(Counted{2});
+         VERIFY(Counted::numAlive == 2, caseLabel);
+      }
+      VERIFY(Counted::numAlive == 0, caseLabel);
+   }
+   {
+      const std::string caseLabel{"RingBuffer destroys overwritten and removed elements"};
+      Counted::numAlive = 0;
+      {
+         RingBuffer<Counted, 3> rb;
+         for (int i = 0; i < 10; ++i)
+            rb.emplace(i);
+         VERIFY(Counted::numAlive == 3, caseLabel);
+         VERIFY(rb[0].val == 7, caseLabel);
+
+         rb.pop();
+         rb.pop_front();
+         VERIFY(Counted::numAlive == 1, caseLabel);
+         VERIFY(rb[0].val == 8, caseLabel);
+
+         rb.clear();
+         VERIFY(Counted::numAlive == 0, caseLabel);
+      }
+      VERIFY(Counted::numAlive == 0, caseLabel);
+   }
+   {
+      const std::string caseLabel{"RingBuffer bulk operations construct and destroy"};
+      Counted::numAlive = 0;
+      {
+         const std::vector<Counted> vals{Counted{1}, Counted{2}, Counted{3}, Counted{4},
+                                         Counted{5}};
+         RingBuffer<Counted, 4> rb;
+         rb.push_n(vals.begin(), vals.size());
+         VERIFY(Counted::numAlive == 5 + 4, caseLabel);
+         VERIFY(rb[0].val == 2 && rb[3].val == 5, caseLabel);
+
+         std::vector<Counted> popped;
+         rb.pop_n(std::back_inserter(popped), 2);
+         rb.consume(1);
+         VERIFY(Counted::numAlive == 5 + 2 + 1, caseLabel);
+         VERIFY(rb[0].val == 3, caseLabel);
+      }
+      VERIFY(Counted::numAlive == 0, caseLabel);
+   }
+   {
+      const std::string caseLabel{"RingBuffer copies and moves construct elements"};
+      Counted::numAlive = 0;
+      {
+         RingBuffer<Counted, 3> rb;
+         for (int i = 0; i < 5; ++i)
+            rb.emplace(i);
+
+         RingBuffer<Counted, 3> copy{rb};
+         VERIFY(Counted::numAlive == 6, caseLabel);
+         VERIFY(copy[0].val == 2 && copy[2].val == 4, caseLabel);
+
+         RingBuffer<Counted, 3> moved{std::move(rb)};
+         VERIFY(Counted::numAlive == 6, caseLabel);
+         VERIFY(moved[0].val == 2 && moved[2].val == 4, caseLabel);
+
+         copy = moved;
+         moved.swap(rb);
+         VERIFY(Counted::numAlive == 6, caseLabel);
+         VERIFY(rb[0].val == 2 && moved.empty(), caseLabel);
+      }
+      VERIFY(Counted::numAlive == 0, caseLabel);
+   }
+   {
+      const std::string caseLabel{"RingBuffer::push() of oldest element into full buffer"};
+      RingBuffer<std::string, 2> rb{"a", "b"};
+      rb.push(rb[0]);
+      rb.emplace(rb[0]);
+      VERIFY(rb[0] == "a" && rb[1] == "b", caseLabel);
+   }
+}
+
+
+void testRingBufferPushN()
+{
+   {
+      const std::string caseLabel{"RingBuffer::push_n() into empty buffer"};
+      RingBuffer<int, 5> rb;
+      const std::vector<int> vals{1, 2, 3};
+      rb.push_n(vals.begin(), vals.size());
+      VERIFY(rb.size() == 3, caseLabel);
+      VERIFY(rb[0] == 1 && rb[2] == 3, caseLabel);
+   }
+   {
+      const std::string caseLabel{"RingBuffer::push_n() wrapping around"};
+      RingBuffer<int, 5> rb{1, 2, 3, 4};
+      const std::vector<int> vals{5, 6, 7};
+      rb.push_n(vals.begin(), vals.size());
+      VERIFY(rb.size() == 5, caseLabel);
+      VERIFY(std::equal(rb.begin(), rb.end(), std::vector<int>{3, 4, 5, 6, 7}.begin()),
+             caseLabel);
+   }
+   {
+      const std::string caseLabel{"RingBuffer::push_n() for more elements than capacity"};
+      RingBuffer<int, 3> rb{1};
+      const std::vector<int> vals{2, 3, 4, 5, 6};
+      rb.push_n(vals.begin(), vals.size());
+
+      RingBuffer<int, 3> pushed{1};
+      for (int val : vals)
+         pushed.push(val);
+
+      VERIFY(rb.size() == 3, caseLabel);
+      VERIFY(std::equal(rb.begin(), rb.end(), pushed.begin()), caseLabel);
+   }
+   {
+      const std::string caseLabel{"RingBuffer::push_n() for no elements"};
+      RingBuffer<int, 3> rb{1, 2};
+      const std::vector<int> vals;
+      rb.push_n(vals.begin(), 0);
+      VERIFY(rb.size() == 2, caseLabel);
+   }
+   {
+      const std::string caseLabel{"RingBuffer::push_n() for N=0"};
+      RingBuffer<int, 0> rb;
+      const std::vector<int> vals{1, 2};
+      rb.push_n(vals.begin(), vals.size());
+      VERIFY(rb.empty(), caseLabel);
+   }
+}
+
+
+void testRingBufferPopN()
+{
+   {
+      const std::string caseLabel{"RingBuffer::pop_n() for fewer than stored elements"};
+      RingBuffer<int, 5> rb{1, 2, 3, 4};
+      std::vector<int> popped;
+      VERIFY(rb.pop_n(std::back_inserter(popped), 3) == 3, caseLabel);
+      // Same order as popping individually.
+      VERIFY(popped == std::vector<int>({4, 3, 2}), caseLabel);
+      VERIFY(rb.size() == 1, caseLabel);
+      VERIFY(rb[0] == 1, caseLabel);
+   }
+   {
+      const std::string caseLabel{"RingBuffer::pop_n() for wrapped buffer"};
+      RingBuffer<int, 4> rb{1, 2, 3, 4, 5, 6};
+      std::vector<int> popped;
+      VERIFY(rb.pop_n(std::back_inserter(popped), 10) == 4, caseLabel);
+      VERIFY(popped == std::vector<int>({6, 5, 4, 3}), caseLabel);
+      VERIFY(rb.empty(), caseLabel);
+   }
+   {
+      const std::string caseLabel{"RingBuffer::pop_n() from empty buffer"};
+      RingBuffer<int, 4> rb;
+      std::vector<int> popped;
+      VERIFY(rb.pop_n(std::back_inserter(popped), 2) == 0, caseLabel);
+      VERIFY(popped.empty(), caseLabel);
+   }
+}
+
+
+void testRingBufferWrite()
+{
+   {
+      const std::string caseLabel{"RingBuffer::write()"};
+      RingBuffer<int, 4> rb{1, 2, 3};
+      const std::array<int, 3> vals{4, 5, 6};
+      rb.write(vals);
+      VERIFY(rb.size() == 4, caseLabel);
+      VERIFY(std::equal(rb.begin(), rb.end(), std::vector<int>{3, 4, 5, 6}.begin()),
+             caseLabel);
+   }
+}
+
+
+void testRingBufferRead()
+{
+   {
+      const std::string caseLabel{"RingBuffer::read() for fewer than stored elements"};
+      RingBuffer<int, 5> rb{1, 2, 3, 4};
+      std::array<int, 3> dest{};
+      VERIFY(rb.read(dest) == 3, caseLabel);
+      VERIFY(dest == (std::array<int, 3>{1, 2, 3}), caseLabel);
+      VERIFY(rb.size() == 1, caseLabel);
+      VERIFY(rb[0] == 4, caseLabel);
+   }
+   {
+      const std::string caseLabel{"RingBuffer::read() for wrapped buffer"};
+      RingBuffer<int, 4> rb{1, 2, 3, 4, 5, 6};
+      std::vector<int> dest(10);
+      VERIFY(rb.read(dest) == 4, caseLabel);
+      VERIFY(std::equal(dest.begin(), dest.begin() + 4,
+                        std::vector<int>{3, 4, 5, 6}.begin()),
+             caseLabel);
+      VERIFY(rb.empty(), caseLabel);
+   }
+   {
+      const std::string caseLabel{"RingBuffer::read() and write() as stream"};
+      RingBuffer<int, 4> rb;
+      bool ok = true;
+      for (int i = 0; i < 10; ++i)
+      {
+         const std::array<int, 3> vals{i, i + 1, i + 2};
+         rb.write(vals);
+         std::array<int, 3> dest{};
+         ok = ok && rb.read(dest) == 3 && dest == vals;
+      }
+      VERIFY(ok, caseLabel);
+   }
+}
+
+
+void testRingBufferReadableSpans()
+{
+   {
+      const std::string caseLabel{"RingBuffer::readable_spans() for unwrapped elements"};
+      RingBuffer<int, 5> rb{1, 2, 3};
+      const auto spans = rb.readable_spans();
+      VERIFY(spans.size() == 3, caseLabel);
+      VERIFY(spans.first.size() == 3, caseLabel);
+      VERIFY(spans.second.empty(), caseLabel);
+      VERIFY(spans.first[0] == 1 && spans.first[2] == 3, caseLabel);
+   }
+   {
+      const std::string caseLabel{"RingBuffer::readable_spans() for wrapped elements"};
+      RingBuffer<int, 4> rb{1, 2, 3, 4, 5, 6};
+      const auto spans = rb.readable_spans();
+      VERIFY(spans.size() == 4, caseLabel);
+      VERIFY(spans.first.size() == 2, caseLabel);
+      VERIFY(spans.first[0] == 3 && spans.first[1] == 4, caseLabel);
+      VERIFY(spans.second.size() == 2, caseLabel);
+      VERIFY(spans.second[0] == 5 && spans.second[1] == 6, caseLabel);
+   }
+   {
+      const std::string caseLabel{"RingBuffer::readable_spans() for const buffer"};
+      const RingBuffer<int, 4> rb{1, 2};
+      RingBufferSpans<const int> spans = rb.readable_spans();
+      VERIFY(spans.size() == 2, caseLabel);
+   }
+   {
+      const std::string caseLabel{"RingBuffer::readable_spans() for empty buffer"};
+      RingBuffer<int, 4> rb;
+      VERIFY(rb.readable_spans().empty(), caseLabel);
+   }
+   {
+      const std::string caseLabel{"RingBuffer::readable_spans() allow changing elements"};
+      RingBuffer<int, 4> rb{1, 2, 3, 4, 5};
+      auto spans = rb.readable_spans();
+      spans.first[0] = 10;
+      spans.second[0] = 50;
+      VERIFY(rb[0] == 10, caseLabel);
+      VERIFY(rb[3] == 50, caseLabel);
+   }
+}
+
+
+void testRingBufferWritableSpans()
+{
+   {
+      const std::string caseLabel{"RingBuffer::writable_spans() for empty buffer"};
+      RingBuffer<int, 4> rb;
+      const auto spans = rb.writable_spans();
+      VERIFY(spans.size() == 4, caseLabel);
+      VERIFY(spans.first.size() == 4, caseLabel);
+   }
+   {
+      const std::string caseLabel{"RingBuffer::writable_spans() for wrapping free slots"};
+      RingBuffer<int, 4> rb{1, 2, 3};
+      rb.consume(2);
+      const auto spans = rb.writable_spans();
+      VERIFY(spans.size() == 3, caseLabel);
+      VERIFY(spans.first.size() == 1, caseLabel);
+      VERIFY(spans.second.size() == 2, caseLabel);
+   }
+   {
+      const std::string caseLabel{"RingBuffer::writable_spans() for full buffer"};
+      RingBuffer<int, 4> rb{1, 2, 3, 4};
+      VERIFY(rb.writable_spans().empty(), caseLabel);
+   }
+}
+
+
+void testRingBufferCommit()
+{
+   {
+      const std::string caseLabel{"RingBuffer::commit() after writing into spans"};
+      RingBuffer<int, 4> rb{1, 2, 3};
+      rb.consume(2);
+
+      auto spans = rb.writable_spans();
+      spans.first[0] = 4;
+      spans.second[0] = 5;
+      rb.commit(2);
+
+      VERIFY(rb.size() == 3, caseLabel);
+      VERIFY(std::equal(rb.begin(), rb.end(), std::vector<int>{3, 4, 5}.begin()),
+             caseLabel);
+   }
+   {
+      const std::string caseLabel{"RingBuffer::commit() for too many elements"};
+      RingBuffer<int, 4> rb{1, 2, 3};
+      VERIFY_THROW([&rb]() { rb.commit(2); }, std::out_of_range, caseLabel);
+      VERIFY(rb.size() == 3, caseLabel);
+   }
+}
+
+
+void testRingBufferConsume()
+{
+   {
+      const std::string caseLabel{"RingBuffer::consume()"};
+      RingBuffer<int, 4> rb{1, 2, 3};
+      rb.consume(2);
+      VERIFY(rb.size() == 1, caseLabel);
+      VERIFY(rb[0] == 3, caseLabel);
+   }
+   {
+      const std::string caseLabel{"RingBuffer::consume() for too many elements"};
+      RingBuffer<int, 4> rb{1, 2, 3};
+      VERIFY_THROW([&rb]() { rb.consume(4); }, std::out_of_range, caseLabel);
+      VERIFY(rb.size() == 3, caseLabel);
+   }
+}
+
+
+void testRingBufferOverflowPolicy()
+{
+   {
+      const std::string caseLabel{"RingBuffer counts overwritten elements"};
+      RingBuffer<int, 3> rb{1, 2, 3};
+      VERIFY(rb.push(4), caseLabel);
+      rb.emplace(5);
+      VERIFY(rb.num_overwritten() == 2, caseLabel);
+      VERIFY(rb.num_dropped() == 0, caseLabel);
+
+      const std::vector<int> vals{6, 7, 8, 9, 10};
+      VERIFY(rb.write(vals) == 5, caseLabel);
+      VERIFY(rb.num_overwritten() == 7, caseLabel);
+      VERIFY(rb[0] == 8 && rb[2] == 10, caseLabel);
+
+      rb.reset_counters();
+      VERIFY(rb.num_overwritten() == 0, caseLabel);
+   }
+   {
+      const std::string caseLabel{"RingBuffer with reject policy"};
+      RingBuffer<int, 3, OverflowPolicy::Reject> rb{1, 2};
+      VERIFY(rb.push(3), caseLabel);
+      VERIFY(!rb.push(4), caseLabel);
+      VERIFY(rb[0] == 1 && rb[2] == 3, caseLabel);
+      VERIFY_THROW([&rb]() { rb.emplace(5); }, std::runtime_error, caseLabel);
+      VERIFY(rb.num_dropped() == 2, caseLabel);
+      VERIFY(rb.num_overwritten() == 0, caseLabel);
+   }
+   {
+      const std::string caseLabel{"RingBuffer::push_n() with reject policy"};
+      RingBuffer<int, 4, OverflowPolicy::Reject> rb{1};
+      const std::vector<int> vals{2, 3, 4, 5, 6};
+      VERIFY(rb.push_n(vals.begin(), vals.size()) == 3, caseLabel);
+      VERIFY(rb[0] == 1 && rb[3] == 4, caseLabel);
+      VERIFY(rb.num_dropped() == 2, caseLabel);
+
+      rb.pop_front();
+      VERIFY(rb.write(vals) == 1, caseLabel);
+      VERIFY(rb[3] == 2, caseLabel);
+      VERIFY(rb.num_dropped() == 6, caseLabel);
+   }
+   {
+      const std::string caseLabel{"RingBuffer with zero capacity drops elements"};
+      RingBuffer<int, 0> rb;
+      VERIFY(!rb.push(1), caseLabel);
+      const std::vector<int> vals{2, 3};
+      VERIFY(rb.write(vals) == 0, caseLabel);
+      VERIFY(rb.num_dropped() == 3, caseLabel);
+   }
+   {
+      const std::string caseLabel{"RingBuffer copies counters"};
+      RingBuffer<int, 2> rb{1, 2, 3};
+      RingBuffer<int, 2> copy{rb};
+      VERIFY(copy.num_overwritten() == 1, caseLabel);
+   }
+}
+
+
 void testRingBufferBegin()
 {
    {
@@ -3469,9 +4027,22 @@ void testRingBuffer()
    testRingBufferIndexOperator();
    testRingBufferIndexOperatorConst();
    testRingBufferPush();
+   testRingBufferEmplace();
    testRingBufferPop();
+   testRingBufferPopFront();
    testRingBufferClear();
    testRingBufferSwap();
+   testRingBufferPowerOfTwoCapacity();
+   testRingBufferElementLifetime();
+   testRingBufferPushN();
+   testRingBufferPopN();
+   testRingBufferWrite();
+   testRingBufferRead();
+   testRingBufferReadableSpans();
+   testRingBufferWritableSpans();
+   testRingBufferCommit();
+   testRingBufferConsume();
+   testRingBufferOverflowPolicy();
    testRingBufferBegin();
    testRingBufferEnd();
    testRingBufferBeginConst();
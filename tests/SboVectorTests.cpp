@@ -1,14 +1,25 @@
 #include "SboVectorTests.h"
-// Turn on memory instrumentation for SboVector.
-#define SBOVEC_MEM_INSTR
 #include "SboVector.h"
 #include "TestUtil.h"
 #include <algorithm>
+#include <array>
 #include <functional>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
 #include <list>
+#include <memory_resource>
+#include <ranges>
 #include <string>
+#include <thread>
 #include <vector>
 
+// The tests verify allocations through the memory instrumentation. It changes the
+// layout of SboVector, so it is turned on for the whole test program, but only in
+// Debug configs to keep the performance tests of Release configs realistic.
+#ifdef SBOVEC_MEM_INSTR
+
 using namespace ds;
 
 
@@ -120,6 +131,25 @@ struct Element
 
 ///////////////////
 
+// Used as element type for testing the SboVector class.
+// Shares the instrumentation of Element but is marked as trivially relocatable.
+struct RelocatableElement : public Element
+{
+   using Element::Element;
+};
+
+} // namespace
+
+
+template <> struct ds::IsTriviallyRelocatable<RelocatableElement> : std::true_type
+{
+};
+
+
+namespace
+{
+///////////////////
+
 // Used as element type for testing the SboVector class.
 // Ctors and dtor are instrumented with call counters.
 // Does not support move semantics.
@@ -270,6 +300,38 @@ ForwardIter makeForwardIter(std::size_t pos)
 }
 
 
+///////////////////
+
+// Memory resource that counts the allocations made through it.
+class CountingResource : public std::pmr::memory_resource
+{
+ public:
+   std::size_t numAllocs = 0;
+   std::size_t numDeallocs = 0;
+   std::size_t numAllocatedBytes = 0;
+
+ private:
+   void* do_allocate(std::size_t bytes, std::size_t alignment) override
+   {
+      ++numAllocs;
+      numAllocatedBytes += bytes;
+      return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+   }
+
+   void do_deallocate(void* p, std::size_t bytes, std::size_t alignment) override
+   {
+      ++numDeallocs;
+      numAllocatedBytes -= bytes;
+      std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+   }
+
+   bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override
+   {
+      return this == &other;
+   }
+};
+
+
 ///////////////////
 
 // RAII class to verify the instrumentation metrics of a given element type.
@@ -6339,6 +6401,143 @@ void testInsertInitializerList()
 }
 
 
+void testContiguousSourceCopy()
+{
+   {
+      const std::string caseLabel{"SboVector detection of contiguous iterators"};
+
+      using SV = SboVector<int, 4>;
+
+      static_assert(IsContiguousIterator_v<int*>);
+      static_assert(IsContiguousIterator_v<const int*>);
+      static_assert(IsContiguousIterator_v<std::vector<int>::iterator>);
+      static_assert(IsContiguousIterator_v<std::array<int, 3>::const_iterator>);
+      static_assert(IsContiguousIterator_v<SV::iterator>);
+      static_assert(IsContiguousIterator_v<SV::const_iterator>);
+      static_assert(!IsContiguousIterator_v<std::list<int>::iterator>);
+      static_assert(!IsContiguousIterator_v<SV::reverse_iterator>);
+   }
+   {
+      const std::string caseLabel{"SboVector assignment from contiguous sources"};
+
+      using SV = SboVector<int, 4>;
+
+      SV sv;
+      const std::vector<int> vec{1, 2, 3, 4, 5};
+      sv.assign(vec.begin(), vec.end());
+      verifyVector(sv, {1, 2, 3, 4, 5}, caseLabel);
+
+      const std::array<int, 3> arr{6, 7, 8};
+      sv.assign(arr.begin(), arr.end());
+      verifyVector(sv, {6, 7, 8}, caseLabel);
+
+      const SV other{9, 10, 11, 12, 13, 14};
+      sv = other;
+      verifyVector(sv, {9, 10, 11, 12, 13, 14}, caseLabel);
+
+      const int* raw = vec.data();
+      sv.assign(raw + 1, raw + 3);
+      verifyVector(sv, {2, 3}, caseLabel);
+   }
+   {
+      const std::string caseLabel{"SboVector assignment from own elements"};
+
+      using SV = SboVector<int, 8>;
+
+      // The source range overlaps the destination within the same storage.
+      SV sv{1, 2, 3, 4, 5, 6};
+      sv.assign(sv.cbegin() + 2, sv.cend());
+      verifyVector(sv, {3, 4, 5, 6}, caseLabel);
+   }
+   {
+      const std::string caseLabel{"SboVector insertion from contiguous sources"};
+
+      using SV = SboVector<int, 4>;
+
+      SV sv{1, 6};
+      const std::vector<int> vec{2, 3};
+      sv.insert(sv.begin() + 1, vec.begin(), vec.end());
+      verifyVector(sv, {1, 2, 3, 6}, caseLabel);
+      VERIFY(sv.inBuffer(), caseLabel);
+
+      const std::array<int, 2> arr{4, 5};
+      sv.insert(sv.begin() + 3, arr.begin(), arr.end());
+      verifyVector(sv, {1, 2, 3, 4, 5, 6}, caseLabel);
+      VERIFY(sv.onHeap(), caseLabel);
+   }
+   {
+      const std::string caseLabel{"SboVector insertion from non-contiguous source"};
+
+      using SV = SboVector<int, 4>;
+
+      SV sv{1, 4};
+      const std::list<int> lst{2, 3};
+      sv.insert(sv.begin() + 1, lst.begin(), lst.end());
+      verifyVector(sv, {1, 2, 3, 4}, caseLabel);
+   }
+}
+
+
+void testAppendRange()
+{
+   {
+      const std::string caseLabel{"SboVector::append_range within buffer"};
+
+      using SV = SboVector<int, 8>;
+
+      SV sv{1, 2};
+      sv.append_range(std::vector<int>{3, 4});
+
+      VERIFY(sv.inBuffer(), caseLabel);
+      verifyVector(sv, {1, 2, 3, 4}, caseLabel);
+   }
+   {
+      const std::string caseLabel{"SboVector::append_range onto heap"};
+
+      using SV = SboVector<int, 4>;
+
+      SV sv{1, 2, 3};
+      const std::array<int, 3> arr{4, 5, 6};
+      sv.append_range(arr);
+
+      VERIFY(sv.onHeap(), caseLabel);
+      verifyVector(sv, {1, 2, 3, 4, 5, 6}, caseLabel);
+   }
+   {
+      const std::string caseLabel{"SboVector::append_range of other SboVector"};
+
+      using SV = SboVector<std::string, 2>;
+
+      SV sv{"a"};
+      const SV other{"b", "c"};
+      sv.append_range(other);
+
+      verifyVector(sv, {"a", "b", "c"}, caseLabel);
+   }
+   {
+      const std::string caseLabel{"SboVector::append_range of non-contiguous range"};
+
+      using SV = SboVector<int, 4>;
+
+      SV sv{1};
+      sv.append_range(std::list<int>{2, 3});
+      sv.append_range(std::views::iota(4, 7));
+
+      verifyVector(sv, {1, 2, 3, 4, 5, 6}, caseLabel);
+   }
+   {
+      const std::string caseLabel{"SboVector::append_range of empty range"};
+
+      using SV = SboVector<int, 4>;
+
+      SV sv{1};
+      sv.append_range(std::vector<int>{});
+
+      verifyVector(sv, {1}, caseLabel);
+   }
+}
+
+
 void testPushBackLValue()
 {
    {
@@ -8340,6 +8539,152 @@ void testResizeWithValue()
 }
 
 
+void testResizeDefaultInit()
+{
+   {
+      const std::string caseLabel{"SboVector::resize_default_init within buffer"};
+
+      using SV = SboVector<std::uint8_t, 16>;
+
+      SV sv{1, 2};
+      sv.resize_default_init(10);
+
+      VERIFY(sv.size() == 10, caseLabel);
+      VERIFY(sv.inBuffer(), caseLabel);
+      VERIFY(sv[0] == 1 && sv[1] == 2, caseLabel);
+   }
+   {
+      const std::string caseLabel{"SboVector::resize_default_init onto heap"};
+
+      using SV = SboVector<int, 4>;
+
+      SV sv{1, 2, 3};
+      sv.resize_default_init(20);
+      for (int i = 3; i < 20; ++i)
+         sv[i] = i + 1;
+
+      VERIFY(sv.size() == 20, caseLabel);
+      VERIFY(sv.onHeap(), caseLabel);
+      VERIFY(sv[2] == 3 && sv[19] == 20, caseLabel);
+   }
+   {
+      const std::string caseLabel{"SboVector::resize_default_init to smaller size"};
+
+      using SV = SboVector<int, 4>;
+
+      SV sv{1, 2, 3, 4, 5, 6};
+      sv.resize_default_init(2);
+
+      verifyVector(sv, {1, 2}, caseLabel);
+   }
+}
+
+
+void testAppendWith()
+{
+   {
+      const std::string caseLabel{"SboVector::append_with writing all elements"};
+
+      using SV = SboVector<std::uint8_t, 8>;
+
+      SV sv{1, 2};
+      const std::size_t numAppended = sv.append_with(
+         3, [](std::uint8_t* dest, std::size_t n)
+         { std::fill_n(dest, n, static_cast<std::uint8_t>(9)); });
+
+      VERIFY(numAppended == 3, caseLabel);
+      verifyVector(sv, {1, 2, 9, 9, 9}, caseLabel);
+   }
+   {
+      const std::string caseLabel{"SboVector::append_with writing fewer elements"};
+
+      using SV = SboVector<std::uint8_t, 8>;
+
+      // Simulates reading from a source that has less data than requested.
+      const std::array<std::uint8_t, 3> source{7, 8, 9};
+      auto read = [&source](std::uint8_t* dest, std::size_t n)
+      {
+         const std::size_t numRead = std::min(n, source.size());
+         std::memcpy(dest, source.data(), numRead);
+         return numRead;
+      };
+
+      SV sv{1};
+      const std::size_t numAppended = sv.append_with(6, read);
+
+      VERIFY(numAppended == 3, caseLabel);
+      VERIFY(sv.inBuffer(), caseLabel);
+      verifyVector(sv, {1, 7, 8, 9}, caseLabel);
+   }
+   {
+      const std::string caseLabel{"SboVector::append_with onto heap"};
+
+      using SV = SboVector<int, 4>;
+
+      SV sv{1, 2, 3};
+      sv.append_with(3,
+                     [](int* dest, std::size_t n)
+                     {
+                        for (std::size_t i = 0; i < n; ++i)
+                           dest[i] = static_cast<int>(i) + 4;
+                        return n;
+                     });
+
+      VERIFY(sv.onHeap(), caseLabel);
+      // Capacity grows according to the growth policy.
+      VERIFY(sv.capacity() == 8, caseLabel);
+      verifyVector(sv, {1, 2, 3, 4, 5, 6}, caseLabel);
+   }
+   {
+      const std::string caseLabel{"SboVector::append_with function that throws"};
+
+      using SV = SboVector<int, 4>;
+
+      SV sv{1, 2};
+      VERIFY_THROW(
+         [&sv]()
+         { sv.append_with(2, [](int*, std::size_t) -> std::size_t { throw 1; }); },
+         int, caseLabel);
+
+      // Vector is unchanged.
+      verifyVector(sv, {1, 2}, caseLabel);
+   }
+   {
+      const std::string caseLabel{"SboVector::append_with function reporting an error"};
+
+      using SV = SboVector<char, 16>;
+
+      // Simulates a read() call that fails.
+      SV sv{'a'};
+      const std::size_t numAppended =
+         sv.append_with(64, [](char*, std::size_t) -> std::ptrdiff_t { return -1; });
+
+      VERIFY(numAppended == 0, caseLabel);
+      verifyVector(sv, {'a'}, caseLabel);
+   }
+#ifdef NDEBUG
+   {
+      // Debug builds assert on functions that report more elements than requested.
+      const std::string caseLabel{"SboVector::append_with function reporting too many"};
+
+      using SV = SboVector<int, 4>;
+
+      SV sv{1};
+      const std::size_t numAppended = sv.append_with(
+         2,
+         [](int* dest, std::size_t n)
+         {
+            std::fill_n(dest, n, 5);
+            return n + 3;
+         });
+
+      VERIFY(numAppended == 2, caseLabel);
+      verifyVector(sv, {1, 5, 5}, caseLabel);
+   }
+#endif // NDEBUG
+}
+
+
 void testSwap()
 {
    {
@@ -8886,6 +9231,473 @@ void testStandaloneSwap()
 }
 
 
+void testTriviallyRelocatableElements()
+{
+   {
+      const std::string caseLabel{
+         "SvoVector relocation of trivially relocatable elements when growing onto heap"};
+
+      constexpr std::size_t BufCap = 5;
+      using Elem = RelocatableElement;
+      using SV = SboVector<Elem, BufCap>;
+
+      const std::initializer_list<Elem> values{1, 2, 3, 4};
+      const std::size_t initialSize = values.size();
+      constexpr std::size_t reserveCap = 15;
+
+      // No move ctor calls because the elements get copied as raw memory.
+      Elem::Metrics metrics;
+      metrics.copyCtorCalls = initialSize;
+      metrics.dtorCalls = initialSize;
+
+      Test<Elem, BufCap> test{caseLabel, metrics};
+      test.run(
+         [&]()
+         {
+            VERIFY(IsTriviallyRelocatable_v<Elem>, caseLabel);
+            SV sv{values};
+            VERIFY(sv.inBuffer(), caseLabel);
+
+            sv.reserve(reserveCap);
+
+            VERIFY(sv.onHeap(), caseLabel);
+            VERIFY(sv.capacity() == reserveCap, caseLabel);
+            verifyVector(sv, values, caseLabel);
+         });
+   }
+   {
+      const std::string caseLabel{
+         "SvoVector relocation of trivially relocatable elements when shrinking into "
+         "buffer"};
+
+      constexpr std::size_t BufCap = 5;
+      using Elem = RelocatableElement;
+      using SV = SboVector<Elem, BufCap>;
+
+      const std::initializer_list<Elem> values{1, 2, 3};
+      const std::size_t initialSize = values.size();
+      constexpr std::size_t reserveCap = 15;
+
+      Elem::Metrics metrics;
+      metrics.copyCtorCalls = initialSize;
+      metrics.dtorCalls = initialSize;
+
+      Test<Elem, BufCap> test{caseLabel, metrics};
+      test.run(
+         [&]()
+         {
+            SV sv{values};
+            sv.reserve(reserveCap);
+            VERIFY(sv.onHeap(), caseLabel);
+
+            sv.shrink_to_fit();
+
+            VERIFY(sv.inBuffer(), caseLabel);
+            VERIFY(sv.capacity() == BufCap, caseLabel);
+            verifyVector(sv, values, caseLabel);
+         });
+   }
+   {
+      const std::string caseLabel{
+         "SvoVector relocation of trivially relocatable elements for insertion"};
+
+      constexpr std::size_t BufCap = 5;
+      using Elem = RelocatableElement;
+      using SV = SboVector<Elem, BufCap>;
+
+      const std::initializer_list<Elem> values{1, 2, 3, 4};
+      const std::size_t initialSize = values.size();
+      const std::initializer_list<Elem> inserted{10, 11, 12};
+      const std::size_t insertedSize = inserted.size();
+      const std::initializer_list<Elem> expected{1, 10, 11, 12, 2, 3, 4};
+
+      Elem::Metrics metrics;
+      metrics.copyCtorCalls = initialSize + insertedSize;
+      metrics.dtorCalls = initialSize + insertedSize;
+
+      Test<Elem, BufCap> test{caseLabel, metrics};
+      test.run(
+         [&]()
+         {
+            SV sv{values};
+            VERIFY(sv.inBuffer(), caseLabel);
+
+            sv.insert(sv.begin() + 1, inserted);
+
+            VERIFY(sv.onHeap(), caseLabel);
+            verifyVector(sv, expected, caseLabel);
+         });
+   }
+   {
+      const std::string caseLabel{
+         "SvoVector relocation of trivially relocatable elements for erasure"};
+
+      constexpr std::size_t BufCap = 5;
+      using Elem = RelocatableElement;
+      using SV = SboVector<Elem, BufCap>;
+
+      const std::initializer_list<Elem> values{1, 2, 3, 4, 5, 6, 7};
+      const std::size_t initialSize = values.size();
+      const std::initializer_list<Elem> expected{1, 5, 6, 7};
+
+      Elem::Metrics metrics;
+      metrics.copyCtorCalls = initialSize;
+      metrics.dtorCalls = initialSize;
+
+      Test<Elem, BufCap> test{caseLabel, metrics};
+      test.run(
+         [&]()
+         {
+            SV sv{values};
+
+            sv.erase(sv.begin() + 1, sv.begin() + 4);
+
+            verifyVector(sv, expected, caseLabel);
+         });
+   }
+   {
+      const std::string caseLabel{
+         "SvoVector swap of buffer instances with trivially relocatable elements"};
+
+      constexpr std::size_t BufCap = 5;
+      using Elem = RelocatableElement;
+      using SV = SboVector<Elem, BufCap>;
+
+      const std::initializer_list<Elem> valuesA{0, 1};
+      const std::size_t sizeA = valuesA.size();
+      const std::initializer_list<Elem> valuesB{100, 101, 102, 103};
+      const std::size_t sizeB = valuesB.size();
+
+      // No element swaps or moves.
+      Elem::Metrics metrics;
+      metrics.copyCtorCalls = sizeA + sizeB;
+      metrics.dtorCalls = sizeA + sizeB;
+
+      Test<Elem, BufCap> test{caseLabel, metrics};
+      test.run(
+         [&]()
+         {
+            SV svA{valuesA};
+            SV svB{valuesB};
+
+            svA.swap(svB);
+
+            VERIFY(svA.inBuffer(), caseLabel);
+            verifyVector(svA, valuesB, caseLabel);
+            VERIFY(svB.inBuffer(), caseLabel);
+            verifyVector(svB, valuesA, caseLabel);
+         });
+   }
+}
+
+
+void testAllocator()
+{
+   {
+      const std::string caseLabel{"SboVector with default allocator has no overhead"};
+
+      // The polymorphic allocator stores a pointer to its memory resource. The default
+      // allocator is empty and should not take up any space.
+      using SV = SboVector<int, 4>;
+      using PmrSV = ds::pmr::SboVector<int, 4>;
+      VERIFY(sizeof(SV) + sizeof(std::pmr::memory_resource*) == sizeof(PmrSV), caseLabel);
+   }
+   {
+      const std::string caseLabel{"pmr::SboVector in buffer does not allocate"};
+
+      CountingResource res;
+      {
+         ds::pmr::SboVector<int, 5> sv({1, 2, 3}, &res);
+         VERIFY(sv.inBuffer(), caseLabel);
+         VERIFY(sv.get_allocator().resource() == &res, caseLabel);
+      }
+      VERIFY(res.numAllocs == 0, caseLabel);
+   }
+   {
+      const std::string caseLabel{"pmr::SboVector on heap allocates from resource"};
+
+      CountingResource res;
+      {
+         ds::pmr::SboVector<int, 5> sv(&res);
+         for (int i = 0; i < 20; ++i)
+            sv.push_back(i);
+         VERIFY(sv.onHeap(), caseLabel);
+         VERIFY(sv.size() == 20, caseLabel);
+         VERIFY(sv[19] == 19, caseLabel);
+      }
+      VERIFY(res.numAllocs > 0, caseLabel);
+      VERIFY(res.numAllocs == res.numDeallocs, caseLabel);
+      VERIFY(res.numAllocatedBytes == 0, caseLabel);
+   }
+   {
+      const std::string caseLabel{"pmr::SboVector allocating from monotonic arena"};
+
+      alignas(std::max_align_t) std::byte arena[1024];
+      std::pmr::monotonic_buffer_resource res{arena, sizeof(arena),
+                                              std::pmr::null_memory_resource()};
+
+      ds::pmr::SboVector<int, 5> sv({1, 2, 3, 4, 5, 6, 7, 8, 9, 10}, &res);
+
+      VERIFY(sv.onHeap(), caseLabel);
+      const std::byte* data = reinterpret_cast<const std::byte*>(sv.data());
+      VERIFY(data >= arena && data + sv.size() * sizeof(int) <= arena + sizeof(arena),
+             caseLabel);
+      verifyVector(sv, {1, 2, 3, 4, 5, 6, 7, 8, 9, 10}, caseLabel);
+   }
+   {
+      const std::string caseLabel{"pmr::SboVector move ctor steals heap memory"};
+
+      CountingResource res;
+      {
+         ds::pmr::SboVector<int, 5> sv({1, 2, 3, 4, 5, 6, 7}, &res);
+         const int* heapData = sv.data();
+
+         ds::pmr::SboVector<int, 5> moved{std::move(sv)};
+
+         VERIFY(moved.data() == heapData, caseLabel);
+         VERIFY(moved.get_allocator().resource() == &res, caseLabel);
+         verifyVector(moved, {1, 2, 3, 4, 5, 6, 7}, caseLabel);
+      }
+      VERIFY(res.numAllocs == 1, caseLabel);
+      VERIFY(res.numDeallocs == 1, caseLabel);
+   }
+   {
+      const std::string caseLabel{
+         "pmr::SboVector move assignment with different memory resources"};
+
+      CountingResource resA;
+      CountingResource resB;
+      {
+         ds::pmr::SboVector<int, 5> a({1, 2, 3, 4, 5, 6, 7}, &resA);
+         ds::pmr::SboVector<int, 5> b(&resB);
+
+         b = std::move(a);
+
+         // Allocators of pmr vectors don't propagate, so the elements get moved into
+         // memory allocated from b's resource.
+         VERIFY(b.get_allocator().resource() == &resB, caseLabel);
+         VERIFY(b.onHeap(), caseLabel);
+         verifyVector(b, {1, 2, 3, 4, 5, 6, 7}, caseLabel);
+         VERIFY(resB.numAllocs == 1, caseLabel);
+      }
+      VERIFY(resA.numAllocatedBytes == 0, caseLabel);
+      VERIFY(resB.numAllocatedBytes == 0, caseLabel);
+   }
+   {
+      const std::string caseLabel{"pmr::SboVector copy ctor uses default resource"};
+
+      CountingResource res;
+      ds::pmr::SboVector<int, 5> sv({1, 2, 3}, &res);
+
+      ds::pmr::SboVector<int, 5> copy{sv};
+
+      VERIFY(copy.get_allocator().resource() == std::pmr::get_default_resource(),
+             caseLabel);
+      verifyVector(copy, {1, 2, 3}, caseLabel);
+   }
+   {
+      const std::string caseLabel{"pmr::SboVector swap with same memory resource"};
+
+      CountingResource res;
+      ds::pmr::SboVector<int, 5> a({1, 2, 3, 4, 5, 6, 7}, &res);
+      ds::pmr::SboVector<int, 5> b({10, 11}, &res);
+
+      a.swap(b);
+
+      VERIFY(a.inBuffer(), caseLabel);
+      verifyVector(a, {10, 11}, caseLabel);
+      VERIFY(b.onHeap(), caseLabel);
+      verifyVector(b, {1, 2, 3, 4, 5, 6, 7}, caseLabel);
+   }
+}
+
+void testMemStats()
+{
+   {
+      const std::string caseLabel{"SboVector memory stats for storage changes"};
+
+      using SV = SboVector<int, 4>;
+      SV::resetMemStats();
+
+      {
+         SV sv{1, 2, 3};
+         VERIFY(SV::memStats().numAllocations == 0, caseLabel);
+
+         sv.push_back(4);
+         sv.push_back(5);
+         const SboVectorMemStats spilled = SV::memStats();
+         VERIFY(spilled.numSpills == 1, caseLabel);
+         VERIFY(spilled.numAllocations == 1, caseLabel);
+         VERIFY(spilled.allocatedCapacity == static_cast<int64_t>(sv.capacity()),
+                caseLabel);
+
+         sv.reserve(100);
+         const SboVectorMemStats reallocated = SV::memStats();
+         VERIFY(reallocated.numReallocations == 1, caseLabel);
+         VERIFY(reallocated.numAllocations == 2, caseLabel);
+         VERIFY(reallocated.numDeallocations == 1, caseLabel);
+         VERIFY(reallocated.allocatedCapacity == 100, caseLabel);
+
+         sv.resize(2);
+         sv.shrink_to_fit();
+         const SboVectorMemStats returned = SV::memStats();
+         VERIFY(returned.numReturns == 1, caseLabel);
+         VERIFY(returned.numDeallocations == 2, caseLabel);
+         VERIFY(returned.allocatedCapacity == 0, caseLabel);
+      }
+
+      const SboVectorMemStats stats = SV::memStats();
+      VERIFY(stats.numAllocations == stats.numDeallocations, caseLabel);
+      VERIFY(stats.peakSizes[SboVectorMemStats::peakSizeBucket(5)] == 1, caseLabel);
+   }
+   {
+      const std::string caseLabel{"SboVector memory stats for peak size histogram"};
+
+      using SV = SboVector<int, 4>;
+      SV::resetMemStats();
+
+      {
+         SV empty;
+         SV single{1};
+         SV small{1, 2, 3};
+         SV large{1, 2, 3, 4, 5, 6, 7, 8, 9, 10};
+         large.clear();
+      }
+
+      const SboVectorMemStats stats = SV::memStats();
+      VERIFY(stats.peakSizes[0] == 1, caseLabel);
+      VERIFY(stats.peakSizes[1] == 1, caseLabel);
+      VERIFY(stats.peakSizes[2] == 1, caseLabel);
+      VERIFY(stats.peakSizes[3] == 0, caseLabel);
+      VERIFY(stats.peakSizes[4] == 1, caseLabel);
+      VERIFY(SboVectorMemStats::peakSizeBucket(10) == 4, caseLabel);
+   }
+   {
+      const std::string caseLabel{"SboVector memory stats for multiple threads"};
+
+      using SV = SboVector<int, 4>;
+      SV::resetMemStats();
+
+      constexpr int numThreads = 4;
+      constexpr int numVectorsPerThread = 1000;
+
+      std::vector<std::thread> threads;
+      for (int t = 0; t < numThreads; ++t)
+      {
+         threads.emplace_back(
+            []()
+            {
+               for (int i = 0; i < numVectorsPerThread; ++i)
+               {
+                  SV sv{1, 2, 3, 4};
+                  sv.push_back(5);
+               }
+            });
+      }
+      for (auto& thread : threads)
+         thread.join();
+
+      const SboVectorMemStats stats = SV::memStats();
+      constexpr int64_t numVectors = numThreads * numVectorsPerThread;
+      VERIFY(stats.numSpills == numVectors, caseLabel);
+      VERIFY(stats.numAllocations == numVectors, caseLabel);
+      VERIFY(stats.numDeallocations == numVectors, caseLabel);
+      VERIFY(stats.allocatedCapacity == 0, caseLabel);
+      VERIFY(stats.peakSizes[SboVectorMemStats::peakSizeBucket(5)] == numVectors,
+             caseLabel);
+   }
+}
+
+void testGrowthPolicy()
+{
+   {
+      const std::string caseLabel{"SboVector growth by doubling"};
+
+      using SV = SboVector<int, 4, AlignedAllocator<int>, DoublingGrowth>;
+
+      SV sv{1, 2, 3, 4};
+      sv.push_back(5);
+      VERIFY(sv.capacity() == 8, caseLabel);
+
+      for (int i = 0; i < 4; ++i)
+         sv.push_back(i);
+      VERIFY(sv.capacity() == 16, caseLabel);
+   }
+   {
+      const std::string caseLabel{"SboVector growth by half"};
+
+      using SV = SboVector<int, 4, AlignedAllocator<int>, OneAndHalfGrowth>;
+
+      SV sv{1, 2, 3, 4};
+      sv.push_back(5);
+      VERIFY(sv.capacity() == 6, caseLabel);
+
+      for (int i = 0; i < 2; ++i)
+         sv.push_back(i);
+      VERIFY(sv.capacity() == 9, caseLabel);
+   }
+   {
+      const std::string caseLabel{"SboVector growth by fixed step"};
+
+      using SV = SboVector<int, 4, AlignedAllocator<int>, FixedStepGrowth<10>>;
+
+      SV sv{1, 2, 3, 4};
+      sv.push_back(5);
+      VERIFY(sv.capacity() == 14, caseLabel);
+
+      for (int i = 0; i < 10; ++i)
+         sv.push_back(i);
+      VERIFY(sv.capacity() == 24, caseLabel);
+   }
+   {
+      const std::string caseLabel{"SboVector growth for insertion of many elements"};
+
+      using SV = SboVector<int, 4, AlignedAllocator<int>, OneAndHalfGrowth>;
+
+      SV sv{1, 2, 3, 4};
+      const std::vector<int> values(20, 1);
+      sv.insert(sv.begin(), values.begin(), values.end());
+
+      // Growing by half is not enough, so the required capacity is used.
+      VERIFY(sv.capacity() == 24, caseLabel);
+   }
+   {
+      const std::string caseLabel{"SboVector growth policy close to max size"};
+
+      constexpr std::size_t maxCap = 100;
+      VERIFY(DoublingGrowth::grow(60, 61, maxCap) == maxCap, caseLabel);
+      VERIFY(OneAndHalfGrowth::grow(70, 71, maxCap) == maxCap, caseLabel);
+      VERIFY(FixedStepGrowth<10>::grow(95, 96, maxCap) == maxCap, caseLabel);
+   }
+   {
+      const std::string caseLabel{"SboVector growth to allocator's size class"};
+
+      using Growth = SizeClassGrowth<FixedStepGrowth<1>>;
+      using SV = SboVector<char, 1, AlignedAllocator<char>, Growth>;
+
+      SV sv{'a'};
+      sv.push_back('b');
+
+      // The capacity includes all usable memory of the allocated block.
+      VERIFY(sv.capacity() >= 2, caseLabel);
+      sv.reserve(100);
+      VERIFY(sv.capacity() >= 100, caseLabel);
+      verifyVector(sv, {'a', 'b'}, caseLabel);
+   }
+   {
+      const std::string caseLabel{"SboVector size class growth with allocator that does "
+                                  "not support allocate_at_least"};
+
+      using Growth = SizeClassGrowth<FixedStepGrowth<1>>;
+      using SV = SboVector<int, 1, std::allocator<int>, Growth>;
+
+      SV sv{1};
+      sv.push_back(2);
+
+      VERIFY(sv.capacity() == 2, caseLabel);
+   }
+}
+
 ///////////////////
 
 void testIteratorCopyCtor()
@@ -10544,11 +11356,14 @@ void testConstIteratorGreaterOrEqualThan()
 
 } // namespace
 
+#endif // SBOVEC_MEM_INSTR
+
 
 ///////////////////
 
 void testSboVector()
 {
+#ifdef SBOVEC_MEM_INSTR
    testDefaultCtor();
    testCtorForElementCountAndValue();
    testIteratorCtor();
@@ -10597,6 +11412,8 @@ void testSboVector()
    testInsertValueMultipleTimes();
    testInsertRange();
    testInsertInitializerList();
+   testContiguousSourceCopy();
+   testAppendRange();
    testPushBackLValue();
    testPushBackRValue();
    testPopBack();
@@ -10604,6 +11421,8 @@ void testSboVector()
    testEmplaceBack();
    testResizeWithDefaultValue();
    testResizeWithValue();
+   testResizeDefaultInit();
+   testAppendWith();
    testSwap();
    testEquality();
    testInequality();
@@ -10612,6 +11431,10 @@ void testSboVector()
    testLessOrEqualThan();
    testGreaterOrEqualThan();
    testStandaloneSwap();
+   testTriviallyRelocatableElements();
+   testAllocator();
+   testMemStats();
+   testGrowthPolicy();
 
    testIteratorCopyCtor();
    testIteratorMoveCtor();
@@ -10665,4 +11488,7 @@ void testSboVector()
    testConstIteratorLessOrEqualThan();
    testConstIteratorGreaterThan();
    testConstIteratorGreaterOrEqualThan();
+#else  // !SBOVEC_MEM_INSTR
+   std::cout << "SboVector tests skipped - Use Debug config for SboVector tests.\n";
+#endif // SBOVEC_MEM_INSTR
 }
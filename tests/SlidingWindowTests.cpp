@@ -0,0 +1,213 @@
+#include "SlidingWindowTests.h"
+#include "SlidingWindow.h"
+#include "TestUtil.h"
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <numeric>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace ds;
+
+
+///////////////////
+
+namespace
+{
+
+bool isClose(double a, double b)
+{
+   return std::abs(a - b) <= 1e-9 * std::max({1., std::abs(a), std::abs(b)});
+}
+
+
+void testSlidingWindowStatsEmpty()
+{
+   {
+      const std::string caseLabel{"SlidingWindowStats empty window"};
+      SlidingWindowStats<int, 3> stats;
+      VERIFY(stats.empty(), caseLabel);
+      VERIFY(stats.capacity() == 3, caseLabel);
+      VERIFY(stats.sum() == 0, caseLabel);
+      VERIFY_THROW([&stats]() { stats.mean(); }, std::runtime_error, caseLabel);
+      VERIFY_THROW([&stats]() { stats.min(); }, std::runtime_error, caseLabel);
+      VERIFY_THROW([&stats]() { stats.max(); }, std::runtime_error, caseLabel);
+      VERIFY_THROW([&stats]() { stats.variance(); }, std::runtime_error, caseLabel);
+      VERIFY_THROW([&stats]() { stats.pop_front(); }, std::runtime_error, caseLabel);
+   }
+}
+
+
+void testSlidingWindowStatsPush()
+{
+   {
+      const std::string caseLabel{"SlidingWindowStats::push()"};
+      SlidingWindowStats<int, 3> stats;
+      stats.push(4);
+      stats.push(2);
+      VERIFY(stats.sum() == 6, caseLabel);
+      VERIFY(isClose(stats.mean(), 3.), caseLabel);
+      VERIFY(stats.min() == 2 && stats.max() == 4, caseLabel);
+      VERIFY(isClose(stats.variance(), 1.), caseLabel);
+      VERIFY(isClose(stats.sample_variance(), 2.), caseLabel);
+   }
+   {
+      const std::string caseLabel{"SlidingWindowStats::push() drops oldest"};
+      SlidingWindowStats<int, 3> stats;
+      for (int val : {9, 1, 5, 7, 3})
+         stats.push(val);
+      VERIFY(stats.size() == 3, caseLabel);
+      VERIFY(stats.sum() == 15, caseLabel);
+      VERIFY(stats.min() == 3 && stats.max() == 7, caseLabel);
+      VERIFY(stats.window()[0] == 5, caseLabel);
+   }
+   {
+      const std::string caseLabel{"SlidingWindowStats::pop_front()"};
+      SlidingWindowStats<int, 3> stats;
+      for (int val : {1, 9, 5})
+         stats.push(val);
+      VERIFY(stats.pop_front() == 1, caseLabel);
+      VERIFY(stats.min() == 5 && stats.max() == 9, caseLabel);
+      VERIFY(stats.pop_front() == 9, caseLabel);
+      VERIFY(stats.min() == 5 && stats.max() == 5, caseLabel);
+      VERIFY(isClose(stats.variance(), 0.), caseLabel);
+      stats.pop_front();
+      VERIFY(stats.empty() && stats.sum() == 0, caseLabel);
+   }
+   {
+      const std::string caseLabel{"SlidingWindowStats::pop_front() of all doubles"};
+      SlidingWindowStats<double, 3> stats;
+      for (double val : {.1, .2, .3})
+         stats.push(val);
+      for (int i = 0; i < 3; ++i)
+         stats.pop_front();
+      // Exact comparison, no rounding errors of the removed elements are left.
+      VERIFY(stats.empty() && stats.sum() == 0., caseLabel);
+      stats.push(4.);
+      VERIFY(stats.sum() == 4. && stats.mean() == 4., caseLabel);
+      VERIFY(stats.variance() == 0., caseLabel);
+   }
+   {
+      const std::string caseLabel{"SlidingWindowStats::clear()"};
+      SlidingWindowStats<double, 3> stats;
+      stats.push(1.);
+      stats.push(2.);
+      stats.clear();
+      VERIFY(stats.empty() && stats.sum() == 0., caseLabel);
+      stats.push(5.);
+      VERIFY(stats.min() == 5. && isClose(stats.mean(), 5.), caseLabel);
+   }
+}
+
+
+void testSlidingWindowStatsRandom()
+{
+   {
+      const std::string caseLabel{"SlidingWindowStats matches recomputation"};
+      constexpr std::size_t N = 50;
+      std::mt19937 gen{7};
+      std::uniform_real_distribution<double> dist{-1000., 1000.};
+      std::vector<double> vals(1000);
+      std::generate(vals.begin(), vals.end(), [&]() { return dist(gen); });
+
+      SlidingWindowStats<double, N> stats;
+      bool matches = true;
+      for (std::size_t i = 0; i < vals.size(); ++i)
+      {
+         stats.push(vals[i]);
+
+         const auto first = vals.begin() + (i + 1 > N ? i + 1 - N : 0);
+         const auto last = vals.begin() + i + 1;
+         const double n = static_cast<double>(last - first);
+         const double mean = std::accumulate(first, last, 0.) / n;
+         double m2 = 0.;
+         for (auto it = first; it != last; ++it)
+            m2 += (*it - mean) * (*it - mean);
+
+         matches = matches && isClose(stats.mean(), mean) &&
+                   std::abs(stats.variance() - m2 / n) <= 1e-6 * (m2 / n + 1.) &&
+                   stats.min() == *std::min_element(first, last) &&
+                   stats.max() == *std::max_element(first, last);
+      }
+      VERIFY(matches, caseLabel);
+   }
+}
+
+
+void testSlidingWindowAggregate()
+{
+   {
+      const std::string caseLabel{"SlidingWindowAggregate empty window"};
+      SlidingWindowAggregate<int, 3, MinOp<int>> agg;
+      VERIFY(agg.empty(), caseLabel);
+      VERIFY_THROW([&agg]() { agg.aggregate(); }, std::runtime_error, caseLabel);
+      VERIFY_THROW([&agg]() { agg.pop_front(); }, std::runtime_error, caseLabel);
+   }
+   {
+      const std::string caseLabel{"SlidingWindowAggregate with min operation"};
+      SlidingWindowAggregate<int, 3, MinOp<int>> agg;
+      std::vector<int> mins;
+      for (int val : {5, 3, 8, 9, 7, 1, 4})
+      {
+         agg.push(val);
+         mins.push_back(agg.aggregate());
+      }
+      VERIFY(mins == std::vector<int>({5, 3, 3, 3, 7, 1, 1}), caseLabel);
+   }
+   {
+      const std::string caseLabel{"SlidingWindowAggregate with sum operation"};
+      SlidingWindowAggregate<int, 4, std::plus<int>> agg;
+      for (int val = 1; val <= 10; ++val)
+         agg.push(val);
+      VERIFY(agg.aggregate() == 7 + 8 + 9 + 10, caseLabel);
+      VERIFY(agg.pop_front() == 7, caseLabel);
+      VERIFY(agg.aggregate() == 8 + 9 + 10, caseLabel);
+   }
+   {
+      const std::string caseLabel{"SlidingWindowAggregate keeps operand order"};
+      SlidingWindowAggregate<std::string, 3, std::plus<std::string>> agg;
+      std::vector<std::string> concatenated;
+      for (const char* s : {"a", "b", "c", "d", "e"})
+      {
+         agg.push(s);
+         concatenated.push_back(agg.aggregate());
+      }
+      VERIFY(concatenated ==
+                std::vector<std::string>({"a", "ab", "abc", "bcd", "cde"}),
+             caseLabel);
+      agg.pop_front();
+      VERIFY(agg.aggregate() == "de", caseLabel);
+      agg.push("f");
+      VERIFY(agg.aggregate() == "def", caseLabel);
+   }
+   {
+      const std::string caseLabel{"SlidingWindowAggregate with custom operation"};
+      // Greatest common divisor is associative.
+      auto gcd = [](int a, int b) { return std::gcd(a, b); };
+      SlidingWindowAggregate<int, 2, decltype(gcd)> agg{gcd};
+      agg.push(12);
+      agg.push(18);
+      VERIFY(agg.aggregate() == 6, caseLabel);
+      agg.push(27);
+      VERIFY(agg.aggregate() == 9, caseLabel);
+      agg.clear();
+      agg.push(4);
+      VERIFY(agg.aggregate() == 4, caseLabel);
+   }
+}
+
+} // namespace
+
+
+///////////////////
+
+void testSlidingWindow()
+{
+   testSlidingWindowStatsEmpty();
+   testSlidingWindowStatsPush();
+   testSlidingWindowStatsRandom();
+   testSlidingWindowAggregate();
+}
@@ -0,0 +1,309 @@
+#include "SpscRingBufferTests.h"
+#include "SpscRingBuffer.h"
+#include "TestUtil.h"
+#include <algorithm>
+#include <chrono>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace ds;
+
+
+///////////////////
+
+namespace
+{
+
+void testSpscRingBufferDefaultCtor()
+{
+   {
+      const std::string caseLabel{"SpscRingBuffer default ctor"};
+      SpscRingBuffer<int, 10> rb;
+      VERIFY(rb.empty(), caseLabel);
+      VERIFY(!rb.full(), caseLabel);
+      VERIFY(rb.size() == 0, caseLabel);
+      VERIFY(rb.capacity() == 10, caseLabel);
+   }
+}
+
+
+void testSpscRingBufferTryPush()
+{
+   {
+      const std::string caseLabel{"SpscRingBuffer try_push into empty buffer"};
+      SpscRingBuffer<int, 3> rb;
+      VERIFY(rb.try_push(1), caseLabel);
+      VERIFY(rb.size() == 1, caseLabel);
+      VERIFY(!rb.empty(), caseLabel);
+   }
+   {
+      const std::string caseLabel{"SpscRingBuffer try_push into full buffer"};
+      SpscRingBuffer<int, 3> rb;
+      VERIFY(rb.try_push(1), caseLabel);
+      VERIFY(rb.try_push(2), caseLabel);
+      VERIFY(rb.try_push(3), caseLabel);
+      VERIFY(rb.full(), caseLabel);
+      VERIFY(!rb.try_push(4), caseLabel);
+      VERIFY(rb.size() == 3, caseLabel);
+
+      // The oldest element is not overwritten.
+      int val = 0;
+      VERIFY(rb.try_pop(val), caseLabel);
+      VERIFY(val == 1, caseLabel);
+   }
+   {
+      const std::string caseLabel{"SpscRingBuffer try_push for zero capacity"};
+      SpscRingBuffer<int, 0> rb;
+      VERIFY(!rb.try_push(1), caseLabel);
+      VERIFY(rb.empty(), caseLabel);
+   }
+   {
+      const std::string caseLabel{"SpscRingBuffer try_push for move-only type"};
+      SpscRingBuffer<std::unique_ptr<int>, 2> rb;
+      auto p = std::make_unique<int>(5);
+      VERIFY(rb.try_push(std::move(p)), caseLabel);
+      VERIFY(!p, caseLabel);
+
+      std::unique_ptr<int> popped;
+      VERIFY(rb.try_pop(popped), caseLabel);
+      VERIFY(popped && *popped == 5, caseLabel);
+   }
+}
+
+
+void testSpscRingBufferTryPop()
+{
+   {
+      const std::string caseLabel{"SpscRingBuffer try_pop from empty buffer"};
+      SpscRingBuffer<int, 3> rb;
+      int val = 7;
+      VERIFY(!rb.try_pop(val), caseLabel);
+      VERIFY(val == 7, caseLabel);
+   }
+   {
+      const std::string caseLabel{"SpscRingBuffer try_pop in insertion order"};
+      SpscRingBuffer<std::string, 3> rb;
+      rb.try_push("a");
+      rb.try_push("b");
+
+      std::string val;
+      VERIFY(rb.try_pop(val), caseLabel);
+      VERIFY(val == "a", caseLabel);
+      VERIFY(rb.try_pop(val), caseLabel);
+      VERIFY(val == "b", caseLabel);
+      VERIFY(!rb.try_pop(val), caseLabel);
+      VERIFY(rb.empty(), caseLabel);
+   }
+   {
+      const std::string caseLabel{"SpscRingBuffer try_pop when wrapping around"};
+      SpscRingBuffer<int, 3> rb;
+      bool ok = true;
+      for (int i = 0; i < 20; ++i)
+      {
+         ok = ok && rb.try_push(i);
+         ok = ok && rb.try_push(i + 100);
+         int first = -1;
+         int second = -1;
+         ok = ok && rb.try_pop(first) && rb.try_pop(second);
+         ok = ok && first == i && second == i + 100;
+      }
+      VERIFY(ok, caseLabel);
+      VERIFY(rb.empty(), caseLabel);
+   }
+}
+
+
+void testSpscRingBufferTryPushN()
+{
+   {
+      const std::string caseLabel{"SpscRingBuffer try_push_n for fitting elements"};
+      SpscRingBuffer<int, 5> rb;
+      const std::vector<int> vals{1, 2, 3};
+      VERIFY(rb.try_push_n(vals.begin(), vals.size()) == 3, caseLabel);
+      VERIFY(rb.size() == 3, caseLabel);
+   }
+   {
+      const std::string caseLabel{"SpscRingBuffer try_push_n for too many elements"};
+      SpscRingBuffer<int, 5> rb;
+      rb.try_push(0);
+      const std::vector<int> vals{1, 2, 3, 4, 5, 6};
+      VERIFY(rb.try_push_n(vals.begin(), vals.size()) == 4, caseLabel);
+      VERIFY(rb.full(), caseLabel);
+
+      std::vector<int> popped;
+      rb.try_pop_n(std::back_inserter(popped), 10);
+      VERIFY(popped == std::vector<int>({0, 1, 2, 3, 4}), caseLabel);
+   }
+   {
+      const std::string caseLabel{"SpscRingBuffer try_push_n when wrapping around"};
+      SpscRingBuffer<int, 5> rb;
+      const std::vector<int> vals{1, 2, 3, 4};
+      rb.try_push_n(vals.begin(), vals.size());
+      int val = 0;
+      rb.try_pop(val);
+      rb.try_pop(val);
+      rb.try_pop(val);
+
+      const std::vector<int> more{5, 6, 7, 8};
+      VERIFY(rb.try_push_n(more.begin(), more.size()) == 4, caseLabel);
+
+      std::vector<int> popped;
+      VERIFY(rb.try_pop_n(std::back_inserter(popped), 10) == 5, caseLabel);
+      VERIFY(popped == std::vector<int>({4, 5, 6, 7, 8}), caseLabel);
+   }
+   {
+      const std::string caseLabel{"SpscRingBuffer try_push_n for no elements"};
+      SpscRingBuffer<int, 5> rb;
+      const std::vector<int> vals;
+      VERIFY(rb.try_push_n(vals.begin(), 0) == 0, caseLabel);
+      VERIFY(rb.empty(), caseLabel);
+   }
+}
+
+
+void testSpscRingBufferTryPopN()
+{
+   {
+      const std::string caseLabel{"SpscRingBuffer try_pop_n for fewer than available"};
+      SpscRingBuffer<int, 5> rb;
+      const std::vector<int> vals{1, 2, 3, 4};
+      rb.try_push_n(vals.begin(), vals.size());
+
+      int popped[2] = {};
+      VERIFY(rb.try_pop_n(popped, 2) == 2, caseLabel);
+      VERIFY(popped[0] == 1 && popped[1] == 2, caseLabel);
+      VERIFY(rb.size() == 2, caseLabel);
+   }
+   {
+      const std::string caseLabel{"SpscRingBuffer try_pop_n from empty buffer"};
+      SpscRingBuffer<int, 5> rb;
+      std::vector<int> popped;
+      VERIFY(rb.try_pop_n(std::back_inserter(popped), 3) == 0, caseLabel);
+      VERIFY(popped.empty(), caseLabel);
+   }
+}
+
+
+void testSpscRingBufferBlockingPushPop()
+{
+   {
+      const std::string caseLabel{"SpscRingBuffer push and pop without waiting"};
+      SpscRingBuffer<int, 3> rb;
+      rb.push(1);
+      rb.push(2);
+      VERIFY(rb.pop() == 1, caseLabel);
+      VERIFY(rb.pop() == 2, caseLabel);
+      VERIFY(rb.empty(), caseLabel);
+   }
+   {
+      const std::string caseLabel{"SpscRingBuffer push waits for space"};
+      SpscRingBuffer<int, 1> rb;
+      rb.push(1);
+
+      std::thread producer([&rb]() { rb.push(2); });
+
+      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+      VERIFY(rb.pop() == 1, caseLabel);
+      VERIFY(rb.pop() == 2, caseLabel);
+      producer.join();
+      VERIFY(rb.num_dropped() == 0, caseLabel);
+   }
+}
+
+
+void testSpscRingBufferNumDropped()
+{
+   {
+      const std::string caseLabel{"SpscRingBuffer counts rejected elements"};
+      SpscRingBuffer<int, 3> rb;
+      const std::vector<int> vals{1, 2, 3, 4, 5};
+      VERIFY(rb.try_push_n(vals.begin(), vals.size()) == 3, caseLabel);
+      VERIFY(rb.num_dropped() == 2, caseLabel);
+      VERIFY(!rb.try_push(6), caseLabel);
+      VERIFY(rb.num_dropped() == 3, caseLabel);
+   }
+}
+
+
+void testSpscRingBufferConcurrentTransfer()
+{
+   {
+      const std::string caseLabel{"SpscRingBuffer single elements between threads"};
+      static constexpr int NumValues = 100000;
+      SpscRingBuffer<int, 64> rb;
+
+      std::thread producer(
+         [&rb]()
+         {
+            for (int i = 0; i < NumValues; ++i)
+               while (!rb.try_push(i))
+                  std::this_thread::yield();
+         });
+
+      bool inOrder = true;
+      for (int expected = 0; expected < NumValues;)
+      {
+         int val = -1;
+         if (rb.try_pop(val))
+            inOrder = inOrder && (val == expected++);
+         else
+            std::this_thread::yield();
+      }
+      producer.join();
+
+      VERIFY(inOrder, caseLabel);
+      VERIFY(rb.empty(), caseLabel);
+   }
+   {
+      const std::string caseLabel{"SpscRingBuffer batches between threads"};
+      static constexpr int NumValues = 100000;
+      static constexpr std::size_t BatchSize = 7;
+      SpscRingBuffer<int, 50> rb;
+
+      std::thread producer(
+         [&rb]()
+         {
+            std::vector<int> batch(BatchSize);
+            int next = 0;
+            while (next < NumValues)
+            {
+               const std::size_t count =
+                  std::min<std::size_t>(BatchSize, NumValues - next);
+               for (std::size_t i = 0; i < count; ++i)
+                  batch[i] = next + static_cast<int>(i);
+               next += static_cast<int>(rb.try_push_n(batch.begin(), count));
+            }
+         });
+
+      std::vector<int> received;
+      received.reserve(NumValues);
+      while (received.size() < NumValues)
+         rb.try_pop_n(std::back_inserter(received), BatchSize * 2);
+      producer.join();
+
+      bool inOrder = true;
+      for (int i = 0; i < NumValues; ++i)
+         inOrder = inOrder && received[i] == i;
+      VERIFY(inOrder, caseLabel);
+   }
+}
+
+} // namespace
+
+
+///////////////////
+
+void testSpscRingBuffer()
+{
+   testSpscRingBufferDefaultCtor();
+   testSpscRingBufferTryPush();
+   testSpscRingBufferTryPop();
+   testSpscRingBufferTryPushN();
+   testSpscRingBufferTryPopN();
+   testSpscRingBufferBlockingPushPop();
+   testSpscRingBufferNumDropped();
+   testSpscRingBufferConcurrentTransfer();
+}